@@ -87,11 +87,7 @@ class CoreAffinity {
         //    if (config_->global_enable_core_binding) {
         //        core_affinity_->BindToCore(tid);
 
-        size_t core;
-        if (config_->global_enable_expert_division)
-            core = (size_t)thread_to_core_map[tid];
-        else
-            core = tid % cpuinfo_->GetTotalThreadCount();
+        size_t core = get_core_of_thread(tid);
 
         cpu_set_t mask;
         CPU_ZERO(&mask);
@@ -101,6 +97,13 @@ class CoreAffinity {
         }
     }
 
+    // NUMA node of the core that thread tid is bound to, -1 if threads are not bound to cores
+    int GetNodeOfThread(int tid) {
+        if (!config_->global_enable_core_binding)
+            return -1;
+        return cpuinfo_->GetSocketMappingVector(get_core_of_thread(tid));
+    }
+
     void GetStealList(int tid, vector<int> & list) {
         int core_id = thread_to_core_map[tid];
         for (auto itr = stealing_table[core_id].begin(); itr != stealing_table[core_id].end(); itr++) {
@@ -177,6 +180,13 @@ class CoreAffinity {
     map<int, int> core_to_thread_map;
     map<int, int> thread_to_core_map;
 
+    size_t get_core_of_thread(int tid) {
+        if (config_->global_enable_expert_division)
+            return (size_t)thread_to_core_map[tid];
+        else
+            return tid % cpuinfo_->GetTotalThreadCount();
+    }
+
     void init_potential_core_pool() {
         // first, try to divide via core
         int cur_step = 0;
@@ -0,0 +1,135 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+#include "glog/logging.h"
+
+/* Multi-producer single-consumer queue for small movable elements (e.g. pointers).
+ *
+ * Push() is lock-free while the bounded ring has space. Each ring cell carries a sequence number,
+ * so that producers only contend on a fetch of the tail position, and the consumer never writes
+ * a shared counter that producers read.
+ * When the ring is full, elements overflow into a locked queue instead of blocking the producer,
+ * since two expert threads sending to each other must not wait on each other.
+ * Elements of the same producer are popped in the order they are pushed: once overflowed,
+ * producers keep pushing to the overflow queue, which is popped only after the ring is drained.
+ *
+ * TryPop() should not be called concurrently, the caller serializes consumers.
+ */
+template <typename T>
+class MPSCQueue {
+ public:
+    // capacity should be a power of 2
+    explicit MPSCQueue(size_t capacity) : mask_(capacity - 1), cells_(new Cell[capacity]),
+                                          enqueue_pos_(0), dequeue_pos_(0), overflow_count_(0) {
+        CHECK(capacity >= 2 && (capacity & mask_) == 0);
+        for (size_t i = 0; i < capacity; i++)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    ~MPSCQueue() { delete[] cells_; }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    void Push(T elem) {
+        // Once overflowed, keep pushing to overflow_ until it is drained, to keep the order
+        if (overflow_count_.load(std::memory_order_acquire) == 0 && TryPushRing(elem))
+            return;
+
+        std::lock_guard<std::mutex> lk(overflow_mutex_);
+        overflow_.push(std::move(elem));
+        overflow_count_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Like TryPop(), should not be called concurrently with consumers
+    bool Empty() const {
+        const Cell* cell = &cells_[dequeue_pos_ & mask_];
+        return cell->seq.load(std::memory_order_acquire) != dequeue_pos_ + 1
+               && overflow_count_.load(std::memory_order_acquire) == 0;
+    }
+
+    bool TryPop(T & elem) {
+        Cell* cell = &cells_[dequeue_pos_ & mask_];
+        if (cell->seq.load(std::memory_order_acquire) == dequeue_pos_ + 1) {
+            elem = std::move(cell->data);
+            // The cell can be reused by producers of the next round
+            cell->seq.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+            dequeue_pos_++;
+            return true;
+        }
+
+        if (overflow_count_.load(std::memory_order_acquire) == 0)
+            return false;
+
+        // Reserved ring cells may hold elements pushed before the overflowed ones by the same producer,
+        // thus take from overflow_ only after the ring is drained
+        if (enqueue_pos_.load(std::memory_order_acquire) != dequeue_pos_)
+            return false;
+
+        std::lock_guard<std::mutex> lk(overflow_mutex_);
+        elem = std::move(overflow_.front());
+        overflow_.pop();
+        overflow_count_.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+ private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    bool TryPushRing(T & elem) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                // full
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(elem);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    const size_t mask_;
+    Cell* const cells_;
+
+    alignas(64) std::atomic<size_t> enqueue_pos_;
+    // Only accessed by the consumer
+    alignas(64) size_t dequeue_pos_;
+
+    alignas(64) std::atomic<int> overflow_count_;
+    std::mutex overflow_mutex_;
+    std::queue<T> overflow_;
+};
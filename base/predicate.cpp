@@ -12,9 +12,44 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <string_view>
+
 #include "base/predicate.hpp"
 
+// A code of string_dict is compared as its string, without decoding it into a new value_t:
+// its string is viewed in place in string_dict.
+// Two codes are equal iff their contents are equal, and ordered by their contents if string_dict is order-preserving.
+static string_view content_view(const value_t& v) {
+    if (v.type == DictCodeValueType) {
+        const string& str = string_dict::GetInstance()->GetString(v);
+        return string_view(str.data(), str.size());
+    }
+    return string_view(v.content.data(), v.content.size());
+}
+
+// The same order as value_content_t, i.e., lexicographical order of chars
+static bool content_less(const string_view& l, const string_view& r) {
+    return lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+}
+
+// Called if v1 or v2 is a code, the same as comparing the decoded string(s) with operator <
+static bool dict_code_less(const value_t& v1, const value_t& v2) {
+    if (v1.type == v2.type && string_dict::GetInstance()->order_preserving)
+        return string_dict::GetIndex(v1) < string_dict::GetIndex(v2);
+    return content_less(content_view(v1), content_view(v2));
+}
+
+// Called if exactly one of v1 and v2 is a code, the same as comparing the decoded string with operator ==
+static bool dict_code_equal(const value_t& v1, const value_t& v2) {
+    if (v1.type != StringValueType && v2.type != StringValueType)
+        return false;
+    return content_view(v1) == content_view(v2);
+}
+
 bool operator ==(const value_t& v1, const value_t& v2) {
+    if ((v1.type == DictCodeValueType) != (v2.type == DictCodeValueType))
+        return dict_code_equal(v1, v2);
     if (v1.type != v2.type) {
         if ((v1.type == 1 && v2.type == 2) || (v1.type == 2 && v2.type == 1)) {
             return v1.DebugString() == v2.DebugString();
@@ -25,6 +60,8 @@ bool operator ==(const value_t& v1, const value_t& v2) {
 }
 
 bool operator !=(const value_t& v1, const value_t& v2) {
+    if ((v1.type == DictCodeValueType) != (v2.type == DictCodeValueType))
+        return !dict_code_equal(v1, v2);
     if (v1.type != v2.type) {
         if ((v1.type == 1 && v2.type == 2) || (v1.type == 2 && v2.type == 1)) {
             return v1.DebugString() != v2.DebugString();
@@ -35,6 +72,8 @@ bool operator !=(const value_t& v1, const value_t& v2) {
 }
 
 bool operator <(const value_t& v1, const value_t& v2) {
+    if (v1.type == DictCodeValueType || v2.type == DictCodeValueType)
+        return dict_code_less(v1, v2);
     if (v1.type != v2.type) {
         if (v1.type == 1 && v2.type == 2) {
             return Tool::value_t2int(v1) < Tool::value_t2double(v2);
@@ -52,6 +91,8 @@ bool operator <(const value_t& v1, const value_t& v2) {
 }
 
 bool operator >(const value_t& v1, const value_t& v2) {
+    if (v1.type == DictCodeValueType || v2.type == DictCodeValueType)
+        return dict_code_less(v2, v1);
     if (v1.type != v2.type) {
         if (v1.type == 1 && v2.type == 2) {
             return Tool::value_t2int(v1) > Tool::value_t2double(v2);
@@ -69,6 +110,8 @@ bool operator >(const value_t& v1, const value_t& v2) {
 }
 
 bool operator <=(const value_t& v1, const value_t& v2) {
+    if (v1.type == DictCodeValueType || v2.type == DictCodeValueType)
+        return !dict_code_less(v2, v1);
     if (v1.type != v2.type) {
         if (v1.type == 1 && v2.type == 2) {
             return Tool::value_t2int(v1) <= Tool::value_t2double(v2);
@@ -86,6 +129,8 @@ bool operator <=(const value_t& v1, const value_t& v2) {
 }
 
 bool operator >=(const value_t& v1, const value_t& v2) {
+    if (v1.type == DictCodeValueType || v2.type == DictCodeValueType)
+        return !dict_code_less(v1, v2);
     if (v1.type != v2.type) {
         if (v1.type == 1 && v2.type == 2) {
             return Tool::value_t2int(v1) >= Tool::value_t2double(v2);
@@ -13,26 +13,66 @@
 // limitations under the License.
 
 #include "base/serialization.hpp"
+#include <string.h>
+#include <algorithm>
 #include <iostream>
 
+ibinstream::ibinstream(char* buf, size_t capacity) :
+        ext_buf_(buf), ext_capacity_(capacity), ext_size_(0), mode_(buf == nullptr ? COUNTING : EXTERNAL) {}
+
 char* ibinstream::get_buf() {
-    return &buf_[0];
+    switch (mode_) {
+      case EXTERNAL:
+        return ext_buf_;
+      case COUNTING:
+        return nullptr;
+      default:
+        return &buf_[0];
+    }
 }
 
 void ibinstream::raw_byte(char c) {
-    buf_.push_back(c);
+    if (mode_ == OWNED)
+        buf_.push_back(c);
+    else
+        raw_bytes(&c, 1);
 }
 
 void ibinstream::raw_bytes(const void* ptr, int size) {
+    if (mode_ == COUNTING) {
+        ext_size_ += size;
+        return;
+    }
+
+    if (mode_ == EXTERNAL) {
+        if (ext_size_ + size <= ext_capacity_) {
+            memcpy(ext_buf_ + ext_size_, ptr, size);
+            ext_size_ += size;
+            return;
+        }
+        spill();
+    }
+
     buf_.insert(buf_.end(), (const char*)ptr, (const char*)ptr + size);
 }
 
 size_t ibinstream::size() {
-    return buf_.size();
+    return (mode_ == OWNED) ? buf_.size() : ext_size_;
 }
 
 void ibinstream::clear() {
     buf_.clear();
+    ext_size_ = 0;
+}
+
+bool ibinstream::in_place() {
+    return mode_ == EXTERNAL;
+}
+
+void ibinstream::spill() {
+    buf_.reserve(max(ext_capacity_ * 2, ext_size_ + 1));
+    buf_.assign(ext_buf_, ext_buf_ + ext_size_);
+    mode_ = OWNED;
 }
 
 ibinstream& operator<<(ibinstream& m, size_t i) {
@@ -103,6 +143,12 @@ ibinstream& operator<<(ibinstream& m, const vector<char>& v) {
     return m;
 }
 
+ibinstream& operator<<(ibinstream& m, const vector<uint32_t>& v) {
+    m << v.size();
+    m.raw_bytes(&v[0], v.size() * sizeof(uint32_t));
+    return m;
+}
+
 ibinstream& operator<<(ibinstream& m, const vector<uint64_t>& v) {
     m << v.size();
     m.raw_bytes(&v[0], v.size() * sizeof(uint64_t));
@@ -226,6 +272,15 @@ obinstream& operator>>(obinstream& m, vector<char>& v) {
     return m;
 }
 
+obinstream& operator>>(obinstream& m, vector<uint32_t>& v) {
+    size_t size;
+    m >> size;
+    v.resize(size);
+    uint32_t* data = (uint32_t*)m.raw_bytes(sizeof(uint32_t) * size);
+    v.assign(data, data + size);
+    return m;
+}
+
 obinstream& operator>>(obinstream& m, vector<uint64_t>& v){
     size_t size;
     m >> size;
@@ -242,3 +297,30 @@ obinstream& operator>>(obinstream& m, string& str) {
     str.append(data, length);
     return m;
 }
+
+void write_varint(ibinstream& m, uint64_t v) {
+    while (v >= 0x80) {
+        m.raw_byte(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    m.raw_byte(static_cast<char>(v));
+}
+
+void write_svarint(ibinstream& m, int64_t v) {
+    write_varint(m, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+uint64_t read_varint(obinstream& m) {
+    uint64_t v = 0;
+    for (int shift = 0; ; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(m.raw_byte());
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return v;
+    }
+}
+
+int64_t read_svarint(obinstream& m) {
+    uint64_t v = read_varint(m);
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
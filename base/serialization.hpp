@@ -35,16 +35,40 @@ using namespace std;
 
 class ibinstream {
  public:
+    ibinstream() : ext_buf_(nullptr), ext_capacity_(0), ext_size_(0), mode_(OWNED) {}
+    // Serialize into buf in place, e.g. a message or send buffer of the exact size.
+    // If capacity is exceeded, the written bytes are moved into an owned buffer and the stream continues there.
+    // If buf is nullptr, nothing is written and only the size is counted.
+    ibinstream(char* buf, size_t capacity);
+
     char* get_buf();
     void raw_byte(char c);
     void raw_bytes(const void* ptr, int size);
     size_t size();
     void clear();
+    // True if all bytes are in the buffer passed to the constructor
+    bool in_place();
 
  private:
+    enum Mode { OWNED, EXTERNAL, COUNTING };
+
+    void spill();
+
     vector<char> buf_;
+    char* ext_buf_;
+    size_t ext_capacity_;
+    size_t ext_size_;
+    Mode mode_;
 };
 
+// Exact size of m << obj, by a pass that writes nothing
+template <class T>
+size_t serialized_size(const T& obj) {
+    ibinstream m(nullptr, 0);
+    m << obj;
+    return m.size();
+}
+
 ibinstream& operator<<(ibinstream& m, size_t i);
 ibinstream& operator<<(ibinstream& m, bool i);
 ibinstream& operator<<(ibinstream& m, int i);
@@ -61,6 +85,7 @@ ibinstream& operator<<(ibinstream& m, const vector<T>& v);
 ibinstream& operator<<(ibinstream& m, const vector<int>& v);
 ibinstream& operator<<(ibinstream& m, const vector<double>& v);
 ibinstream& operator<<(ibinstream& m, const vector<char>& v);
+ibinstream& operator<<(ibinstream& m, const vector<uint32_t>& v);
 ibinstream& operator<<(ibinstream& m, const vector<uint64_t>& v);
 template <class T>
 ibinstream& operator<<(ibinstream& m, const list<T>& v);
@@ -113,6 +138,7 @@ obinstream& operator>>(obinstream& m, vector<T>& v);
 obinstream& operator>>(obinstream& m, vector<int>& v);
 obinstream& operator>>(obinstream& m, vector<double>& v);
 obinstream& operator>>(obinstream& m, vector<char>& v);
+obinstream& operator>>(obinstream& m, vector<uint32_t>& v);
 obinstream& operator>>(obinstream& m, vector<uint64_t>& v);
 template <class T>
 obinstream& operator>>(obinstream& m, list<T>& v);
@@ -130,6 +156,13 @@ obinstream& operator>>(obinstream& m, hash_set<T>& v);
 template <class T, class _HashFcn,  class _EqualKey >
 obinstream& operator>>(obinstream& m, hash_set<T, _HashFcn, _EqualKey>& v);
 
+// Variable-length integers for small values on the wire, 7 bits per byte.
+// Signed values are zigzag encoded, so that small negative values stay short.
+void write_varint(ibinstream& m, uint64_t v);
+void write_svarint(ibinstream& m, int64_t v);
+uint64_t read_varint(obinstream& m);
+int64_t read_svarint(obinstream& m);
+
 #include "serialization.tpp"
 
 #endif  // BASE_SERIALIZATION_HPP_
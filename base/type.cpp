@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 #include "base/type.hpp"
+#include "glog/logging.h"
 #include "utils/tool.hpp"
 
 const unordered_map<PROCESS_STAT, string, EnumClassHash<PROCESS_STAT>> abort_reason_map = {
@@ -229,15 +230,114 @@ bool operator ==(const epid_t &p1, const epid_t &p2) {
         return false;
 }
 
+// value_t layout: type(1B) | len(1B, or 0xFF + 4B for long content) | content
+// Ids and numerics cost 2 bytes of header instead of a size_t length prefix.
 ibinstream& operator<<(ibinstream& m, const value_t& v) {
-    m << v.content;
     m << v.type;
+    uint32_t len = v.content.size();
+    if (len < VALUE_T_LONG_LEN) {
+        m << static_cast<uint8_t>(len);
+    } else {
+        m << VALUE_T_LONG_LEN;
+        m << len;
+    }
+    m.raw_bytes(v.content.data(), len);
     return m;
 }
 
 obinstream& operator>>(obinstream& m, value_t& v) {
-    m >> v.content;
     m >> v.type;
+    uint8_t short_len;
+    uint32_t len;
+    m >> short_len;
+    if (short_len < VALUE_T_LONG_LEN) {
+        len = short_len;
+    } else {
+        m >> len;
+    }
+    v.content.clear();
+    v.content.append(m.raw_bytes(len), len);
+    return m;
+}
+
+void value_column_t::MoveFront(size_t n, value_column_t& head) {
+    head.type = type;
+    head.clear();
+    if (IsNarrow()) {
+        head.u32.assign(u32.begin(), u32.begin() + n);
+        u32.erase(u32.begin(), u32.begin() + n);
+    } else {
+        head.u64.assign(u64.begin(), u64.begin() + n);
+        u64.erase(u64.begin(), u64.begin() + n);
+    }
+}
+
+void value_column_t::PushBack(const value_t& v) {
+    if (IsNarrow()) {
+        uint32_t c;
+        memcpy(&c, v.content.data(), sizeof(uint32_t));
+        u32.push_back(c);
+    } else {
+        uint64_t c;
+        memcpy(&c, v.content.data(), sizeof(uint64_t));
+        u64.push_back(c);
+    }
+}
+
+void value_column_t::Get(size_t i, value_t& v) const {
+    v.content.clear();
+    if (IsNarrow())
+        v.content.append(&u32[i], sizeof(uint32_t));
+    else
+        v.content.append(&u64[i], sizeof(uint64_t));
+    v.type = type;
+}
+
+void value_column_t::ToValues(vector<value_t>& vec) const {
+    size_t n = size();
+    vec.resize(n);
+    for (size_t i = 0; i < n; i++)
+        Get(i, vec[i]);
+}
+
+bool value_column_t::FromValues(const vector<value_t>& vec, value_column_t& col) {
+    if (vec.size() == 0) {
+        col = value_column_t();
+        return true;
+    }
+
+    uint8_t type = vec[0].type;
+    if (!IsColumnType(type))
+        return false;
+    size_t width = (type == IntValueType) ? sizeof(uint32_t) : sizeof(uint64_t);
+    for (auto& v : vec) {
+        if (v.type != type || v.content.size() != width)
+            return false;
+    }
+
+    col = value_column_t(type);
+    col.reserve(vec.size());
+    for (auto& v : vec)
+        col.PushBack(v);
+    return true;
+}
+
+ibinstream& operator<<(ibinstream& m, const value_column_t& col) {
+    m << col.type;
+    if (col.IsNarrow())
+        m << col.u32;
+    else
+        m << col.u64;
+    return m;
+}
+
+obinstream& operator>>(obinstream& m, value_column_t& col) {
+    m >> col.type;
+    col.clear();
+    if (col.IsNarrow())
+        m >> col.u32;
+    else
+        m >> col.u64;
     return m;
 }
 
@@ -318,6 +418,55 @@ void uint2qid_t(uint64_t v, qid_t & qid) {
     qid.trxid = v & _56HFLAG;
 }
 
+void string_dict::Add(const string& str) {
+    if (str2code.find(str) != str2code.end())
+        return;
+    str2code[str] = code2str.size();
+    code2str.push_back(str);
+}
+
+void string_dict::Sort() {
+    // The same order as value_content_t, i.e., lexicographical order of chars
+    sort(code2str.begin(), code2str.end(), [](const string& l, const string& r) {
+        return lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+    });
+    for (uint32_t i = 0; i < code2str.size(); i++)
+        str2code[code2str[i]] = i;
+    order_preserving = true;
+}
+
+bool string_dict::Encode(const value_t& value, value_t& code) const {
+    if (value.type != StringValueType)
+        return false;
+
+    auto itr = str2code.find(string(value.content.begin(), value.content.end()));
+    if (itr == str2code.end())
+        return false;
+
+    code.content.clear();
+    code.content.append(&itr->second, sizeof(uint32_t));
+    code.type = DictCodeValueType;
+    return true;
+}
+
+void string_dict::Decode(value_t& value) const {
+    const string& str = GetString(value);
+    value.content.clear();
+    value.content.append(str.data(), str.size());
+    value.type = StringValueType;
+}
+
+const string& string_dict::GetString(const value_t& code) const {
+    uint32_t index = GetIndex(code);
+    CHECK_LT(index, code2str.size()) << "Unknown code in string_dict";
+    return code2str[index];
+}
+
+size_t ValueTHash::HashDictCode(const value_t& val) {
+    const string& str = string_dict::GetInstance()->GetString(val);
+    return Hash(StringValueType, str.data(), str.size());
+}
+
 string value_t::DebugString() const {
     double d;
     int i;
@@ -326,6 +475,8 @@ string value_t::DebugString() const {
     vector<value_t> vec;
     string temp;
     switch (type) {
+      case 7:
+        return string_dict::GetInstance()->GetString(*this);
       case 6:  // v/epid(uint64_t) + {pkey : pvalue} (string)
         u = Tool::value_t2uint64_t(*this);
         return string(content.begin() + uint64_sz, content.end()); 
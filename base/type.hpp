@@ -16,7 +16,11 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
 #include <tbb/concurrent_hash_map.h>
+#include <algorithm>
+#include <iterator>
 #include <ext/hash_map>
 #include <ext/hash_set>
 #include <sstream>
@@ -419,15 +423,191 @@ bool operator == (const epid_t &p1, const epid_t &p2);
 
 typedef uint16_t label_t;
 
+// Byte container of value_t with a small inline buffer.
+// int, double, char, uint64_t and short strings are kept inline,
+// so that creating a value_t for an id or a number never touches the heap.
+// Longer payloads (long strings, lists) spill over to a heap buffer.
+// The interface follows the subset of vector<char> used by value_t.
+class value_content_t {
+ public:
+    typedef char value_type;
+    typedef char* iterator;
+    typedef const char* const_iterator;
+
+    static constexpr uint32_t INLINE_SIZE = 16;
+
+    value_content_t() : size_(0), capacity_(INLINE_SIZE) {}
+
+    value_content_t(const value_content_t& other) : size_(0), capacity_(INLINE_SIZE) {
+        append(other.data(), other.size_);
+    }
+
+    value_content_t(value_content_t&& other) noexcept : size_(other.size_), capacity_(other.capacity_) {
+        if (other.IsInline()) {
+            memcpy(buf_.inline_buf, other.buf_.inline_buf, size_);
+        } else {
+            buf_.heap_buf = other.buf_.heap_buf;
+            other.capacity_ = INLINE_SIZE;
+        }
+        other.size_ = 0;
+    }
+
+    ~value_content_t() {
+        if (!IsInline())
+            free(buf_.heap_buf);
+    }
+
+    value_content_t& operator=(const value_content_t& other) {
+        if (this != &other) {
+            size_ = 0;
+            append(other.data(), other.size_);
+        }
+        return *this;
+    }
+
+    value_content_t& operator=(value_content_t&& other) noexcept {
+        if (this != &other) {
+            if (!IsInline())
+                free(buf_.heap_buf);
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            if (other.IsInline()) {
+                memcpy(buf_.inline_buf, other.buf_.inline_buf, size_);
+            } else {
+                buf_.heap_buf = other.buf_.heap_buf;
+                other.capacity_ = INLINE_SIZE;
+            }
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    char* data() { return IsInline() ? buf_.inline_buf : buf_.heap_buf; }
+    const char* data() const { return IsInline() ? buf_.inline_buf : buf_.heap_buf; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+
+    char& operator[](size_t i) { return data()[i]; }
+    const char& operator[](size_t i) const { return data()[i]; }
+    char& back() { return data()[size_ - 1]; }
+    const char& back() const { return data()[size_ - 1]; }
+
+    void reserve(size_t n) {
+        if (n <= capacity_)
+            return;
+        // grow geometrically to keep push_back amortized O(1)
+        size_t new_capacity = capacity_ * 2;
+        if (new_capacity < n)
+            new_capacity = n;
+        char* new_buf = static_cast<char*>(malloc(new_capacity));
+        memcpy(new_buf, data(), size_);
+        if (!IsInline())
+            free(buf_.heap_buf);
+        buf_.heap_buf = new_buf;
+        capacity_ = new_capacity;
+    }
+
+    void resize(size_t n) {
+        reserve(n);
+        if (n > size_)
+            memset(data() + size_, 0, n - size_);
+        size_ = n;
+    }
+
+    void clear() { size_ = 0; }
+
+    void push_back(char c) {
+        reserve(size_ + 1);
+        data()[size_++] = c;
+    }
+
+    void pop_back() { size_--; }
+
+    void append(const void* ptr, size_t n) {
+        reserve(size_ + n);
+        memcpy(data() + size_, ptr, n);
+        size_ += n;
+    }
+
+    template <class InputIt>
+    void assign(InputIt first, InputIt last) {
+        size_ = 0;
+        insert(end(), first, last);
+    }
+
+    template <class InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        size_t off = pos - data();
+        size_t n = std::distance(first, last);
+        reserve(size_ + n);
+        char* p = data() + off;
+        memmove(p + n, p, size_ - off);
+        std::copy(first, last, p);
+        size_ += n;
+        return p;
+    }
+
+ private:
+    // heap buffers are always larger than INLINE_SIZE
+    bool IsInline() const { return capacity_ == INLINE_SIZE; }
+
+    uint32_t size_;
+    uint32_t capacity_;
+    union {
+        char inline_buf[INLINE_SIZE];
+        char* heap_buf;
+    } buf_;
+};
+
+inline bool operator==(const value_content_t& l, const value_content_t& r) {
+    return l.size() == r.size() && memcmp(l.data(), r.data(), l.size()) == 0;
+}
+
+inline bool operator!=(const value_content_t& l, const value_content_t& r) {
+    return !(l == r);
+}
+
+inline bool operator<(const value_content_t& l, const value_content_t& r) {
+    return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+}
+
+inline bool operator>(const value_content_t& l, const value_content_t& r) {
+    return r < l;
+}
+
+inline bool operator<=(const value_content_t& l, const value_content_t& r) {
+    return !(r < l);
+}
+
+inline bool operator>=(const value_content_t& l, const value_content_t& r) {
+    return !(l < r);
+}
+
+static uint8_t IntValueType = 1;
+static uint8_t DoubleValueType = 2;
+static uint8_t CharValueType = 3;
+static uint8_t StringValueType = 4;
+static uint8_t UintValueType = 5;
+static uint8_t PropKeyValueType = 6;
+// Code of a string in string_dict, see string_dict
+static uint8_t DictCodeValueType = 7;
+
 // type
 // 1->int, 2->double, 3->char, 4->string, 5->uint64_t
 struct value_t {
     uint8_t type;
-    vector<char> content;
+    value_content_t content;
     string DebugString() const;
     bool empty = false;
 
-    value_t() {
+    value_t() : type(0) {
         empty = true;
     }
 
@@ -441,29 +621,104 @@ struct ValueTHash {
     constexpr static int max_hash_len = 8;
 
     size_t operator() (const value_t& val) const{
-        uint64_t hash_tmp = mymath::hash_u64(val.type) + mymath::hash_u64(val.content.size());
+        // A code equals to its string, thus should have the same hash value
+        if (val.type == DictCodeValueType)
+            return HashDictCode(val);
+        return Hash(val.type, val.content.data(), val.content.size());
+    }
+
+    static size_t Hash(uint8_t type, const char* content, size_t size) {
+        uint64_t hash_tmp = mymath::hash_u64(type) + mymath::hash_u64(size);
 
-        int hash_loop_len = (max_hash_len > val.content.size()) ? val.content.size() : max_hash_len;
+        int hash_loop_len = (max_hash_len > size) ? size : max_hash_len;
 
         // Only use the former elements to compute the hash value
         for (int i = 0; i < hash_loop_len; i++)
-            hash_tmp = mymath::hash_u64(hash_tmp + val.content[i]);
+            hash_tmp = mymath::hash_u64(hash_tmp + content[i]);
 
         return hash_tmp;
     }
+
+    static size_t HashDictCode(const value_t& val);
 };
 
-static uint8_t IntValueType = 1;
-static uint8_t DoubleValueType = 2;
-static uint8_t CharValueType = 3;
-static uint8_t StringValueType = 4;
-static uint8_t UintValueType = 5;
-static uint8_t PropKeyValueType = 6;
+
+// content length at and above which the serialized length takes 4 extra bytes
+static const uint8_t VALUE_T_LONG_LEN = 0xFF;
 
 ibinstream& operator<<(ibinstream& m, const value_t& v);
 
 obinstream& operator>>(obinstream& m, value_t& v);
 
+// Packed column of fixed-width values sharing one value_t type.
+// Used as message payload for id-only intermediate results:
+//  IntValueType (vid/int)              -> 4-byte cells in u32
+//  UintValueType (eid), DoubleValueType -> 8-byte cells in u64 (raw bits for double)
+struct value_column_t {
+    uint8_t type;
+    vector<uint32_t> u32;
+    vector<uint64_t> u64;
+
+    value_column_t() : type(IntValueType) {}
+    explicit value_column_t(uint8_t _type) : type(_type) {}
+
+    static bool IsColumnType(uint8_t type) {
+        return type == IntValueType || type == UintValueType || type == DoubleValueType;
+    }
+
+    bool IsNarrow() const { return type == IntValueType; }
+
+    size_t size() const { return IsNarrow() ? u32.size() : u64.size(); }
+
+    // bytes of each cell
+    size_t width() const { return IsNarrow() ? sizeof(uint32_t) : sizeof(uint64_t); }
+
+    void reserve(size_t n) {
+        if (IsNarrow())
+            u32.reserve(n);
+        else
+            u64.reserve(n);
+    }
+
+    void clear() {
+        u32.clear();
+        u64.clear();
+    }
+
+    // raw cell value, vid for IntValueType, eid for UintValueType
+    uint64_t at(size_t i) const { return IsNarrow() ? u32[i] : u64[i]; }
+
+    void push_back(uint64_t raw) {
+        if (IsNarrow())
+            u32.push_back(static_cast<uint32_t>(raw));
+        else
+            u64.push_back(raw);
+    }
+
+    // remove cells for which func(raw) returns true, keeping the order of the others
+    template <class Func>
+    void remove_if(Func func) {
+        if (IsNarrow())
+            u32.erase(std::remove_if(u32.begin(), u32.end(), [&](uint32_t c) { return func(c); }), u32.end());
+        else
+            u64.erase(std::remove_if(u64.begin(), u64.end(), [&](uint64_t c) { return func(c); }), u64.end());
+    }
+
+    // move the first n cells into head
+    void MoveFront(size_t n, value_column_t& head);
+
+    void PushBack(const value_t& v);
+    void Get(size_t i, value_t& v) const;
+    void ToValues(vector<value_t>& vec) const;
+
+    // return false if values are not of one column type, col is untouched then
+    static bool FromValues(const vector<value_t>& vec, value_column_t& col);
+};
+
+ibinstream& operator<<(ibinstream& m, const value_column_t& col);
+
+obinstream& operator>>(obinstream& m, value_column_t& col);
+
 struct kv_pair {
     uint32_t key;
     value_t value;
@@ -497,6 +752,43 @@ ibinstream& operator<<(ibinstream& m, const elem_t& e);
 
 obinstream& operator>>(obinstream& m, elem_t& e);
 
+// Dictionary of the strings of property keys with few distinct values (e.g., gender, browser, language).
+// All keys share one code space, loaded in the same order on all workers, so codes have the same meaning everywhere.
+// Such a string is stored in PropertyRowList and shipped in Messages as its 4-byte code (DictCodeValueType),
+// which is small enough to be inlined in ValueHeader; it is only decoded when printed (DebugString) or returned by EndExpert.
+// A code compares and hashes the same as its string, and two codes are equal iff their contents are equal.
+// After Sort(), codes follow the order of their strings, so that two codes are ordered without looking up their strings.
+struct string_dict {
+    unordered_map<string, uint32_t> str2code;
+    vector<string> code2str;
+    // True if codes follow the order of their strings (value_content_t order), set by Sort()
+    bool order_preserving = false;
+
+    // Filled by HDFSDataLoader::GetStringIndexes, read-only afterwards
+    static string_dict* GetInstance() {
+        static string_dict dict;
+        return &dict;
+    }
+
+    // Add str if it is not in the dictionary yet
+    void Add(const string& str);
+    // Reassign codes in the order of strings, called after all strings are added
+    void Sort();
+    // Return false if value is not a string in the dictionary
+    bool Encode(const value_t& value, value_t& code) const;
+    // value.type should be DictCodeValueType
+    void Decode(value_t& value) const;
+    // The string of a code
+    const string& GetString(const value_t& code) const;
+
+    // The index of a code in code2str
+    static uint32_t GetIndex(const value_t& code) {
+        uint32_t index;
+        memcpy(&index, &code.content[0], sizeof(uint32_t));
+        return index;
+    }
+};
+
 struct string_index{
     unordered_map<string, label_t> str2el;  // map to edge_label
     unordered_map<label_t, string> el2str;
@@ -508,6 +800,8 @@ struct string_index{
     unordered_map<string, label_t> str2vpk;  // map to vtx's property key
     unordered_map<label_t, string> vpk2str;
     unordered_map<string, uint8_t> str2vptype;
+    unordered_set<label_t> dict_vpks;  // optional, vtx's property keys whose strings are encoded by string_dict
+    unordered_set<label_t> dict_epks;  // optional, edge's property keys whose strings are encoded by string_dict
 };
 
 enum Index_T { E_LABEL, E_PROPERTY, V_LABEL, V_PROPERTY };
@@ -14,20 +14,135 @@
 
 #pragma once
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <string>
 #include <vector>
 #include "core/message.hpp"
 #include "base/node.hpp"
+#include "utils/thread_parker.hpp"
 
 class AbstractMailbox {
  public:
-    virtual ~AbstractMailbox() {}
+    virtual ~AbstractMailbox() {
+        if (watch_fd_ >= 0)
+            close(watch_fd_);
+    }
 
     virtual void Init(vector<Node> & nodes) = 0;
-    virtual int Send(int tid, const Message & msg) = 0;
+    // Move msg to the recver; msg is left in a valid but unspecified state
+    virtual int Send(int tid, Message && msg) = 0;
+    // Send a copy of msg, for the caller that still needs it
+    int Send(int tid, const Message & msg) { return Send(tid, Message(msg)); }
     virtual bool TryRecv(int tid, Message & msg) = 0;
     virtual void Recv(int tid, Message & msg) = 0;
-    virtual void Sweep(int tid) = 0;
+    // Retry the msgs of tid that could not be sent, and flush its batches of remote msgs that time out.
+    // Flush all batches of tid if flush_all is true, called when tid has nothing else to do
+    virtual void Sweep(int tid, bool flush_all) = 0;
     virtual void SendNotification(int dst_nid, ibinstream& in) = 0;
     virtual void RecvNotification(obinstream& out) = 0;
+    // Statistics of the batching of remote messages
+    virtual string GetBatchStatistics() = 0;
+
+    // True if tid may receive a msg now
+    virtual bool HasMsg(int tid) = 0;
+
+    // Park the idle thread tid until a local msg is sent to it, it is woken by WakeParkedRecvers(), or timeout_us passes.
+    // Return false at once if it has msgs to receive or send
+    bool WaitForMsg(int tid, uint64_t timeout_us) {
+        return parker_.Park(tid, timeout_us, [this, tid] {
+            // Parked now, let the watcher add the recv fd of tid before checking for msgs
+            NotifyRecvWatcher();
+            return HasPendingSend(tid) || HasMsg(tid);
+        });
+    }
+
+    // Wake the parked threads with remote msgs, which cannot wake the recver when sent
+    void WakeParkedRecvers() {
+        if (parker_.GetParkedCount() == 0)
+            return;
+
+        for (int tid = 0; tid < num_recvers_; tid++) {
+            if (parker_.IsParked(tid) && HasMsg(tid))
+                parker_.Unpark(tid);
+        }
+    }
+
+    // True if remote msgs signal a recv fd, so that all recvers may park and WatchRecvers() wakes them
+    bool CanWatchRecvers() const { return watch_fd_ >= 0; }
+
+    // Block until a remote msg may have arrived for a parked thread, a thread parks, or StopWatchRecvers() is called,
+    // then wake the parked threads with msgs. Return false after StopWatchRecvers()
+    bool WatchRecvers() {
+        vector<struct pollfd> fds;
+        fds.push_back({watch_fd_, POLLIN, 0});
+        for (int tid = 0; tid < num_recvers_; tid++) {
+            if (parker_.IsParked(tid))
+                fds.push_back({GetRecvFd(tid), POLLIN, 0});
+        }
+
+        int ret = poll(fds.data(), fds.size(), -1);
+        CHECK(ret >= 0 || errno == EINTR) << "poll on recv fds failed: " << strerror(errno);
+        if (fds[0].revents & POLLIN) {
+            uint64_t count;
+            CHECK_EQ(read(watch_fd_, &count, sizeof(count)), static_cast<ssize_t>(sizeof(count)));
+        }
+        if (watch_end_.load(std::memory_order_acquire))
+            return false;
+
+        // HasMsg() also resets the recv fds of the parked threads
+        WakeParkedRecvers();
+        return true;
+    }
+
+    void StopWatchRecvers() {
+        watch_end_.store(true, std::memory_order_release);
+        NotifyRecvWatcher();
+    }
+
+ protected:
+    // Called in Init(). If watchable, all recvers may park, and the caller of WaitForMsg() should keep
+    // a thread calling WatchRecvers(), e.g. ExpertAdapter::ParkWatcher; GetRecvFd() should be overridden then.
+    // Otherwise one recver never parks, and watches for the remote msgs of the parked ones
+    void InitParker(int num_recvers, bool watchable) {
+        num_recvers_ = num_recvers;
+        if (watchable) {
+            watch_fd_ = eventfd(0, EFD_CLOEXEC);
+            CHECK(watch_fd_ >= 0) << "eventfd failed: " << strerror(errno);
+            parker_.Init(num_recvers, num_recvers);
+        } else {
+            parker_.Init(num_recvers, num_recvers - 1);
+        }
+    }
+
+    // Called after a msg is pushed to the local queue of tid
+    void WakeRecver(int tid) { parker_.Unpark(tid); }
+
+    // True if tid has msgs waiting to be sent, called by tid itself
+    virtual bool HasPendingSend(int tid) { return false; }
+
+    // The fd that becomes readable when a remote msg may have arrived for tid, called if watchable
+    virtual int GetRecvFd(int tid) { return -1; }
+
+    // Capacity of the lock-free ring of each local message queue, extra messages overflow into a locked queue
+    static constexpr size_t LOCAL_QUEUE_CAPACITY = 1024;
+
+ private:
+    void NotifyRecvWatcher() {
+        if (watch_fd_ < 0)
+            return;
+        uint64_t count = 1;
+        CHECK_EQ(write(watch_fd_, &count, sizeof(count)), static_cast<ssize_t>(sizeof(count)));
+    }
+
+    ThreadParker parker_;
+    int num_recvers_ = 0;
+    // eventfd waking WatchRecvers() when a thread parks or it should stop, -1 if not watchable
+    int watch_fd_ = -1;
+    std::atomic<bool> watch_end_{false};
 };
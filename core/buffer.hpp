@@ -17,6 +17,7 @@
 #include <memory>
 
 #include "utils/config.hpp"
+#include "utils/huge_page_util.hpp"
 #include "utils/unit.hpp"
 
 #include "glog/logging.h"
@@ -33,7 +34,7 @@ class Buffer {
     }
 
     ~Buffer() {
-        delete[] buffer_;
+        HugePageUtil::Unmap(buffer_, buffer_bytes_);
     }
 
     // Get index of (nid, tid) at reference node
@@ -156,6 +157,7 @@ class Buffer {
  private:
     // layout: (kv-store) | send_buffer | recv_buffer | local_head_buffer | remote_head_buffer
     char* buffer_;
+    size_t buffer_bytes_;
     Config* config_;
     Node & node_;
 
@@ -163,8 +165,7 @@ class Buffer {
         config_ = Config::GetInstance();
 
         if (config_->global_use_rdma) {  // rdma
-            buffer_ = new char[config_->buffer_sz];
-            memset(buffer_, 0, config_->buffer_sz);
+            Allocate(config_->buffer_sz);
             config_->kvstore = buffer_ + config_->kvstore_offset;
             config_->send_buf = buffer_ + config_->send_buffer_offset;
             config_->recv_buf = buffer_ + config_->recv_buffer_offset;
@@ -174,12 +175,19 @@ class Buffer {
             config_->dgram_send_buf = buffer_ + config_->dgram_send_buffer_offset;
             config_->dgram_recv_buf = buffer_ + config_->dgram_recv_buffer_offset;
         } else {  // without rdma
-            buffer_ = new char[config_->kvstore_sz + config_->trx_table_sz];
-            memset(buffer_, 0, config_->kvstore_sz + config_->trx_table_sz);
+            Allocate(config_->kvstore_sz + config_->trx_table_sz);
             config_->kvstore = buffer_ + config_->kvstore_offset;
             config_->trx_table = buffer_ + config_->kvstore_sz;
         }
     }
 
+    // Zero-filled memory, faulted in by all threads rather than by a serial memset
+    void Allocate(size_t size) {
+        buffer_bytes_ = size;
+        buffer_ = reinterpret_cast<char*>(HugePageUtil::Map(buffer_bytes_, config_->global_enable_huge_page));
+        CHECK(buffer_ != nullptr) << "Buffer: failed to allocate " << size << " bytes";
+        HugePageUtil::ParallelTouch(buffer_, buffer_bytes_, config_->global_num_threads);
+    }
+
     Buffer(const Buffer&);
 };
@@ -15,7 +15,9 @@
 #ifndef EXPERTS_ADAPTER_HPP_
 #define EXPERTS_ADAPTER_HPP_
 
+#include <emmintrin.h>
 #include <omp.h>
+#include <unistd.h>
 #include <tbb/concurrent_hash_map.h>
 #include <map>
 #include <vector>
@@ -59,6 +61,7 @@
 #include "core/factory.hpp"
 #include "core/result_collector.hpp"
 #include "layout/data_storage.hpp"
+#include "layout/epoch_manager.hpp"
 #include "layout/index_store.hpp"
 #include "layout/pmt_rct_table.hpp"
 #include "utils/config.hpp"
@@ -133,9 +136,15 @@ class ExpertAdapter {
 
         for (int i = 0; i < num_thread_; ++i)
             thread_pool_.emplace_back(&ExpertAdapter::ThreadExecutor, this, i);
+        if (config_->global_expert_park_after_us > 0 && mailbox_->CanWatchRecvers())
+            park_watcher_ = thread(&ExpertAdapter::ParkWatcher, this);
     }
 
     void Stop() {
+      if (park_watcher_.joinable()) {
+        mailbox_->StopWatchRecvers();
+        park_watcher_.join();
+      }
       for (auto &thread : thread_pool_)
         thread.join();
     }
@@ -171,10 +180,11 @@ class ExpertAdapter {
                 msg.meta.recver_nid = msg.meta.parent_nid;
                 msg.meta.recver_tid = msg.meta.parent_tid;
                 msg.data.clear();
+                msg.col_data.clear();
                 value_t v;
                 Tool::str2str("Abort with [MSG_T::TERMINATE]", v);
                 msg.data.emplace_back(history_t(), vector<value_t>(1, v));
-                mailbox_->Send(tid, msg);
+                mailbox_->Send(tid, move(msg));
                 return;
             }
         }
@@ -223,15 +233,20 @@ class ExpertAdapter {
         if (!msg_logic_table_.find(ac, m.qid)) {
             // throw msg back to the mailbox
             msg.meta.recver_tid = msg.meta.parent_tid;
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
 
             return;
         }
 
+        // Experts read row lists without locks, hold one epoch for the whole message
+        EpochGuard epoch_guard;
         int current_step;
         do {
             current_step = msg.meta.step;
             EXPERT_T next_expert = ac->second.experts[current_step].expert_type;
+            if (msg.IsColumnar() && !experts_[next_expert]->SupportColumnData()) {
+                msg.ToRowData();
+            }
             experts_[next_expert]->process(ac->second, msg);
         } while (current_step != msg.meta.step);  // process next expert directly if step is modified
 
@@ -253,8 +268,11 @@ class ExpertAdapter {
         vector<int> steal_list;
         core_affinity_->GetStealList(tid, steal_list);
 
+        uint64_t idle_rounds = 0;
+        uint64_t idle_start = 0;
         while (true) {
-            mailbox_->Sweep(tid);
+            // Only timed-out batches, so that the msgs sent by consecutive executions share frames
+            mailbox_->Sweep(tid, false);
 
             Message recv_msg;
             bool success = mailbox_->TryRecv(tid, recv_msg);
@@ -262,10 +280,7 @@ class ExpertAdapter {
             if (success) {
                 execute(tid, recv_msg);
                 times_[tid] = timer::get_usec();
-            } else {
-                if (!config_->global_enable_workstealing)
-                    continue;
-
+            } else if (config_->global_enable_workstealing) {
                 if (steal_list.size() == 0) {  // num_thread_ < 6
                     success = mailbox_->TryRecv((tid + 1) % num_thread_, recv_msg);
                     if (success) {
@@ -285,10 +300,51 @@ class ExpertAdapter {
                 }
                 times_[tid] = timer::get_usec();
             }
+
+            if (success) {
+                idle_rounds = 0;
+            } else {
+                WaitIdle(tid, idle_rounds, idle_start);
+            }
         }
     }
 
  private:
+    // Called after each round of tid that receives nothing
+    void WaitIdle(int tid, uint64_t& idle_rounds, uint64_t& idle_start) {
+        // Nothing to receive or steal, nothing will join the batches of tid soon
+        if (idle_rounds == 0)
+            mailbox_->Sweep(tid, true);
+
+        if (idle_rounds++ < IDLE_SPIN_ROUNDS) {
+            _mm_pause();
+            return;
+        }
+
+        // Idle threads also watch for remote msgs of the parked ones, which is the only watch if the mailbox
+        // cannot watch its recvers, e.g. RDMA; one thread never parks then
+        mailbox_->WakeParkedRecvers();
+
+        uint64_t now = timer::get_usec();
+        if (idle_rounds == IDLE_SPIN_ROUNDS + 1)
+            idle_start = now;
+
+        if (config_->global_expert_park_after_us > 0 && now >= idle_start + config_->global_expert_park_after_us
+                && mailbox_->WaitForMsg(tid, PARK_TIMEOUT_US)) {
+            // Keep idle_rounds, thus it parks again at once after a timeout.
+            // If woken by a msg, the round receiving it resets idle_rounds and it spins for the following msgs
+            times_[tid] = timer::get_usec();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // Remote msgs cannot wake their parked recvers when they arrive. This thread never runs experts, and sleeps
+    // in WatchRecvers() until the recv fd of a parked thread is signaled, thus it also wakes them when all other threads are busy
+    void ParkWatcher() {
+        while (mailbox_->WatchRecvers()) {}
+    }
+
     AbstractMailbox * mailbox_;
     ResultCollector * rc_;
     DataStorage * data_storage_;
@@ -312,6 +368,7 @@ class ExpertAdapter {
 
     // Thread pool
     vector<thread> thread_pool_;
+    thread park_watcher_;
 
     // clocks
     vector<uint64_t> times_;
@@ -324,6 +381,12 @@ class ExpertAdapter {
     static const int timer_offset = 5;
 
     static const uint64_t STEALTIMEOUT = 1000;
+
+    // Idle policy of expert threads:
+    // pause for IDLE_SPIN_ROUNDS, then yield for global_expert_park_after_us, then park for up to PARK_TIMEOUT_US.
+    // PARK_TIMEOUT_US is only a safety net, parked threads are woken by senders, ParkWatcher or other idle threads
+    static const uint64_t IDLE_SPIN_ROUNDS = 64;
+    static const uint64_t PARK_TIMEOUT_US = 10000;
 };
 
 
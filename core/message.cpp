@@ -12,41 +12,72 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdlib>
 #include <map>
 
 #include "core/message.hpp"
 
+// msg_path "3\t2\t5" is sent as the count of numbers followed by the numbers, in varints
+static void WriteMsgPath(ibinstream& m, const string& msg_path) {
+    uint64_t count = msg_path.empty() ? 0 : std::count(msg_path.begin(), msg_path.end(), '\t') + 1;
+    write_varint(m, count);
+
+    const char* p = msg_path.c_str();
+    for (uint64_t i = 0; i < count; i++) {
+        char* end;
+        write_varint(m, strtoull(p, &end, 10));
+        CHECK(end != p && (*end == '\t' || *end == '\0')) << "Invalid msg path " << msg_path;
+        p = end + 1;
+    }
+}
+
+static void ReadMsgPath(obinstream& m, string& msg_path) {
+    uint64_t count = read_varint(m);
+    msg_path.clear();
+    for (uint64_t i = 0; i < count; i++) {
+        if (i > 0)
+            msg_path += '\t';
+        msg_path += to_string(read_varint(m));
+    }
+}
+
 ibinstream& operator<<(ibinstream& m, const Branch_Info& info) {
-    m << info.node_id;
-    m << info.thread_id;
-    m << info.index;
-    m << info.key;
-    m << info.msg_id;
-    m << info.msg_path;
+    write_svarint(m, info.node_id);
+    write_svarint(m, info.thread_id);
+    write_svarint(m, info.index);
+    write_svarint(m, info.key);
+    write_varint(m, info.msg_id);
+    WriteMsgPath(m, info.msg_path);
     return m;
 }
 
 obinstream& operator>>(obinstream& m, Branch_Info& info) {
-    m >> info.node_id;
-    m >> info.thread_id;
-    m >> info.index;
-    m >> info.key;
-    m >> info.msg_id;
-    m >> info.msg_path;
+    info.node_id = read_svarint(m);
+    info.thread_id = read_svarint(m);
+    info.index = read_svarint(m);
+    info.key = read_svarint(m);
+    info.msg_id = read_varint(m);
+    ReadMsgPath(m, info.msg_path);
     return m;
 }
 
+// Meta on the wire: small fields in varints, and the query plan in INIT msgs only,
+// which is cached by qid on each node for the following msgs of the query
 ibinstream& operator<<(ibinstream& m, const Meta& meta) {
     m << meta.qid;
-    m << meta.step;
+    write_svarint(m, meta.step);
     m << meta.query_count_in_trx;
-    m << meta.msg_type;
-    m << meta.recver_nid;
-    m << meta.recver_tid;
-    m << meta.parent_nid;
-    m << meta.parent_tid;
-    m << meta.msg_path;
-    m << meta.branch_infos;
+    m << static_cast<uint8_t>(meta.msg_type);
+    write_svarint(m, meta.recver_nid);
+    write_svarint(m, meta.recver_tid);
+    write_svarint(m, meta.parent_nid);
+    write_svarint(m, meta.parent_tid);
+    WriteMsgPath(m, meta.msg_path);
+    write_varint(m, meta.branch_infos.size());
+    for (auto& info : meta.branch_infos) {
+        m << info;
+    }
     if (meta.msg_type == MSG_T::INIT) {
         m << meta.qplan;
     }
@@ -54,16 +85,21 @@ ibinstream& operator<<(ibinstream& m, const Meta& meta) {
 }
 
 obinstream& operator>>(obinstream& m, Meta& meta) {
+    uint8_t msg_type;
     m >> meta.qid;
-    m >> meta.step;
+    meta.step = read_svarint(m);
     m >> meta.query_count_in_trx;
-    m >> meta.msg_type;
-    m >> meta.recver_nid;
-    m >> meta.recver_tid;
-    m >> meta.parent_nid;
-    m >> meta.parent_tid;
-    m >> meta.msg_path;
-    m >> meta.branch_infos;
+    m >> msg_type;
+    meta.msg_type = static_cast<MSG_T>(msg_type);
+    meta.recver_nid = read_svarint(m);
+    meta.recver_tid = read_svarint(m);
+    meta.parent_nid = read_svarint(m);
+    meta.parent_tid = read_svarint(m);
+    ReadMsgPath(m, meta.msg_path);
+    meta.branch_infos.resize(read_varint(m));
+    for (auto& info : meta.branch_infos) {
+        m >> info;
+    }
     if (meta.msg_type == MSG_T::INIT) {
         m >> meta.qplan;
     }
@@ -95,16 +131,18 @@ std::string Meta::DebugString() const {
 ibinstream& operator<<(ibinstream& m, const Message& msg) {
     m << msg.meta;
     m << msg.data;
-    m << msg.max_data_size;
-    m << msg.data_size;
+    m << msg.col_data;
+    write_varint(m, msg.max_data_size);
+    write_varint(m, msg.data_size);
     return m;
 }
 
 obinstream& operator>>(obinstream& m, Message& msg) {
     m >> msg.meta;
     m >> msg.data;
-    m >> msg.max_data_size;
-    m >> msg.data_size;
+    m >> msg.col_data;
+    msg.max_data_size = read_varint(m);
+    msg.data_size = read_varint(m);
     return m;
 }
 
@@ -392,6 +430,17 @@ void Message::CreateAbortMsg(const vector<Expert_Object>& experts, vector<Messag
 
 void Message::CreateNextMsg(const vector<Expert_Object>& experts, vector<pair<history_t, vector<value_t>>>& data,
                         int num_thread, CoreAffinity* core_affinity, vector<Message>& vec) {
+    CreateNextMsgImpl(experts, data, num_thread, core_affinity, vec);
+}
+
+void Message::CreateNextMsg(const vector<Expert_Object>& experts, vector<pair<history_t, value_column_t>>& data,
+                        int num_thread, CoreAffinity* core_affinity, vector<Message>& vec) {
+    CreateNextMsgImpl(experts, data, num_thread, core_affinity, vec);
+}
+
+template <class PayloadT>
+void Message::CreateNextMsgImpl(const vector<Expert_Object>& experts, vector<pair<history_t, PayloadT>>& data,
+                        int num_thread, CoreAffinity* core_affinity, vector<Message>& vec) {
     Meta m = this->meta;
     m.step = experts[this->meta.step].next_expert;
 
@@ -497,7 +546,7 @@ void Message::CreateBranchedMsgWithHisLabel(const vector<Expert_Object>& experts
         }
         for (auto& value : pair.second) {
             value_t v;
-            Tool::str2int(to_string(count ++), v);
+            Tool::int2value_t(count ++, v);
             history_t his = pair.first;
             his.emplace_back(m.step, move(v));
             vector<value_t> val_vec;
@@ -625,7 +674,7 @@ void Message::DispatchData(Meta& m, const vector<Expert_Object>& experts, vector
             }
             if (is_count) {
                 value_t v;
-                Tool::str2int(to_string(p.second.size()), v);
+                Tool::int2value_t(p.second.size(), v);
                 id2data[m.recver_nid].emplace_back(move(p.first), vector<value_t>{move(v)});
             } else {
                 id2data[m.recver_nid].push_back(move(p));
@@ -665,6 +714,116 @@ void Message::DispatchData(Meta& m, const vector<Expert_Object>& experts, vector
     }
 }
 
+void Message::DispatchData(Meta& m, const vector<Expert_Object>& experts, vector<pair<history_t, value_column_t>>& data,
+                        int num_thread, CoreAffinity * core_affinity, vector<Message>& vec) {
+    Meta cm = m;
+    Meta rm = m;
+    bool route_assigned = UpdateRoute(rm, experts);
+
+    // UpdateRoute may skip BRANCH/REPEAT steps, check the type of the step after it
+    // DropE and AddE rebuild edges from value_t
+    EXPERT_T next_type = experts[rm.step].expert_type;
+    if (next_type == EXPERT_T::DROP || next_type == EXPERT_T::ADDE) {
+        vector<pair<history_t, vector<value_t>>> row_data;
+        for (auto& p : data) {
+            row_data.emplace_back(move(p.first), vector<value_t>());
+            p.second.ToValues(row_data.back().second);
+        }
+        DispatchData(m, experts, row_data, num_thread, core_affinity, vec);
+        return;
+    }
+
+    m = move(rm);
+    bool empty_to_barrier = UpdateCollectionRoute(cm, experts);
+    // <node id, data>
+    map<int, vector<pair<history_t, value_column_t>>> id2data;
+    // store history with empty data
+    vector<pair<history_t, vector<value_t>>> empty_his;
+
+    bool is_count = false;
+    if (next_type == EXPERT_T::COUNT && experts[m.step-1].expert_type != EXPERT_T::INIT) {
+        is_count = true;
+    }
+
+    // enable route mapping
+    if (!route_assigned && experts[this->meta.step].send_remote) {
+        SimpleIdMapper * id_mapper = SimpleIdMapper::GetInstance();
+        for (auto& p : data) {
+            if (p.second.size() == 0) {
+                if (empty_to_barrier)
+                    empty_his.emplace_back(move(p.first), vector<value_t>());
+                continue;
+            }
+
+            // get node id
+            map<int, value_column_t> id2col;
+            for (size_t i = 0; i < p.second.size(); i++) {
+                uint64_t raw = p.second.at(i);
+                int node = GetNodeId(p.second.type, raw, id_mapper);
+                auto itr = id2col.find(node);
+                if (itr == id2col.end()) {
+                    itr = id2col.emplace(node, value_column_t(p.second.type)).first;
+                }
+                itr->second.push_back(raw);
+            }
+
+            // insert his/column pair to corresponding node
+            for (auto& item : id2col) {
+                id2data[item.first].emplace_back(p.first, move(item.second));
+            }
+        }
+
+        // no data is added to next expert
+        if (id2data.size() == 0 && empty_his.size() == 0) {
+            empty_his.emplace_back(history_t(), vector<value_t>());
+        }
+    } else {
+        for (auto& p : data) {
+            if (p.second.size() == 0) {
+                if (empty_to_barrier)
+                    empty_his.emplace_back(move(p.first), vector<value_t>());
+                continue;
+            }
+            if (is_count) {
+                value_column_t col(IntValueType);
+                col.push_back(p.second.size());
+                id2data[m.recver_nid].emplace_back(move(p.first), move(col));
+            } else {
+                id2data[m.recver_nid].push_back(move(p));
+            }
+        }
+
+        // no data is added to next expert
+        if (id2data.find(m.recver_nid) == id2data.end() && empty_his.size() == 0) {
+            empty_his.emplace_back(history_t(), vector<value_t>());
+        }
+    }
+
+    for (auto& item : id2data) {
+        // insert data to msg
+        do {
+            Message msg(m);
+            msg.max_data_size = this->max_data_size;
+            msg.meta.recver_nid = item.first;
+            msg.meta.recver_tid = core_affinity->GetThreadIdForExpert(experts[m.step].expert_type);
+            msg.InsertData(item.second);
+            vec.push_back(move(msg));
+        } while ((item.second.size() != 0));    // Data no consumed
+    }
+
+    // send history with empty data
+    if (empty_his.size() != 0) {
+        // insert history to msg
+        do {
+            Message msg(cm);
+            msg.max_data_size = this->max_data_size;
+            msg.meta.recver_tid = core_affinity->GetThreadIdForExpert(experts[cm.step].expert_type);
+            msg.InsertData(empty_his);
+            vec.push_back(move(msg));
+        } while ((empty_his.size() != 0));    // Data no consumed
+    }
+}
+
 bool Message::UpdateRoute(Meta& m, const vector<Expert_Object>& experts) {
     int branch_depth = m.branch_infos.size() - 1;
     // update recver route & msg_type
@@ -753,6 +912,51 @@ int Message::GetNodeId(const value_t & v, SimpleIdMapper * id_mapper, bool consi
     }
 }
 
+int Message::GetNodeId(uint8_t type, uint64_t raw, SimpleIdMapper * id_mapper) {
+    if (type == IntValueType) {
+        vid_t v_id(static_cast<int>(raw));
+        return id_mapper->GetMachineIdForVertex(v_id);
+    } else if (type == UintValueType) {
+        eid_t e_id;
+        uint2eid_t(raw, e_id);
+        return id_mapper->GetMachineIdForEdge(e_id, false);
+    } else {
+        cout << "Wrong Type when getting node id" << static_cast<int>(type) << endl;
+        return -1;
+    }
+}
+
+void Message::ToRowData() {
+    for (auto& p : col_data) {
+        data.emplace_back(move(p.first), vector<value_t>());
+        p.second.ToValues(data.back().second);
+    }
+    col_data.clear();
+}
+
+bool Message::ToColumnData() {
+    if (IsColumnar()) {
+        return true;
+    }
+
+    vector<pair<history_t, value_column_t>> tmp;
+    tmp.reserve(data.size());
+    for (auto& p : data) {
+        value_column_t col;
+        if (!value_column_t::FromValues(p.second, col)) {
+            return false;
+        }
+        tmp.emplace_back(history_t(), move(col));
+    }
+
+    for (int i = 0; i < data.size(); i++) {
+        tmp[i].first = move(data[i].first);
+    }
+    data.clear();
+    col_data.swap(tmp);
+    return true;
+}
+
 bool Message::InsertData(pair<history_t, vector<value_t>>& pair) {
     size_t space = max_data_size - data_size;
     size_t his_size = MemSize(pair.first) + sizeof(size_t);
@@ -802,6 +1006,51 @@ void Message::InsertData(vector<pair<history_t, vector<value_t>>>& vec) {
     vec.erase(vec.begin(), itr);
 }
 
+bool Message::InsertData(pair<history_t, value_column_t>& pair) {
+    size_t space = max_data_size - data_size;
+    size_t his_size = MemSize(pair.first) + MemSize(value_column_t());
+
+    if (pair.second.size() == 0) {
+        col_data.push_back(pair);
+        data_size += his_size;
+        return true;
+    }
+
+    // check if able to add history
+    // no space for history
+    if (his_size >= space) {
+        return false;
+    }
+
+    size_t n = (space - his_size) / pair.second.width();
+    if (n >= pair.second.size()) {
+        data_size += his_size + pair.second.size() * pair.second.width();
+        col_data.push_back(move(pair));
+        pair.second.clear();
+        return true;
+    }
+
+    // move data
+    if (n != 0) {
+        value_column_t temp;
+        pair.second.MoveFront(n, temp);
+        col_data.emplace_back(pair.first, move(temp));
+        data_size += his_size + n * pair.second.width();
+    }
+
+    return false;
+}
+
+void Message::InsertData(vector<pair<history_t, value_column_t>>& vec) {
+    auto itr = vec.begin();
+    for (; itr != vec.end(); itr++) {
+        if (!InsertData(*itr)) {
+            break;
+        }
+    }
+    vec.erase(vec.begin(), itr);
+}
+
 std::string Message::DebugString() const {
     std::stringstream ss;
     ss << meta.DebugString();
@@ -810,6 +1059,11 @@ std::string Message::DebugString() const {
       for (const auto& d : data)
           ss << " data_size=" << d.second.size();
     }
+    if (col_data.size()) {
+      ss << " Column Body:";
+      for (const auto& d : col_data)
+          ss << " data_size=" << d.second.size();
+    }
     return ss.str();
 }
 
@@ -836,7 +1090,9 @@ size_t MemSize(const char& c) {
 }
 
 size_t MemSize(const value_t& data) {
-    size_t s = sizeof(uint8_t);
-    s += MemSize(data.content);
-    return s;
+    return serialized_size(data);
+}
+
+size_t MemSize(const value_column_t& data) {
+    return serialized_size(data);
 }
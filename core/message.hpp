@@ -112,19 +112,32 @@ class Message {
 
     std::vector<pair<history_t, vector<value_t>>> data;
 
+    // columnar payload, used instead of data for id-only results
+    // a msg carries either data or col_data, never both
+    std::vector<pair<history_t, value_column_t>> col_data;
+
     // size of data
     size_t data_size;
     // maximum size of data
     size_t max_data_size;
 
-    Message() : data_size(sizeof(size_t)), max_data_size(TEN_MB) {}
+    Message() : data_size(sizeof(size_t) * 2), max_data_size(TEN_MB) {}
     explicit Message(const Meta& m) : Message() {
         meta = m;
     }
 
+    bool IsColumnar() const { return col_data.size() != 0; }
+
+    // convert col_data into data
+    void ToRowData();
+    // convert data into col_data, return false and keep data if it is not of column types
+    bool ToColumnData();
+
     // move data from srouce into msg
     bool InsertData(pair<history_t, vector<value_t>>& pair);
     void InsertData(vector<pair<history_t, vector<value_t>>>& vec);
+    bool InsertData(pair<history_t, value_column_t>& pair);
+    void InsertData(vector<pair<history_t, value_column_t>>& vec);
 
     // create init msg
     static void CreateInitMsg(uint64_t qid, uint8_t query_count_in_trx, int parent_node, int nodes_num, int recv_tid,
@@ -144,6 +157,10 @@ class Message {
     void CreateNextMsg(const vector<Expert_Object>& experts, vector<pair<history_t, vector<value_t>>>& data,
                     int num_thread, CoreAffinity* core_affinity, vector<Message>& vec);
 
+    // columnar version of CreateNextMsg, next msgs carry col_data
+    void CreateNextMsg(const vector<Expert_Object>& experts, vector<pair<history_t, value_column_t>>& data,
+                    int num_thread, CoreAffinity* core_affinity, vector<Message>& vec);
+
     // experts:  experts chain for current message
     // stpes:   branching steps
     // vec:     messages to be send
@@ -167,12 +184,18 @@ class Message {
     // dispatch input data to different node
     void DispatchData(Meta& m, const vector<Expert_Object>& experts, vector<pair<history_t, vector<value_t>>>& data,
                     int num_thread, CoreAffinity * core_affinity, vector<Message>& vec);
+    void DispatchData(Meta& m, const vector<Expert_Object>& experts, vector<pair<history_t, value_column_t>>& data,
+                    int num_thread, CoreAffinity * core_affinity, vector<Message>& vec);
+    template <class PayloadT>
+    void CreateNextMsgImpl(const vector<Expert_Object>& experts, vector<pair<history_t, PayloadT>>& data,
+                    int num_thread, CoreAffinity * core_affinity, vector<Message>& vec);
     // update route to next expert
     bool UpdateRoute(Meta& m, const vector<Expert_Object>& experts);
     // update route to barrier or labelled branch experts for msg collection
     bool UpdateCollectionRoute(Meta& m, const vector<Expert_Object>& experts);
     // get the node where vertex or edge is stored
     static int GetNodeId(const value_t & v, SimpleIdMapper * id_mapper, bool consider_both_edge = false);
+    static int GetNodeId(uint8_t type, uint64_t raw, SimpleIdMapper * id_mapper);
     // Redistribute params of experts according to data locality
     static void AssignParamsByLocality(vector<QueryPlan>& qplans);
 
@@ -190,6 +213,7 @@ obinstream& operator>>(obinstream& m, Message& msg);
 size_t MemSize(const int& i);
 size_t MemSize(const char& c);
 size_t MemSize(const value_t& data);
+size_t MemSize(const value_column_t& data);
 
 template<class T1, class T2>
 size_t MemSize(const pair<T1, T2>& p);
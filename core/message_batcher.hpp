@@ -0,0 +1,185 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/serialization.hpp"
+#include "core/message.hpp"
+#include "utils/timer.hpp"
+
+/* Coalesces the remote messages of each sender thread into one frame per destination thread.
+ * Frame: | uint32_t count | Message 1 | ... | Message count |
+ *
+ * A batch is flushed when:
+ *   SIZE:    its frame reaches batch_sz bytes;
+ *   TIMEOUT: its first message has waited for timeout_us, checked when the sender sends or sweeps;
+ *   SWEEP:   the sender has nothing to receive, thus no more messages will join the batch soon.
+ * If batch_sz is 0, every message is sent in its own frame (UNBATCHED) and Append() is not used.
+ *
+ * Batches of a sender are only accessed by the sender thread.
+ */
+class MessageBatcher {
+ public:
+    enum FlushReason { SIZE, TIMEOUT, SWEEP, UNBATCHED, REASON_COUNT };
+
+    MessageBatcher(int num_senders, int num_dsts, size_t batch_sz, uint64_t timeout_us) :
+            num_dsts_(num_dsts), batch_sz_(batch_sz), timeout_us_(timeout_us),
+            senders_(num_senders) {
+        for (auto& sender : senders_)
+            sender.batches.resize(num_dsts);
+    }
+
+    bool Enabled() const { return batch_sz_ > 0; }
+
+    // Append msg to the batch of (sender, dst), return true if the batch should be flushed for SIZE
+    bool Append(int sender, int dst, const Message& msg) {
+        sender_t& s = senders_[sender];
+        batch_t& batch = s.batches[dst];
+        if (batch.count == 0) {
+            // Placeholder of count, filled in when flushed
+            *(batch.stream) << (uint32_t)0;
+            batch.first_us = timer::get_usec();
+            if (s.oldest_us == 0)
+                s.oldest_us = batch.first_us;
+        }
+
+        *(batch.stream) << msg;
+        batch.count++;
+        return batch.stream->size() >= batch_sz_;
+    }
+
+    // Call flush(dst, frame) on the batch of (sender, dst), frame is an ibinstream* owned by the callee
+    template <class FlushFunc>
+    void Flush(int sender, int dst, FlushReason reason, const FlushFunc& flush) {
+        batch_t& batch = senders_[sender].batches[dst];
+        if (batch.count == 0)
+            return;
+
+        *reinterpret_cast<uint32_t*>(batch.stream->get_buf()) = batch.count;
+        Record(sender, batch.count, batch.stream->size(), reason);
+
+        ibinstream* frame = batch.stream.release();
+        batch.stream.reset(new ibinstream);
+        batch.count = 0;
+        flush(dst, frame);
+    }
+
+    // Flush the batches of sender whose first message has waited for timeout_us.
+    // Flush all batches of sender if sweep is true
+    template <class FlushFunc>
+    void FlushSender(int sender, bool sweep, const FlushFunc& flush) {
+        sender_t& s = senders_[sender];
+        if (s.oldest_us == 0)
+            return;
+
+        uint64_t now = timer::get_usec();
+        if (!sweep && now < s.oldest_us + timeout_us_)
+            return;
+
+        uint64_t oldest_us = 0;
+        for (int dst = 0; dst < num_dsts_; dst++) {
+            batch_t& batch = s.batches[dst];
+            if (batch.count == 0)
+                continue;
+
+            if (sweep || now >= batch.first_us + timeout_us_) {
+                Flush(sender, dst, sweep ? SWEEP : TIMEOUT, flush);
+            } else if (oldest_us == 0 || batch.first_us < oldest_us) {
+                oldest_us = batch.first_us;
+            }
+        }
+        s.oldest_us = oldest_us;
+    }
+
+    // Record a frame of msg_count messages
+    void Record(int sender, uint32_t msg_count, size_t frame_sz, FlushReason reason) {
+        stat_t& stat = senders_[sender].stat;
+        stat.frame_count.fetch_add(1, std::memory_order_relaxed);
+        stat.msg_count.fetch_add(msg_count, std::memory_order_relaxed);
+        stat.byte_count.fetch_add(frame_sz, std::memory_order_relaxed);
+        stat.flush_count[reason].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    string GetStatistics() {
+        uint64_t frames = 0, msgs = 0, bytes = 0;
+        uint64_t flushes[REASON_COUNT] = {0};
+        for (auto& sender : senders_) {
+            frames += sender.stat.frame_count.load(std::memory_order_relaxed);
+            msgs += sender.stat.msg_count.load(std::memory_order_relaxed);
+            bytes += sender.stat.byte_count.load(std::memory_order_relaxed);
+            for (int i = 0; i < REASON_COUNT; i++)
+                flushes[i] += sender.stat.flush_count[i].load(std::memory_order_relaxed);
+        }
+
+        string ret = "Remote messages: batch size = " + to_string(batch_sz_) + " bytes, timeout = "
+                     + to_string(timeout_us_) + " us\n";
+        ret += "\tframes = " + to_string(frames) + ", msgs = " + to_string(msgs) + ", bytes = " + to_string(bytes);
+        if (frames > 0) {
+            ret += ", msgs/frame = " + to_string(static_cast<double>(msgs) / frames);
+            ret += ", bytes/frame = " + to_string(bytes / frames);
+        }
+        ret += "\n\tflushed by size = " + to_string(flushes[SIZE]) + ", timeout = " + to_string(flushes[TIMEOUT])
+               + ", sweep = " + to_string(flushes[SWEEP]) + ", unbatched = " + to_string(flushes[UNBATCHED]) + "\n";
+        return ret;
+    }
+
+    // Write the frame header of a single message
+    static void WriteSingleHeader(ibinstream& m) {
+        m << (uint32_t)1;
+    }
+
+    // Unpack a frame, the first message to msg and others to rest in order
+    static void Unpack(obinstream& um, Message& msg, std::deque<Message>& rest) {
+        uint32_t count;
+        um >> count;
+        um >> msg;
+        for (uint32_t i = 1; i < count; i++) {
+            rest.emplace_back();
+            um >> rest.back();
+        }
+    }
+
+ private:
+    struct batch_t {
+        std::unique_ptr<ibinstream> stream{new ibinstream};
+        uint32_t count = 0;
+        uint64_t first_us = 0;
+    };
+
+    struct stat_t {
+        std::atomic<uint64_t> frame_count{0};
+        std::atomic<uint64_t> msg_count{0};
+        std::atomic<uint64_t> byte_count{0};
+        std::atomic<uint64_t> flush_count[REASON_COUNT] = {};
+    };
+
+    struct sender_t {
+        vector<batch_t> batches;
+        // first_us of the oldest non-empty batch, 0 if all are empty
+        uint64_t oldest_us = 0;
+        stat_t stat;
+    } __attribute__((aligned(64)));
+
+    int num_dsts_;
+    size_t batch_sz_;
+    uint64_t timeout_us_;
+    vector<sender_t> senders_;
+};
@@ -837,6 +837,37 @@ void ParserObject::ParsePredicate(string& param, uint8_t type, Expert_Object& ex
     expert.params.push_back(pred_param);
 }
 
+void ParserObject::EncodeDictParam(int key, Expert_Object& expert) {
+    unordered_set<label_t> *dict_pkeys;
+    if (io_type_ == VERTEX) {
+        dict_pkeys = &(parser_->indexes->dict_vpks);
+    } else if (io_type_ == EDGE) {
+        dict_pkeys = &(parser_->indexes->dict_epks);
+    } else {
+        return;
+    }
+    if (dict_pkeys->count(key) == 0) {
+        return;
+    }
+
+    // Codes are only ordered as their strings if string_dict is order-preserving
+    // Collection params are packed into one value_t, which cannot hold codes, and are encoded by HasExpert
+    string_dict* dict = string_dict::GetInstance();
+    int size = expert.params.size();
+    Predicate_T pred_type = (Predicate_T) Tool::value_t2int(expert.params[size - 2]);
+    bool is_equality = (pred_type == Predicate_T::EQ || pred_type == Predicate_T::NEQ);
+    bool is_order = (pred_type == Predicate_T::GT || pred_type == Predicate_T::GTE ||
+                     pred_type == Predicate_T::LT || pred_type == Predicate_T::LTE);
+    if (!is_equality && !(is_order && dict->order_preserving)) {
+        return;
+    }
+
+    value_t code;
+    if (dict->Encode(expert.params[size - 1], code)) {
+        expert.params[size - 1] = move(code);
+    }
+}
+
 void ParserObject::ParseInit(const string& line, string& var_name, string& query) {
     // @InitExpert params: (Element_T type, bool with_input, uint64_t [vids/eids] )
     // o_type = E/V
@@ -1223,6 +1254,7 @@ void ParserObject::ParseHas(const vector<string>& params, Step_T type) {
         }
         expert.AddParam(key);
         ParsePredicate(pred_param, vtype, expert, false);
+        EncodeDictParam(key, expert);
         break;
       case Step_T::HASVALUE:
         /*
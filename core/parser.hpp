@@ -189,6 +189,9 @@ class ParserObject {
     // Parse predicate
     void ParsePredicate(string& param, uint8_t type, Expert_Object& expert, bool toKey);
 
+    // Encode the scalar param of the last predicate into its code once per query, if key is in string_dict
+    void EncodeDictParam(int key, Expert_Object& expert);
+
     // Parse experts
     void ParseInit(const string& line, string& var_name, string& query);
     void ParseAddE(const vector<string>& params);
@@ -17,10 +17,14 @@
 
 RdmaMailbox::~RdmaMailbox() {
     for (int i = 0; i < config_->global_num_threads; i++) {
+        Message* msg;
+        while (local_msgs[i]->TryPop(msg))
+            delete msg;
         delete local_msgs[i];
     }
 
     free(local_msgs);
+    delete batcher_;
     free(schedulers);
     free(recv_locks);
     free(lmetas);
@@ -72,14 +76,20 @@ void RdmaMailbox::Init(vector<Node> & nodes) {
     schedulers = (scheduler_t *)malloc(sizeof(scheduler_t) * config_->global_num_threads);
     memset(schedulers, 0, sizeof(scheduler_t) * config_->global_num_threads);
 
-    local_msgs = reinterpret_cast<ThreadSafeQueue<Message> **>(
-                malloc(sizeof(ThreadSafeQueue<Message>*) * config_->global_num_threads));
+    local_msgs = reinterpret_cast<MPSCQueue<Message*> **>(
+                malloc(sizeof(MPSCQueue<Message*>*) * config_->global_num_threads));
     for (int i = 0; i < config_->global_num_threads; i++) {
-        local_msgs[i] = new ThreadSafeQueue<Message>();
+        local_msgs[i] = new MPSCQueue<Message*>(LOCAL_QUEUE_CAPACITY);
     }
 
     // 1 more thread for worker to send init msg
     pending_msgs.resize(config_->global_num_threads + Config::extra_send_buf_count);
+    batcher_ = new MessageBatcher(config_->global_num_threads + Config::extra_send_buf_count,
+                                  config_->global_num_workers * config_->global_num_threads,
+                                  KiB2B(config_->global_msg_batch_sz_kb), config_->global_msg_batch_timeout_us);
+    recv_batches.resize(config_->global_num_threads);
+    // Remote msgs are written by one-sided RDMA without any completion on this side
+    InitParker(config_->global_num_threads, false);
     rr_size = 3;
 
     pthread_spin_init(&send_notification_lock_, 0);
@@ -93,7 +103,9 @@ bool RdmaMailbox::IsBufferFull(int dst_nid, int dst_tid, uint64_t tail, uint64_t
     return rbf_sz < (tail - head + msg_sz);
 }
 
-void RdmaMailbox::Sweep(int tid) {
+void RdmaMailbox::Sweep(int tid, bool flush_all) {
+    batcher_->FlushSender(tid, flush_all, [this, tid](int dst, ibinstream* frame) { SendFrame(tid, dst, frame); });
+
     if (pending_msgs[tid].size() == 0) {
         return;
     }
@@ -107,26 +119,76 @@ void RdmaMailbox::Sweep(int tid) {
     }
 }
 
-int RdmaMailbox::Send(int tid, const Message & msg) {
+int RdmaMailbox::Send(int tid, Message && msg) {
     if (msg.meta.recver_nid == node_.get_local_rank()) {
-        local_msgs[msg.meta.recver_tid]->Push(msg);
-    } else {
+        int recver_tid = msg.meta.recver_tid;
+        local_msgs[recver_tid]->Push(new Message(move(msg)));
+        WakeRecver(recver_tid);
+    } else if (batcher_->Enabled()) {
+        auto flush = [this, tid](int dst, ibinstream* frame) { SendFrame(tid, dst, frame); };
+        int dst = msg.meta.recver_nid * config_->global_num_threads + msg.meta.recver_tid;
+        if (batcher_->Append(tid, dst, msg))
+            batcher_->Flush(tid, dst, MessageBatcher::SIZE, flush);
+        batcher_->FlushSender(tid, false, flush);
+    } else if (pending_msgs[tid].size() != 0) {
+        // Keep the order after pending messages
         mailbox_data_t data;
         data.dst_nid = msg.meta.recver_nid;
         data.dst_tid = msg.meta.recver_tid;
 
+        MessageBatcher::WriteSingleHeader(data.stream);
         data.stream << msg;
+        batcher_->Record(tid, 1, data.stream.size(), MessageBatcher::UNBATCHED);
 
         pending_msgs[tid].push_back(move(data));
+    } else {
+        // Serialize into the send buffer directly, between the header and the footer.
+        // The capacity is a multiple of sizeof(uint64_t), thus the aligned footer still fits.
+        char* send_buf = buffer_->GetSendBuf(tid);
+        uint64_t capacity = (buffer_->GetSendBufSize() - 2 * sizeof(uint64_t)) / sizeof(uint64_t) * sizeof(uint64_t);
+        ibinstream m(send_buf + sizeof(uint64_t), capacity);
+        MessageBatcher::WriteSingleHeader(m);
+        m << msg;
+        batcher_->Record(tid, 1, m.size(), MessageBatcher::UNBATCHED);
+
+        if (!m.in_place() || !WriteSendBuf(tid, msg.meta.recver_nid, msg.meta.recver_tid, nullptr, m.size())) {
+            // The recv buffer is full, retry in Sweep()
+            mailbox_data_t data;
+            data.dst_nid = msg.meta.recver_nid;
+            data.dst_tid = msg.meta.recver_tid;
+
+            if (m.in_place())
+                data.stream.raw_bytes(m.get_buf(), m.size());
+            else
+                data.stream = move(m);
+
+            pending_msgs[tid].push_back(move(data));
+        }
     }
+    return 0;
 }
 
-bool RdmaMailbox::SendData(int tid, const mailbox_data_t& data) {
+void RdmaMailbox::SendFrame(int tid, int dst, ibinstream* frame) {
+    int dst_nid = dst / config_->global_num_threads;
+    int dst_tid = dst % config_->global_num_threads;
+
+    // Keep the order after pending messages
+    if (pending_msgs[tid].size() != 0 || !WriteSendBuf(tid, dst_nid, dst_tid, frame->get_buf(), frame->size())) {
+        mailbox_data_t data;
+        data.dst_nid = dst_nid;
+        data.dst_tid = dst_tid;
+        data.stream = move(*frame);
+        pending_msgs[tid].push_back(move(data));
+    }
+    delete frame;
+}
+
+bool RdmaMailbox::SendData(int tid, mailbox_data_t& data) {
     // Send data to remote machine only
-    int dst_nid = data.dst_nid;
-    int dst_tid = data.dst_tid;
+    return WriteSendBuf(tid, data.dst_nid, data.dst_tid, data.stream.get_buf(), data.stream.size());
+}
 
-    size_t data_sz = data.stream.size();
+bool RdmaMailbox::WriteSendBuf(int tid, int dst_nid, int dst_tid, const char* data, size_t data_sz) {
     uint64_t msg_sz = sizeof(uint64_t) + ceil(data_sz, sizeof(uint64_t)) + sizeof(uint64_t);
 
     rbf_rmeta_t *rmeta = &rmetas[GetIndex(dst_tid, dst_nid)];
@@ -148,7 +210,8 @@ bool RdmaMailbox::SendData(int tid, const mailbox_data_t& data) {
     *((uint64_t *)rdma_buf) = data_sz;  // header
     rdma_buf += sizeof(uint64_t);
 
-    memcpy(rdma_buf, data.stream.get_buf(), data_sz);    // data
+    if (data != nullptr)
+        memcpy(rdma_buf, data, data_sz);    // data
     rdma_buf += ceil(data_sz, sizeof(uint64_t));
 
     *((uint64_t*)rdma_buf) = data_sz;   // footer
@@ -173,7 +236,7 @@ void RdmaMailbox::Recv(int tid, Message & msg) {
         if (machine_id != node_.get_local_rank() && CheckRecvBuf(tid, machine_id)) {
             obinstream um;
             FetchMsgFromRecvBuf(tid, machine_id, um);
-            um >> msg;
+            MessageBatcher::Unpack(um, msg, recv_batches[tid]);
         }
     }
 }
@@ -183,12 +246,22 @@ bool RdmaMailbox::TryRecv(int tid, Message & msg) {
     pthread_spin_lock(&recv_locks[tid]);
     int type = (schedulers[tid].rr_cnt++) % rr_size;
 
+    // Messages of a received frame go first, to keep the order from the same sender
+    if (!recv_batches[tid].empty()) {
+        msg = move(recv_batches[tid].front());
+        recv_batches[tid].pop_front();
+        pthread_spin_unlock(&recv_locks[tid]);
+        return true;
+    }
+
     // Try local message queue in higher priority
     // Use round-robin to avoid starvation
     if (type != 0) {
-        if (local_msgs[tid]->Size() != 0) {
-            local_msgs[tid]->WaitAndPop(msg);
+        Message* local_msg;
+        if (local_msgs[tid]->TryPop(local_msg)) {
             pthread_spin_unlock(&recv_locks[tid]);
+            msg = move(*local_msg);
+            delete local_msg;
             return true;
         }
     }
@@ -199,9 +272,8 @@ bool RdmaMailbox::TryRecv(int tid, Message & msg) {
         if (machine_id != node_.get_local_rank() && CheckRecvBuf(tid, machine_id)) {
             obinstream um;
             FetchMsgFromRecvBuf(tid, machine_id, um);
+            MessageBatcher::Unpack(um, msg, recv_batches[tid]);
             pthread_spin_unlock(&recv_locks[tid]);
-
-            um >> msg;
             return true;
         }
     }
@@ -209,6 +281,18 @@ bool RdmaMailbox::TryRecv(int tid, Message & msg) {
     return false;
 }
 
+bool RdmaMailbox::HasMsg(int tid) {
+    SimpleSpinLockGuard lock_guard(&recv_locks[tid]);
+    if (!recv_batches[tid].empty() || !local_msgs[tid]->Empty())
+        return true;
+
+    for (int machine_id = 0; machine_id < node_.get_local_size(); machine_id++) {
+        if (machine_id != node_.get_local_rank() && CheckRecvBuf(tid, machine_id))
+            return true;
+    }
+    return false;
+}
+
 bool RdmaMailbox::CheckRecvBuf(int tid, int nid) {
     rbf_lmeta_t *lmeta = &lmetas[GetIndex(tid, nid)];
     char * rbf = buffer_->GetRecvBuf(tid, nid);
@@ -297,6 +381,10 @@ void RdmaMailbox::SendNotification(int dst_nid, ibinstream& in) {
     }
 }
 
+string RdmaMailbox::GetBatchStatistics() {
+    return batcher_->GetStatistics();
+}
+
 void RdmaMailbox::RecvNotification(obinstream& out) {
     RDMA &rdma = RDMA::get_rdma();
     int failed = 0;
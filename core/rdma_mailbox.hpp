@@ -15,6 +15,7 @@
 #pragma once
 
 #include <emmintrin.h>
+#include <deque>
 #include <vector>
 #include <string>
 #include <mutex>
@@ -23,10 +24,11 @@
 #include "core/message.hpp"
 #include "core/abstract_mailbox.hpp"
 #include "core/abstract_id_mapper.hpp"
+#include "core/message_batcher.hpp"
 #include "base/node.hpp"
 #include "base/rdma.hpp"
 #include "base/serialization.hpp"
-#include "base/thread_safe_queue.hpp"
+#include "base/mpsc_queue.hpp"
 #include "utils/config.hpp"
 #include "utils/global.hpp"
 #include "utils/simple_spinlock_guard.hpp"
@@ -48,18 +50,26 @@ class RdmaMailbox : public AbstractMailbox {
 
     // When sent to the same recv buffer, the consistency relies on
     // the lock in the id_mapper
-    int Send(int tid, const Message & msg) override;
+    using AbstractMailbox::Send;
+    int Send(int tid, Message && msg) override;
 
     void Recv(int tid, Message & msg) override;
 
     bool TryRecv(int tid, Message & msg) override;
 
-    void Sweep(int tid) override;
+    void Sweep(int tid, bool flush_all) override;
 
     void SendNotification(int dst_nid, ibinstream& in) override;
 
     void RecvNotification(obinstream& out) override;
 
+    string GetBatchStatistics() override;
+
+    bool HasMsg(int tid) override;
+
+ protected:
+    bool HasPendingSend(int tid) override { return pending_msgs[tid].size() != 0; }
+
  private:
     struct rbf_rmeta_t {
         uint64_t tail;  // write from here
@@ -91,7 +101,13 @@ class RdmaMailbox : public AbstractMailbox {
     bool CheckRecvBuf(int tid, int nid);
     void FetchMsgFromRecvBuf(int tid, int nid, obinstream & um);
     bool IsBufferFull(int dst_nid, int dst_tid, uint64_t tail, uint64_t msg_sz);
-    bool SendData(int tid, const mailbox_data_t& data);
+    bool SendData(int tid, mailbox_data_t& data);
+    // Write data of data_sz bytes with header and footer into the send buffer of tid, and then to the recv buffer.
+    // If data is nullptr, it is already serialized in the send buffer after the header.
+    // Return false if the recv buffer is full
+    bool WriteSendBuf(int tid, int dst_nid, int dst_tid, const char* data, size_t data_sz);
+    // Send a batched frame, or keep it in pending_msgs if the recv buffer is full
+    void SendFrame(int tid, int dst, ibinstream* frame);
 
     inline int GetIndex(int tid, int nid) {
         nid = nid < node_.get_local_rank() ? nid : nid - 1;
@@ -104,8 +120,14 @@ class RdmaMailbox : public AbstractMailbox {
 
     vector<vector<mailbox_data_t>> pending_msgs;
 
-    // Fail to use vector as copy constructors of ThreadSafeQueue are deleted
-    ThreadSafeQueue<Message>** local_msgs;
+    // Batches of remote messages, indexed by sender tid and dst (nid * global_num_threads + tid)
+    MessageBatcher* batcher_ = nullptr;
+    // Messages unpacked from received frames but not returned yet, protected by recv_locks
+    vector<std::deque<Message>> recv_batches;
+
+    // Messages to the local threads are handed off by pointer.
+    // Fail to use vector as copy constructors of MPSCQueue are deleted
+    MPSCQueue<Message*>** local_msgs;
 
     rbf_rmeta_t *rmetas = NULL;
     rbf_lmeta_t *lmetas = NULL;
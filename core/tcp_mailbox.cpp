@@ -26,11 +26,15 @@ TCPMailbox::~TCPMailbox() {
     }
 
     for (int i = 0; i < config_->global_num_threads; i++) {
+        Message* msg;
+        while (local_msgs[i]->TryPop(msg))
+            delete msg;
         delete local_msgs[i];
     }
 
     free(schedulers);
     free(local_msgs);
+    delete batcher_;
 }
 
 void TCPMailbox::Init(vector<Node> &nodes) {
@@ -83,6 +87,12 @@ void TCPMailbox::Init(vector<Node> &nodes) {
         DLOG(INFO) << "[TCPMailbox::Init] Worker " << my_node_.hostname << " binds " << string(addr);
     }
 
+    recv_fds_.resize(config_->global_num_threads);
+    for (int tid = 0; tid < config_->global_num_threads; tid++) {
+        size_t fd_sz = sizeof(recv_fds_[tid]);
+        receivers_[tid]->getsockopt(ZMQ_FD, &recv_fds_[tid], &fd_sz);
+    }
+
     locks = (pthread_spinlock_t *)malloc(
         sizeof(pthread_spinlock_t) *
         (config_->global_num_threads * config_->global_num_workers));
@@ -98,48 +108,84 @@ void TCPMailbox::Init(vector<Node> &nodes) {
     schedulers = (scheduler_t *)malloc(sizeof(scheduler_t) * config_->global_num_threads);
     memset(schedulers, 0, sizeof(scheduler_t) * config_->global_num_threads);
 
-    local_msgs = (ThreadSafeQueue<Message> **)malloc(sizeof(ThreadSafeQueue<Message>*) * config_->global_num_threads);
+    local_msgs = (MPSCQueue<Message*> **)malloc(sizeof(MPSCQueue<Message*>*) * config_->global_num_threads);
     for (int i = 0; i < config_->global_num_threads; i++) {
-        local_msgs[i] = new ThreadSafeQueue<Message>();
+        local_msgs[i] = new MPSCQueue<Message*>(LOCAL_QUEUE_CAPACITY);
     }
+    batcher_ = new MessageBatcher(config_->global_num_threads + Config::extra_send_buf_count,
+                                  config_->global_num_workers * config_->global_num_threads,
+                                  KiB2B(config_->global_msg_batch_sz_kb), config_->global_msg_batch_timeout_us);
+    recv_batches_.resize(config_->global_num_threads);
+    InitParker(config_->global_num_threads, true);
     rr_size = 3;
 
     pthread_spin_init(&send_notification_lock_, 0);
 }
 
-int TCPMailbox::Send(int tid, const Message & msg) {
+int TCPMailbox::Send(int tid, Message && msg) {
     if (msg.meta.recver_nid == my_node_.get_local_rank()) {
-        local_msgs[msg.meta.recver_tid]->Push(msg);
+        int recver_tid = msg.meta.recver_tid;
+        local_msgs[recver_tid]->Push(new Message(move(msg)));
+        WakeRecver(recver_tid);
+    } else if (batcher_->Enabled()) {
+        auto flush = [this](int pcode, ibinstream* frame) { SendFrame(pcode, frame); };
+        int pcode = port_code(msg.meta.recver_nid, msg.meta.recver_tid);
+        if (batcher_->Append(tid, pcode, msg))
+            batcher_->Flush(tid, pcode, MessageBatcher::SIZE, flush);
+        batcher_->FlushSender(tid, false, flush);
     } else {
         int pcode = port_code(msg.meta.recver_nid, msg.meta.recver_tid);
 
-        ibinstream m;
+        // Size the frame first, and then serialize into the zmq message directly
+        size_t frame_sz = sizeof(uint32_t) + serialized_size(msg);
+        zmq::message_t zmq_msg(frame_sz);
+        ibinstream m(static_cast<char*>(zmq_msg.data()), frame_sz);
+        MessageBatcher::WriteSingleHeader(m);
         m << msg;
+        CHECK(m.in_place() && m.size() == frame_sz);
+        batcher_->Record(tid, 1, frame_sz, MessageBatcher::UNBATCHED);
 
-        zmq::message_t zmq_msg(m.size());
-        memcpy((void *)zmq_msg.data(), m.get_buf(), m.size());
-
-        pthread_spin_lock(&locks[pcode]);
-        if (senders_.find(pcode) == senders_.end()) {
-            cout << "Cannot find dst_node port num" << endl;
-            pthread_spin_unlock(&locks[pcode]);
-            return 0;
-        }
+        SendFrame(pcode, zmq_msg);
+    }
+    return 0;
+}
 
-        senders_[pcode]->send(zmq_msg, ZMQ_DONTWAIT);
+void TCPMailbox::SendFrame(int pcode, zmq::message_t & zmq_msg) {
+    pthread_spin_lock(&locks[pcode]);
+    if (senders_.find(pcode) == senders_.end()) {
+        cout << "Cannot find dst_node port num" << endl;
         pthread_spin_unlock(&locks[pcode]);
+        return;
     }
+
+    senders_[pcode]->send(zmq_msg, ZMQ_DONTWAIT);
+    pthread_spin_unlock(&locks[pcode]);
+}
+
+void TCPMailbox::SendFrame(int pcode, ibinstream* frame) {
+    zmq::message_t zmq_msg(frame->get_buf(), frame->size(),
+                           [](void* data, void* hint) { delete static_cast<ibinstream*>(hint); }, frame);
+    SendFrame(pcode, zmq_msg);
 }
 
 bool TCPMailbox::TryRecv(int tid, Message & msg) {
     SimpleSpinLockGuard lock_guard(recv_locks_ + tid);
     int type = (schedulers[tid].rr_cnt++) % rr_size;
 
+    // Messages of a received frame go first, to keep the order from the same sender
+    if (!recv_batches_[tid].empty()) {
+        msg = move(recv_batches_[tid].front());
+        recv_batches_[tid].pop_front();
+        return true;
+    }
+
     // Try local message queue in higher priority
     // Use round-robin to avoid starvation
     if (type != 0) {
-        if (local_msgs[tid]->Size() != 0) {
-            local_msgs[tid]->WaitAndPop(msg);
+        Message* local_msg;
+        if (local_msgs[tid]->TryPop(local_msg)) {
+            msg = move(*local_msg);
+            delete local_msg;
             return true;
         }
     }
@@ -161,7 +207,7 @@ bool TCPMailbox::TryRecv(int tid, Message & msg) {
         char* buf = new char[zmq_msg.size()];
         memcpy(buf, zmq_msg.data(), zmq_msg.size());
         um.assign(buf, zmq_msg.size(), 0);
-        um >> msg;
+        MessageBatcher::Unpack(um, msg, recv_batches_[tid]);
         return true;
     }
     return false;
@@ -186,4 +232,22 @@ void TCPMailbox::RecvNotification(obinstream &out) {
 }
 
 void TCPMailbox::Recv(int tid, Message & msg) { return; }
-void TCPMailbox::Sweep(int tid) { return; }
+void TCPMailbox::Sweep(int tid, bool flush_all) {
+    batcher_->FlushSender(tid, flush_all, [this](int pcode, ibinstream* frame) { SendFrame(pcode, frame); });
+}
+
+bool TCPMailbox::HasMsg(int tid) {
+    // The lock also serializes the access to the zmq socket of tid
+    SimpleSpinLockGuard lock_guard(recv_locks_ + tid);
+    if (!recv_batches_[tid].empty() || !local_msgs[tid]->Empty())
+        return true;
+
+    int events = 0;
+    size_t events_sz = sizeof(events);
+    receivers_[tid]->getsockopt(ZMQ_EVENTS, &events, &events_sz);
+    return events & ZMQ_POLLIN;
+}
+
+string TCPMailbox::GetBatchStatistics() {
+    return batcher_->GetStatistics();
+}
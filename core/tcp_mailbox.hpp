@@ -19,6 +19,7 @@
 #include <string.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <unistd.h>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -27,8 +28,9 @@
 #include <vector>
 
 #include "base/node_util.hpp"
-#include "base/thread_safe_queue.hpp"
+#include "base/mpsc_queue.hpp"
 #include "core/abstract_mailbox.hpp"
+#include "core/message_batcher.hpp"
 #include "core/message.hpp"
 #include "utils/simple_spinlock_guard.hpp"
 #include "utils/zmq.hpp"
@@ -43,6 +45,8 @@ class TCPMailbox : public AbstractMailbox {
     // The communication over zeromq, a socket library.
     zmq::context_t context;
     socket_vector receivers_;
+    // ZMQ_FD of receivers_, readable when msgs may have arrived
+    vector<int> recv_fds_;
     socket_map senders_;
 
     Node & my_node_;
@@ -58,7 +62,8 @@ class TCPMailbox : public AbstractMailbox {
     scheduler_t *schedulers;
     pthread_spinlock_t *recv_locks_ = nullptr;
 
-    ThreadSafeQueue<Message>** local_msgs;
+    // Messages to the local threads are handed off by pointer
+    MPSCQueue<Message*>** local_msgs;
 
     // round-robin size for choosing local or remote msg
     // TODO(nick): Move to config
@@ -66,12 +71,24 @@ class TCPMailbox : public AbstractMailbox {
 
     inline int port_code (int nid, int tid) { return nid * config_->global_num_threads + tid; }
 
+    // Batches of remote messages, indexed by sender tid and dst port_code
+    MessageBatcher* batcher_ = nullptr;
+    // Messages unpacked from received frames but not returned yet, protected by recv_locks_
+    vector<std::deque<Message>> recv_batches_;
+
+    void SendFrame(int pcode, zmq::message_t & zmq_msg);
+    // Send a batched frame without copy, the frame is deleted by zmq after sent
+    void SendFrame(int pcode, ibinstream* frame);
+
     // additional sockets for other commun channels, mapping to SendNotification(), RecvNotification()
     socket_vector notification_senders_;
     zmq::socket_t* notificaton_receiver_;
 
     pthread_spinlock_t send_notification_lock_;
 
+ protected:
+    int GetRecvFd(int tid) override { return recv_fds_[tid]; }
+
  public:
     TCPMailbox(Node & my_node) : my_node_(my_node), context(1) {
         config_ = Config::GetInstance();
@@ -80,10 +97,13 @@ class TCPMailbox : public AbstractMailbox {
     ~TCPMailbox();
 
     void Init(vector<Node> & nodes) override;
-    int Send(int tid, const Message & msg) override;
+    using AbstractMailbox::Send;
+    int Send(int tid, Message && msg) override;
     void Recv(int tid, Message & msg) override;
     bool TryRecv(int tid, Message & msg) override;
-    void Sweep(int tid) override;
+    void Sweep(int tid, bool flush_all) override;
     void SendNotification(int dst_nid, ibinstream& in) override;
     void RecvNotification(obinstream& out) override;
+    string GetBatchStatistics() override;
+    bool HasMsg(int tid) override;
 };
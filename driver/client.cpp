@@ -202,6 +202,7 @@ void Client::print_display_status_help() {
     cout << "Available status keys:" << endl;
     cout << "    mem: Display memory info of containers " << endl;
     cout << "    gc: Display dependent gc tasks' status " << endl;
+    cout << "    mailbox: Display batching statistics of remote messages " << endl;
     cout << endl;
     cout << "Example:" << endl;
     cout << "    gtran -q DisplayStatus(mem)" << endl;
@@ -731,9 +731,9 @@ class Worker {
             pkg.qplan,
             msgs);
         for (int i = 0 ; i < my_node_.get_local_size(); i++) {
-            mailbox_->Send(mailbox_tid, msgs[i]);
+            mailbox_->Send(mailbox_tid, move(msgs[i]));
         }
-        mailbox_->Sweep(mailbox_tid);
+        mailbox_->Sweep(mailbox_tid, true);
     }
 
     // For non-readonly transaction, need to fetch trans(trx_ids) from RCT from all workers,
@@ -1055,6 +1055,12 @@ class Worker {
 
         // =================DataStorage=====================
         data_storage_ = DataStorage::GetInstance();
+        if (config_->global_enable_numa_pool) {
+            vector<int> thread_nodes;
+            for (int tid = 0; tid < config_->global_num_threads; tid++)
+                thread_nodes.emplace_back(core_affinity_->GetNodeOfThread(tid));
+            data_storage_->SetThreadNodes(thread_nodes);
+        }
         data_storage_->Init();
 
         // =================IndexStorage=====================
@@ -41,6 +41,8 @@ class AbstractExpert {
     virtual bool valid(uint64_t TrxID, vector<Expert_Object*> & step_index_list,
                        const vector<rct_extract_data_t> & check_set) {}
     virtual void clean_trx_data(uint64_t TrxID) {}
+    // whether process() can take msg with col_data, otherwise msg is converted to row data before process()
+    virtual bool SupportColumnData() { return false; }
 
  protected:
     // Data Storage
@@ -86,6 +86,6 @@ void AddEdgeExpert::process(const QueryPlan & qplan, Message & msg) {
         msg.CreateAbortMsg(qplan.experts, msg_vec, abort_info);
     }
     for (auto& msg : msg_vec) {
-        mailbox_->Send(tid, msg);
+        mailbox_->Send(tid, move(msg));
     }
 }
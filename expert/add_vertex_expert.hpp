@@ -56,12 +56,12 @@ class AddVertexExpert : public AbstractExpert {
         pmt_rct_table_->InsertRecentActionSet(Primitive_T::IV, qplan.trxid, update_data);
 
         // Insert update data to topo index
-        index_store_->InsertToUpdateBuffer(qplan.trxid, update_data, ID_T::VID, true);
+        index_store_->InsertToUpdateBuffer(qplan.trxid, update_data, ID_T::VID, true, NULL, NULL, lid);
 
         vector<Message> msg_vec;
         msg.CreateNextMsg(qplan.experts, msg.data, num_thread_, core_affinity_, msg_vec);
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -93,7 +93,7 @@ class AddVertexExpert : public AbstractExpert {
             for (auto & vertex : pair.second) {
                 vid_t new_v_id = data_storage_->ProcessAddV(label_id, qplan.trxid, qplan.st);
                 value_t new_val;
-                Tool::str2int(to_string(new_v_id.value()), new_val);
+                Tool::int2value_t(new_v_id.value(), new_val);
                 newData.emplace_back(new_val);
 
                 uint64_t rct_insert_val = static_cast<uint64_t>(vid_t2uint(new_v_id));
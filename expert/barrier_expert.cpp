@@ -42,8 +42,14 @@ void EndExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
                             std::make_move_iterator(pair.second.end()));
             }
 
-            if (isReady)
+            if (isReady) {
+                // clients have no string_dict
+                for (auto& val : data) {
+                    if (val.type == DictCodeValueType)
+                        string_dict::GetInstance()->Decode(val);
+                }
                 rc_->InsertResult(msg.meta.qid, data);
+            }
         }
     }
 }
@@ -89,7 +95,7 @@ void AggregateExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
         }
 
         for (auto& m : v) {
-            mailbox_->Send(tid, m);
+            mailbox_->Send(tid, move(m));
         }
     }
 }
@@ -145,7 +151,7 @@ void CapExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -177,7 +183,7 @@ void CountExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
         vector<pair<history_t, vector<value_t>>> msg_data;
         for (auto& p : counter_map) {
             value_t v;
-            Tool::str2int(to_string(p.second.second), v);
+            Tool::int2value_t(p.second.second, v);
             msg_data.emplace_back(move(p.second.first), vector<value_t>{move(v)});
         }
 
@@ -187,7 +193,7 @@ void CountExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -274,7 +280,7 @@ void DedupExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -293,24 +299,24 @@ void GroupExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
     // process msg data
     for (auto& p : msg.data) {
         // Get projected key if any
-        value_t k;
-        string key;
-        if (get_history_value(p.first, label_step, k)) {
-            key = k.DebugString();
+        value_t key;
+        if (!get_history_value(p.first, label_step, key)) {
+            Tool::str2str("", key);
         }
 
         int branch_value = get_branch_value(p.first, branch_key);
 
-        // get <history_t, map<string, vector<value_t>> pair by branch_value
+        // get <history_t, unordered_map<value_t, vector<value_t>> pair by branch_value
         auto itr_data = data_map.find(branch_value);
         if (itr_data == data_map.end()) {
-            itr_data = data_map.insert(itr_data, {branch_value, {move(p.first), map<string, vector<value_t>>()}});
+            itr_data = data_map.insert(itr_data,
+                {branch_value, {move(p.first), unordered_map<value_t, vector<value_t>, ValueTHash>()}});
         }
         auto& map_ = itr_data->second.second;
 
         for (auto& val : p.second) {
             if (label_step == -1) {
-                key = val.DebugString();
+                key = val;
             }
             map_[key].push_back(move(val));
         }
@@ -326,19 +332,28 @@ void GroupExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             // max msg size - sizeof(data_vec) - sizeof(current history) - sizeof(empty value_t)
             size_t max_size = msg.max_data_size - MemSize(msg_data) - MemSize(p.second.first) - MemSize(value_t());
 
-            vector<value_t> vec_val;
+            // decode keys only once, and output them in string order
+            vector<pair<string, vector<value_t>*>> items;
             for (auto& item : p.second.second) {
+                items.emplace_back(item.first.DebugString(), &item.second);
+            }
+            sort(items.begin(), items.end(),
+                [](const pair<string, vector<value_t>*>& l, const pair<string, vector<value_t>*>& r)
+                    { return l.first < r.first; });
+
+            vector<value_t> vec_val;
+            for (auto& item : items) {
                 string map_string;
                 // construct string
                 if (isCount) {
-                    map_string = item.first + ":" + to_string(item.second.size());
+                    map_string = item.first + ":" + to_string(item.second->size());
                 } else {
                     map_string = item.first + ":[";
-                    for (auto& v : item.second) {
+                    for (auto& v : *item.second) {
                         map_string += v.DebugString() + ", ";
                     }
                     // remove trailing ", "
-                    if (item.second.size() > 0) {
+                    if (item.second->size() > 0) {
                         map_string.pop_back();
                         map_string.pop_back();
                     }
@@ -366,7 +381,7 @@ void GroupExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -455,7 +470,7 @@ void OrderExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -488,7 +503,7 @@ void PostValidationExpert::do_work(int tid, const QueryPlan & qplan, Message & m
         msg.CreateBroadcastMsg(msg_type, num_nodes_, vec);
         for (auto& m : vec) {
             m.data = msg_data;
-            mailbox_->Send(tid, m);
+            mailbox_->Send(tid, move(m));
         }
     }
 }
@@ -571,7 +586,7 @@ void RangeExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -654,7 +669,7 @@ void CoinExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -716,7 +731,7 @@ void MathExpert::do_work(int tid, const QueryPlan & qplan, Message & msg,
             vector<Message> v;
             msg.CreateNextMsg(qplan.experts, msg_data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
@@ -732,7 +747,7 @@ void MathExpert::sum(BarrierData::math_meta_t& data, value_t& v) {
     data.value.content.clear();
     switch (v.type) {
       case 1:
-        Tool::str2int(to_string(Tool::value_t2int(temp) + Tool::value_t2int(v)), data.value);
+        Tool::int2value_t(Tool::value_t2int(temp) + Tool::value_t2int(v), data.value);
         break;
       case 2:
         Tool::str2double(to_string(Tool::value_t2double(temp) + Tool::value_t2double(v)), data.value);
@@ -233,8 +233,9 @@ struct group_data : barrier_data_base {
     // int: assigned branch value by labelled branch step
     // pair:
     //        history_t:                 histroy of data
-    //        map<string,value_t>:    record key and values of grouped data
-    unordered_map<int, pair<history_t, map<string, vector<value_t>>>> data_map;
+    //        unordered_map<value_t,value_t>:    record key and values of grouped data,
+    //                                           keys in string_dict are compared as codes
+    unordered_map<int, pair<history_t, unordered_map<value_t, vector<value_t>, ValueTHash>>> data_map;
 };
 }  // namespace BarrierData
 
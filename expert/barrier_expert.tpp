@@ -50,7 +50,7 @@ void BarrierExpertBase<T>::process(const QueryPlan & qplan, Message & msg) {
             if (qplan.experts[msg.meta.step].expert_type == EXPERT_T::COUNT) {
                 for (auto& p : msg.data) {
                     value_t v;
-                    Tool::str2int(to_string(p.second.size()), v);
+                    Tool::int2value_t(p.second.size(), v);
                     p.second.clear();
                     p.second.push_back(move(v));
                 }
@@ -59,7 +59,7 @@ void DropExpert::process(const QueryPlan & qplan, Message & msg) {
 
     // Send Message
     for (auto& msg : msg_vec) {
-        mailbox_->Send(tid, msg);
+        mailbox_->Send(tid, move(msg));
     }
 }
 
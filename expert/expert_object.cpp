@@ -18,7 +18,7 @@
 
 void Expert_Object::AddParam(int key) {
     value_t v;
-    Tool::str2int(to_string(key), v);
+    Tool::int2value_t(key, v);
     params.push_back(move(v));
 }
 
@@ -34,7 +34,7 @@ bool Expert_Object::AddParam(string s) {
 
 bool Expert_Object::ModifyParam(int key, int index) {
     value_t v;
-    Tool::str2int(to_string(key), v);
+    Tool::int2value_t(key, v);
     if (index < params.size()) {
         params[index] = move(v);
     } else {
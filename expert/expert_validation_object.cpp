@@ -45,6 +45,18 @@ void ExpertValidationObject::RecordInputSetValueT(uint64_t TransactionID, int st
     RecordInputSet(TransactionID, step_num, transformedInput, recordALL);
 }
 
+void ExpertValidationObject::RecordInputSetValueT(uint64_t TransactionID, int step_num, const value_column_t & input_set, bool recordALL) {
+    // raw cells of a column are vids or eids already
+    vector<uint64_t> transformedInput;
+    if (!recordALL) {  // Unnecessary to transfer when recording all
+        transformedInput.reserve(input_set.size());
+        for (size_t i = 0; i < input_set.size(); i++) {
+            transformedInput.emplace_back(input_set.at(i));
+        }
+    }
+    RecordInputSet(TransactionID, step_num, transformedInput, recordALL);
+}
+
 void ExpertValidationObject::RecordInputSet(uint64_t TransactionID, int step_num, const vector<uint64_t> & input_set, bool recordALL) {
     // Get TrxStepKey
     validation_record_key_t key(TransactionID, step_num);
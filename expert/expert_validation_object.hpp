@@ -33,6 +33,7 @@ class ExpertValidationObject {
     ExpertValidationObject() {}
 
     void RecordInputSetValueT(uint64_t TransactionID, int step_num, Element_T data_type, const vector<value_t> & input_set, bool recordALL);
+    void RecordInputSetValueT(uint64_t TransactionID, int step_num, const value_column_t & input_set, bool recordALL);
     void RecordInputSet(uint64_t TransactionID, int step_num, const vector<uint64_t> & input_set, bool recordALL);
 
     // Return Value :
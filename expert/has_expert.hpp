@@ -73,11 +73,17 @@ class HasExpert : public AbstractExpert {
         Element_T inType = (Element_T) Tool::value_t2int(expert_obj.params.at(0));
         int numParamsGroup = (expert_obj.params.size() - 1) / 3;  // number of groups of params
 
+        // Input is ids, filter them in columnar form
+        msg.ToColumnData();
+
         if (qplan.trx_type != TRX_READONLY && config_->isolation_level == ISOLATION_LEVEL::SERIALIZABLE) {
             // Record Input Set
             for (auto & data_pair : msg.data) {
                 v_obj.RecordInputSetValueT(qplan.trxid, expert_obj.index, inType, data_pair.second, m.step == 1 ? true : false);
             }
+            for (auto & data_pair : msg.col_data) {
+                v_obj.RecordInputSetValueT(qplan.trxid, expert_obj.index, data_pair.second, m.step == 1 ? true : false);
+            }
         }
 
         // Create predicate chain for this query
@@ -88,6 +94,7 @@ class HasExpert : public AbstractExpert {
             Predicate_T pred_type = (Predicate_T) Tool::value_t2int(expert_obj.params.at(pos + 1));
             vector<value_t> pred_params;
             Tool::value_t2vec(expert_obj.params.at(pos + 2), pred_params);
+            EncodeDictStrings(pred_type, pred_params);
             pred_chain.emplace_back(pid, PredicateValue(pred_type, pred_params));
         }
 
@@ -95,9 +102,11 @@ class HasExpert : public AbstractExpert {
         switch (inType) {
           case Element_T::VERTEX:
             EvaluateVertex(qplan, msg.data, pred_chain, read_success);
+            EvaluateVertex(qplan, msg.col_data, pred_chain, read_success);
             break;
           case Element_T::EDGE:
             EvaluateEdge(qplan, msg.data, pred_chain, read_success);
+            EvaluateEdge(qplan, msg.col_data, pred_chain, read_success);
             break;
           default:
             cout << "Wrong inType" << endl;
@@ -105,7 +114,9 @@ class HasExpert : public AbstractExpert {
 
         // Create Message
         vector<Message> msg_vec;
-        if (read_success) {
+        if (read_success && msg.IsColumnar()) {
+            msg.CreateNextMsg(qplan.experts, msg.col_data, num_thread_, core_affinity_, msg_vec);
+        } else if (read_success) {
             msg.CreateNextMsg(qplan.experts, msg.data, num_thread_, core_affinity_, msg_vec);
         } else {
             string abort_info = "Abort with [Processing][HasExpert::process]";
@@ -114,7 +125,7 @@ class HasExpert : public AbstractExpert {
 
         // Send Message
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -151,6 +162,8 @@ class HasExpert : public AbstractExpert {
 
     void clean_trx_data(uint64_t TrxID) { v_obj.DeleteInputSet(TrxID); }
 
+    bool SupportColumnData() { return true; }
+
  private:
     // Number of Threads
     int num_thread_;
@@ -166,139 +179,222 @@ class HasExpert : public AbstractExpert {
     // Validation Store
     ExpertValidationObject v_obj;
 
+    // Replace strings in string_dict by their codes, so that collection predicates
+    // compare codes with stored codes instead of looking up their strings.
+    // Scalar params are already encoded once per query by the parser, while collection params
+    // are packed into one value_t which cannot hold codes, and are encoded here
+    void EncodeDictStrings(Predicate_T pred_type, vector<value_t> & pred_params) {
+        string_dict* dict = string_dict::GetInstance();
+        if (dict->code2str.empty())
+            return;
+
+        bool is_set = (pred_type == Predicate_T::WITHIN || pred_type == Predicate_T::WITHOUT);
+        bool is_range = (pred_type == Predicate_T::INSIDE || pred_type == Predicate_T::OUTSIDE ||
+                         pred_type == Predicate_T::BETWEEN);
+        if (!is_set && !(is_range && dict->order_preserving))
+            return;
+
+        for (auto & param : pred_params) {
+            value_t code;
+            if (dict->Encode(param, code))
+                param = move(code);
+        }
+    }
+
     void EvaluateVertex(const QueryPlan & qplan, vector<pair<history_t, vector<value_t>>> & data,
             const vector<pair<int, PredicateValue>> & pred_chain, bool & read_success) {
-        auto checkFunction = [&](value_t& value){
-            if (!read_success) { return false; }
-            vid_t v_id(Tool::value_t2int(value));
-            vector<pair<label_t, value_t>> vp_kv_pair_list;
-            READ_STAT read_status = data_storage_->GetAllVP(v_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, vp_kv_pair_list);
-            if (read_status == READ_STAT::ABORT) {
+        vector<vid_t> vids;
+        vector<bool> filtered_out;
+        for (auto & data_pair : data) {
+            vids.clear();
+            for (auto & value : data_pair.second) {
+                vids.emplace_back(Tool::value_t2int(value));
+            }
+
+            if (!VertexFilteredOut(qplan, vids, pred_chain, filtered_out)) {
                 read_success = false;
-                return false;
-            } else if (read_status == READ_STAT::NOTFOUND) {
-                return true;  // Erase
+                return;
             }
 
-            for (auto & pred_pair : pred_chain) {
-                int pid = pred_pair.first;
-                PredicateValue pred = pred_pair.second;
+            int i = 0;
+            auto checkFunction = [&](value_t & value) { return filtered_out[i++]; };
+            data_pair.second.erase(remove_if(data_pair.second.begin(), data_pair.second.end(), checkFunction), data_pair.second.end());
+        }
+    }
 
-                if (pid == -1) {
-                    int counter = vp_kv_pair_list.size();
-                    for (auto & pair : vp_kv_pair_list) {
-                        if (!Evaluate(pred, &(pair.second))) {
-                            counter--;
-                        }
-                    }
+    void EvaluateVertex(const QueryPlan & qplan, vector<pair<history_t, value_column_t>> & data,
+            const vector<pair<int, PredicateValue>> & pred_chain, bool & read_success) {
+        vector<vid_t> vids;
+        vector<bool> filtered_out;
+        for (auto & data_pair : data) {
+            vids.clear();
+            for (size_t i = 0; i < data_pair.second.size(); i++) {
+                vids.emplace_back(static_cast<int>(data_pair.second.at(i)));
+            }
 
-                    // Cannot match all properties, erase
-                    if (counter == 0) {
-                        return true;
-                    }
-                } else {
-                    // Check whether key exists for this vtx
-                    int counter = vp_kv_pair_list.size();
-                    value_t val;
-                    for (auto pair : vp_kv_pair_list) {
-                        if (pid == pair.first) {
-                            val = pair.second;
-                            break;
-                        } else {
-                            counter--;
-                        }
-                    }
+            if (!VertexFilteredOut(qplan, vids, pred_chain, filtered_out)) {
+                read_success = false;
+                return;
+            }
 
-                    if (counter == 0) {
-                        if (pred.pred_type == Predicate_T::NONE)
-                            continue;
-                        return true;
-                    }
+            int i = 0;
+            data_pair.second.remove_if([&](uint64_t raw) { return filtered_out[i++]; });
+        }
+    }
 
-                    if (pred.pred_type == Predicate_T::ANY)
-                        continue;
+    // Evaluate a batch of vertices, filtered_out[i] is true if vids[i] should be erased
+    // return false if abort
+    bool VertexFilteredOut(const QueryPlan & qplan, const vector<vid_t> & vids,
+            const vector<pair<int, PredicateValue>> & pred_chain, vector<bool> & filtered_out) {
+        vector<label_t> key_list;
+        GetKeyList(pred_chain, key_list);
+
+        vector<pair<label_t, value_t>> vp_kv_pair_list;
+        vector<size_t> offsets;
+        vector<bool> found;
+        READ_STAT read_status = data_storage_->GetVPBatch(vids, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY,
+                                                          vp_kv_pair_list, offsets, found);
+        if (read_status == READ_STAT::ABORT) {
+            return false;
+        }
 
-                    // Erase when doesnt match
-                    if (!Evaluate(pred, &val)) {
-                        return true;
-                    }
-                }
+        filtered_out.resize(vids.size());
+        for (int i = 0; i < vids.size(); i++) {
+            // Erase invisible vertices
+            filtered_out[i] = !found[i] || PropertiesFilteredOut(pred_chain, vp_kv_pair_list, offsets[i], offsets[i + 1]);
+        }
+        return true;
+    }
+
+    void EvaluateEdge(const QueryPlan & qplan, vector<pair<history_t, vector<value_t>>> & data,
+            const vector<pair<int, PredicateValue>> & pred_chain, bool & read_success) {
+        vector<eid_t> eids;
+        vector<bool> filtered_out;
+        for (auto & data_pair : data) {
+            eids.clear();
+            for (auto & value : data_pair.second) {
+                eid_t e_id;
+                uint2eid_t(Tool::value_t2uint64_t(value), e_id);
+                eids.emplace_back(e_id);
             }
 
-            return false;
-        };
+            if (!EdgeFilteredOut(qplan, eids, pred_chain, filtered_out)) {
+                read_success = false;
+                return;
+            }
 
-        for (auto & data_pair : data) {
+            int i = 0;
+            auto checkFunction = [&](value_t & value) { return filtered_out[i++]; };
             data_pair.second.erase(remove_if(data_pair.second.begin(), data_pair.second.end(), checkFunction), data_pair.second.end());
         }
     }
 
-    void EvaluateEdge(const QueryPlan & qplan, vector<pair<history_t, vector<value_t>>> & data,
+    void EvaluateEdge(const QueryPlan & qplan, vector<pair<history_t, value_column_t>> & data,
             const vector<pair<int, PredicateValue>> & pred_chain, bool & read_success) {
-        auto checkFunction = [&](value_t& value){
-            if (!read_success) { return false; }
-            eid_t e_id;
-            uint2eid_t(Tool::value_t2uint64_t(value), e_id);
-            vector<pair<label_t, value_t>> ep_kv_pair_list;
-            READ_STAT read_status = data_storage_->GetAllEP(e_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, ep_kv_pair_list);
-            if (read_status == READ_STAT::ABORT) {
+        vector<eid_t> eids;
+        vector<bool> filtered_out;
+        for (auto & data_pair : data) {
+            eids.clear();
+            for (size_t i = 0; i < data_pair.second.size(); i++) {
+                eid_t e_id;
+                uint2eid_t(data_pair.second.at(i), e_id);
+                eids.emplace_back(e_id);
+            }
+
+            if (!EdgeFilteredOut(qplan, eids, pred_chain, filtered_out)) {
                 read_success = false;
-                return false;
-            } else if (read_status == READ_STAT::NOTFOUND) {
-                return true;  // Erase
+                return;
             }
 
-            for (auto & pred_pair : pred_chain) {
-                int pid = pred_pair.first;
-                PredicateValue pred = pred_pair.second;
+            int i = 0;
+            data_pair.second.remove_if([&](uint64_t raw) { return filtered_out[i++]; });
+        }
+    }
+
+    // Evaluate a batch of edges, filtered_out[i] is true if eids[i] should be erased
+    // return false if abort
+    bool EdgeFilteredOut(const QueryPlan & qplan, const vector<eid_t> & eids,
+            const vector<pair<int, PredicateValue>> & pred_chain, vector<bool> & filtered_out) {
+        vector<label_t> key_list;
+        GetKeyList(pred_chain, key_list);
+
+        vector<pair<label_t, value_t>> ep_kv_pair_list;
+        vector<size_t> offsets;
+        vector<bool> found;
+        READ_STAT read_status = data_storage_->GetEPBatch(eids, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY,
+                                                          ep_kv_pair_list, offsets, found);
+        if (read_status == READ_STAT::ABORT) {
+            return false;
+        }
 
-                if (pid == -1) {
-                    int counter = ep_kv_pair_list.size();
-                    for (auto & pair : ep_kv_pair_list) {
-                        if (!Evaluate(pred, &(pair.second))) {
-                            counter--;
-                        }
-                    }
+        filtered_out.resize(eids.size());
+        for (int i = 0; i < eids.size(); i++) {
+            // Erase invisible edges
+            filtered_out[i] = !found[i] || PropertiesFilteredOut(pred_chain, ep_kv_pair_list, offsets[i], offsets[i + 1]);
+        }
+        return true;
+    }
 
-                    // Cannot match all properties, erase
-                    if (counter == 0) {
-                        return true;
-                    }
-                } else {
-                    // Check whether key exists for this vtx
-                    int counter = ep_kv_pair_list.size();
-                    value_t val;
-                    for (auto pair : ep_kv_pair_list) {
-                        if (pid == pair.first) {
-                            val = pair.second;
-                            break;
-                        } else {
-                            counter--;
-                        }
+    // Keys to read for pred_chain, empty for all properties (pid == -1 is on any property)
+    void GetKeyList(const vector<pair<int, PredicateValue>> & pred_chain, vector<label_t> & key_list) {
+        for (auto & pred_pair : pred_chain) {
+            if (pred_pair.first == -1) {
+                key_list.clear();
+                return;
+            }
+            label_t key = static_cast<label_t>(pred_pair.first);
+            if (find(key_list.begin(), key_list.end(), key) == key_list.end()) {
+                key_list.emplace_back(key);
+            }
+        }
+    }
+
+    // return true if the element with properties kv_pair_list[begin, end) should be erased
+    bool PropertiesFilteredOut(const vector<pair<int, PredicateValue>> & pred_chain,
+            const vector<pair<label_t, value_t>> & kv_pair_list, size_t begin, size_t end) {
+        for (auto & pred_pair : pred_chain) {
+            int pid = pred_pair.first;
+            PredicateValue pred = pred_pair.second;
+
+            if (pid == -1) {
+                int counter = end - begin;
+                for (size_t i = begin; i < end; i++) {
+                    if (!Evaluate(pred, &(kv_pair_list[i].second))) {
+                        counter--;
                     }
+                }
 
-                    if (counter == 0) {
-                        if (pred.pred_type == Predicate_T::NONE)
-                            continue;
-                        return true;
+                // Cannot match all properties, erase
+                if (counter == 0) {
+                    return true;
+                }
+            } else {
+                // Check whether key exists for this element
+                const value_t* val = nullptr;
+                for (size_t i = begin; i < end; i++) {
+                    if (pid == kv_pair_list[i].first) {
+                        val = &(kv_pair_list[i].second);
+                        break;
                     }
+                }
 
-                    if (pred.pred_type == Predicate_T::ANY)
+                if (val == nullptr) {
+                    if (pred.pred_type == Predicate_T::NONE)
                         continue;
-
-                    // Erase when doesnt match
-                    if (!Evaluate(pred, &val)) {
-                        return true;
-                    }
+                    return true;
                 }
-            }
 
-            return false;
-        };
+                if (pred.pred_type == Predicate_T::ANY)
+                    continue;
 
-        for (auto & data_pair : data) {
-            data_pair.second.erase(remove_if(data_pair.second.begin(), data_pair.second.end(), checkFunction), data_pair.second.end());
+                // Erase when doesnt match
+                if (!Evaluate(pred, val)) {
+                    return true;
+                }
+            }
         }
+
+        return false;
     }
 };
 
@@ -58,11 +58,17 @@ class HasLabelExpert : public AbstractExpert {
         CHECK(expert_obj.params.size() > 1);
         Element_T inType = (Element_T) Tool::value_t2int(expert_obj.params.at(0));
 
+        // Input is ids, filter them in columnar form
+        msg.ToColumnData();
+
         if (qplan.trx_type != TRX_READONLY && config_->isolation_level == ISOLATION_LEVEL::SERIALIZABLE) {
             // Record Input Set
             for (auto & data_pair : msg.data) {
                 v_obj.RecordInputSetValueT(qplan.trxid, expert_obj.index, inType, data_pair.second, m.step == 1 ? true : false);
             }
+            for (auto & data_pair : msg.col_data) {
+                v_obj.RecordInputSetValueT(qplan.trxid, expert_obj.index, data_pair.second, m.step == 1 ? true : false);
+            }
         }
 
         vector<label_t> lid_list;
@@ -75,16 +81,20 @@ class HasLabelExpert : public AbstractExpert {
         switch (inType) {
           case Element_T::VERTEX:
             VertexHasLabel(qplan, lid_list, msg.data, read_success);
+            VertexHasLabel(qplan, lid_list, msg.col_data, read_success);
             break;
           case Element_T::EDGE:
             EdgeHasLabel(qplan, lid_list, msg.data, read_success);
+            EdgeHasLabel(qplan, lid_list, msg.col_data, read_success);
             break;
           default:
             cout << "Wrong in type"  << endl;
         }
         // Create Message
         vector<Message> msg_vec;
-        if (read_success) {
+        if (read_success && msg.IsColumnar()) {
+            msg.CreateNextMsg(qplan.experts, msg.col_data, num_thread_, core_affinity_, msg_vec);
+        } else if (read_success) {
             msg.CreateNextMsg(qplan.experts, msg.data, num_thread_, core_affinity_, msg_vec);
         } else {
             string abort_info = "Abort with [Processing][HasLabelExpert::process]";
@@ -93,7 +103,7 @@ class HasLabelExpert : public AbstractExpert {
 
         // Send Message
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -123,6 +133,8 @@ class HasLabelExpert : public AbstractExpert {
 
     void clean_trx_data(uint64_t TrxID) { v_obj.DeleteInputSet(TrxID); }
 
+    bool SupportColumnData() { return true; }
+
  private:
     // Number of Threads
     int num_thread_;
@@ -139,59 +151,82 @@ class HasLabelExpert : public AbstractExpert {
     ExpertValidationObject v_obj;
 
     void VertexHasLabel(const QueryPlan & qplan, vector<label_t> lid_list, vector<pair<history_t, vector<value_t>>> & data, bool & read_success) {
-        auto checkFunction = [&](value_t & value) {
-            if (!read_success) { return false; }
-            vid_t v_id(Tool::value_t2int(value));
-
-            label_t label;
-            READ_STAT read_status = data_storage_->GetVL(v_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, label);
-            if (read_status == READ_STAT::ABORT) {
-                read_success = false;
-                return false;
-            } else if (read_status == READ_STAT::NOTFOUND) {
-                return true;  // Erase
-            }
-
-            for (auto & lid : lid_list) {
-                if (lid == label) {
-                    return false;
-                }
-            }
-            return true;
-        };
-
         for (auto & data_pair : data) {
+            auto checkFunction = [&](value_t & value) {
+                return VertexFilteredOut(qplan, vid_t(Tool::value_t2int(value)), lid_list, read_success);
+            };
             data_pair.second.erase(remove_if(data_pair.second.begin(), data_pair.second.end(), checkFunction), data_pair.second.end());
         }
     }
 
-    void EdgeHasLabel(const QueryPlan & qplan, vector<label_t> lid_list, vector<pair<history_t, vector<value_t>>> & data, bool & read_success) {
-        auto checkFunction = [&](value_t & value) {
-            if (!read_success) { return false; }
-            eid_t e_id;
-            uint2eid_t(Tool::value_t2uint64_t(value), e_id);
-
-            label_t label;
-            READ_STAT read_status = data_storage_->GetEL(e_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, label);
-            if (read_status == READ_STAT::ABORT) {
-                read_success = false;
-                return false;
-            } else if (read_status == READ_STAT::NOTFOUND) {
-                return true;  // Erase
-            }
+    void VertexHasLabel(const QueryPlan & qplan, vector<label_t> lid_list, vector<pair<history_t, value_column_t>> & data, bool & read_success) {
+        for (auto & data_pair : data) {
+            data_pair.second.remove_if([&](uint64_t raw) {
+                return VertexFilteredOut(qplan, vid_t(static_cast<int>(raw)), lid_list, read_success);
+            });
+        }
+    }
 
-            for (auto & lid : lid_list) {
-                if (lid == label) {
-                    return false;
-                }
+    // return true if the element should be erased
+    bool VertexFilteredOut(const QueryPlan & qplan, vid_t v_id, const vector<label_t> & lid_list, bool & read_success) {
+        if (!read_success) { return false; }
+
+        label_t label;
+        READ_STAT read_status = data_storage_->GetVL(v_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, label);
+        if (read_status == READ_STAT::ABORT) {
+            read_success = false;
+            return false;
+        } else if (read_status == READ_STAT::NOTFOUND) {
+            return true;  // Erase
+        }
+
+        for (auto & lid : lid_list) {
+            if (lid == label) {
+                return false;
             }
-            return true;
-        };
+        }
+        return true;
+    }
 
+    void EdgeHasLabel(const QueryPlan & qplan, vector<label_t> lid_list, vector<pair<history_t, vector<value_t>>> & data, bool & read_success) {
         for (auto & data_pair : data) {
+            auto checkFunction = [&](value_t & value) {
+                return EdgeFilteredOut(qplan, Tool::value_t2uint64_t(value), lid_list, read_success);
+            };
             data_pair.second.erase(remove_if(data_pair.second.begin(), data_pair.second.end(), checkFunction), data_pair.second.end());
         }
     }
+
+    void EdgeHasLabel(const QueryPlan & qplan, vector<label_t> lid_list, vector<pair<history_t, value_column_t>> & data, bool & read_success) {
+        for (auto & data_pair : data) {
+            data_pair.second.remove_if([&](uint64_t raw) {
+                return EdgeFilteredOut(qplan, raw, lid_list, read_success);
+            });
+        }
+    }
+
+    // return true if the element should be erased
+    bool EdgeFilteredOut(const QueryPlan & qplan, uint64_t eid_value, const vector<label_t> & lid_list, bool & read_success) {
+        if (!read_success) { return false; }
+        eid_t e_id;
+        uint2eid_t(eid_value, e_id);
+
+        label_t label;
+        READ_STAT read_status = data_storage_->GetEL(e_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, label);
+        if (read_status == READ_STAT::ABORT) {
+            read_success = false;
+            return false;
+        } else if (read_status == READ_STAT::NOTFOUND) {
+            return true;  // Erase
+        }
+
+        for (auto & lid : lid_list) {
+            if (lid == label) {
+                return false;
+            }
+        }
+        return true;
+    }
 };
 
 #endif  // EXPERT_HAS_LABEL_EXPERT_HPP_
@@ -78,7 +78,7 @@ class IndexExpert : public AbstractExpert {
 
         // Send Message
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -113,7 +113,7 @@ class IndexExpert : public AbstractExpert {
             if (pid == 0) {
                 label_t label;
                 data_storage_->GetVL(vid, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, label);
-                Tool::str2int(to_string(label), val);
+                Tool::int2value_t(label, val);
                 index_map[val].push_back(move(vtx));
             } else {
                 vpid_t vp_id(vid, pid);
@@ -150,7 +150,7 @@ class IndexExpert : public AbstractExpert {
             if (pid == 0) {
                 label_t label;
                 data_storage_->GetEL(eid, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, label);
-                Tool::str2int(to_string(label), val);
+                Tool::int2value_t(label, val);
                 index_map[val].push_back(move(edge));
             } else {
                 epid_t ep_id(eid, pid);
@@ -63,8 +63,14 @@ class InitExpert : public AbstractExpert {
         bool next_count = qplan.experts[msg.meta.step + 1].expert_type == EXPERT_T::COUNT;
 
         vector<pair<history_t, vector<value_t>>> init_data;
+        vector<label_t> lid_list;
         if (with_input) {
             InitWithInput(tid, qplan.experts, init_data, msg, next_count);
+        } else if (expert_obj.params.size() == 2 && CanMergeHasLabel(qplan, msg.meta.step, lid_list)) {
+            // g.V().hasLabel(...): read from the label index and skip HasLabelExpert
+            // a following count() is applied by Message::DispatchData, since the previous step is HasLabel
+            msg.meta.step = expert_obj.next_expert;
+            InitWithLabelIndex(qplan, lid_list, init_data);
         } else if (expert_obj.params.size() == 2) {
             InitWithoutIndex(tid, qplan, init_data, msg, next_count);
         } else {
@@ -80,7 +86,7 @@ class InitExpert : public AbstractExpert {
         vector<Message> msg_vec;
         msg.CreateNextMsg(qplan.experts, init_data, num_thread_, core_affinity_, msg_vec);
         for (auto & msg_ : msg_vec) {
-            mailbox_->Send(tid, msg_);
+            mailbox_->Send(tid, move(msg_));
         }
     }
 
@@ -206,18 +212,59 @@ class InitExpert : public AbstractExpert {
 
         if (next_count) {
             value_t v; 
-            Tool::str2int(to_string(count), v);
+            Tool::int2value_t(count, v);
             init_data[0].second.emplace_back(v);
         } else {
             for (auto& vid : vid_list) {
                 value_t v;
-                Tool::str2int(to_string(vid.value()), v);
+                Tool::int2value_t(vid.value(), v);
                 init_data[0].second.emplace_back(v);
             }
         }
         vector<vid_t>().swap(vid_list);
     }
 
+    // Check if the next step is a vertex HasLabel that can be answered by IndexStore::ReadVtxLabelIndex
+    bool CanMergeHasLabel(const QueryPlan& qplan, int step, vector<label_t>& lid_list) {
+        if (!config_->global_enable_indexing)
+            return false;
+        // HasLabelExpert records input set for validation
+        if (qplan.trx_type != TRX_READONLY && config_->isolation_level == ISOLATION_LEVEL::SERIALIZABLE)
+            return false;
+
+        const Expert_Object& expert_obj = qplan.experts[step];
+        if ((Element_T)Tool::value_t2int(expert_obj.params.at(0)) != Element_T::VERTEX)
+            return false;
+        if (expert_obj.next_expert != step + 1 || step + 2 >= qplan.experts.size())
+            return false;
+
+        const Expert_Object& next_obj = qplan.experts[step + 1];
+        if (next_obj.expert_type != EXPERT_T::HASLABEL || next_obj.next_expert != step + 2)
+            return false;
+        if ((Element_T)Tool::value_t2int(next_obj.params.at(0)) != Element_T::VERTEX)
+            return false;
+
+        for (int pos = 1; pos < next_obj.params.size(); pos++) {
+            lid_list.emplace_back(static_cast<label_t>(Tool::value_t2int(next_obj.params.at(pos))));
+        }
+        return true;
+    }
+
+    void InitWithLabelIndex(const QueryPlan& qplan, const vector<label_t>& lid_list,
+                            vector<pair<history_t, vector<value_t>>> & init_data) {
+        vector<vid_t> vid_list;
+        index_store_->ReadVtxLabelIndex(qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, lid_list, vid_list);
+
+        init_data.clear();
+        init_data.emplace_back(history_t(), vector<value_t>());
+        init_data[0].second.reserve(vid_list.size());
+        for (auto& vid : vid_list) {
+            value_t v;
+            Tool::int2value_t(vid.value(), v);
+            init_data[0].second.emplace_back(v);
+        }
+    }
+
     void InitEdgeData(const Meta& m, const QueryPlan& qplan, vector<pair<history_t, vector<value_t>>>& init_data, bool & next_count) {
         vector<eid_t> eid_list;
         uint64_t start_time = timer::get_usec();
@@ -237,12 +284,12 @@ class InitExpert : public AbstractExpert {
 
         if (next_count) {
             value_t v; 
-            Tool::str2int(to_string(count), v);
+            Tool::int2value_t(count, v);
             init_data[0].second.emplace_back(v);
         } else {
             for (auto& eid : eid_list) {
                 value_t v;
-                Tool::str2uint64_t(to_string(eid.value()), v);
+                Tool::uint64_t2value_t(eid.value(), v);
                 init_data[0].second.push_back(v);
             }
         }
@@ -265,7 +312,7 @@ class InitExpert : public AbstractExpert {
             init_data[0].second.clear();
 
             value_t v;
-            Tool::str2int(to_string(size), v);
+            Tool::int2value_t(size, v);
             init_data[0].second.emplace_back(v);
         }
     }
@@ -305,7 +352,7 @@ class InitExpert : public AbstractExpert {
             init_data[0].second.clear();
 
             value_t v;
-            Tool::str2int(to_string(size), v);
+            Tool::int2value_t(size, v);
             init_data[0].second.emplace_back(v);
         }
     }
@@ -153,7 +153,7 @@ class LabelledBranchExpertBase :  public AbstractExpert {
         vector<Message> msg_vec;
         msg.CreateBranchedMsgWithHisLabel(experts, step_vec, msg_id, num_thread_, core_affinity_, msg_vec);
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -305,7 +305,7 @@ class BranchFilterExpert : public LabelledBranchExpertBase<BranchData::branch_fi
             vector<Message> v;
             msg.CreateNextMsg(experts, data, num_thread_, core_affinity_, v);
             for (auto& m : v) {
-                mailbox_->Send(tid, m);
+                mailbox_->Send(tid, move(m));
             }
         }
     }
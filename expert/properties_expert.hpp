@@ -84,7 +84,7 @@ class PropertiesExpert : public AbstractExpert {
 
         // Send Message
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -135,33 +135,35 @@ class PropertiesExpert : public AbstractExpert {
 
     bool get_properties_for_vertex(const QueryPlan & qplan, int tid, const vector<label_t> & key_list,
                                    vector<pair<history_t, vector<value_t>>>& data) {
+        vector<vid_t> vids;
+        vector<std::pair<label_t, value_t>> vp_kv_pair_list;
+        vector<size_t> offsets;
+        vector<bool> found;
         for (auto & pair : data) {
             PushToRWRecord(qplan.trxid, pair.second.size(), true);
             vector<std::pair<uint64_t, string>> result;
             vector<value_t> newData;
 
+            vids.clear();
+            vp_kv_pair_list.clear();
             for (auto & value : pair.second) {
-                vid_t v_id(Tool::value_t2int(value));
-
-                vector<std::pair<label_t, value_t>> vp_kv_pair_list;
-                READ_STAT read_status;
-                if (key_list.empty()) {
-                    read_status = data_storage_->GetAllVP(v_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, vp_kv_pair_list);
-                } else {
-                    read_status = data_storage_->GetVPByPKeyList(v_id, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, vp_kv_pair_list);
-                }
+                vids.emplace_back(Tool::value_t2int(value));
+            }
 
-                if (read_status == READ_STAT::ABORT) {
-                    return false;
-                } else if (read_status == READ_STAT::NOTFOUND) {
-                    continue;
-                }
+            // empty key_list means all properties
+            READ_STAT read_status = data_storage_->GetVPBatch(vids, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY,
+                                                              vp_kv_pair_list, offsets, found);
+            if (read_status == READ_STAT::ABORT) {
+                return false;
+            }
 
-                for (auto vp_kv_pair : vp_kv_pair_list) {
+            for (int i = 0; i < vids.size(); i++) {
+                for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+                    auto & vp_kv_pair = vp_kv_pair_list[j];
                     string keyStr;
                     data_storage_->GetNameFromIndex(Index_T::V_PROPERTY, vp_kv_pair.first, keyStr);
 
-                    vpid_t vpid(v_id, vp_kv_pair.first);
+                    vpid_t vpid(vids[i], vp_kv_pair.first);
                     string result_value = "{" + keyStr + ":" + vp_kv_pair.second.DebugString() + "}";
                     result.emplace_back(vpid.value(), result_value);
                 }
@@ -175,35 +177,36 @@ class PropertiesExpert : public AbstractExpert {
 
     bool get_properties_for_edge(const QueryPlan & qplan, int tid, const vector<label_t> & key_list,
                                  vector<pair<history_t, vector<value_t>>>& data) {
+        vector<eid_t> eids;
+        vector<std::pair<label_t, value_t>> ep_kv_pair_list;
+        vector<size_t> offsets;
+        vector<bool> found;
         for (auto & pair : data) {
             PushToRWRecord(qplan.trxid, pair.second.size(), true);
             vector<std::pair<uint64_t, string>> result;
             vector<value_t> newData;
 
+            eids.clear();
+            ep_kv_pair_list.clear();
             for (auto & value : pair.second) {
                 eid_t e_id;
                 uint2eid_t(Tool::value_t2uint64_t(value), e_id);
+                eids.emplace_back(e_id);
+            }
 
-                vector<std::pair<label_t, value_t>> ep_kv_pair_list;
-                READ_STAT read_status;
-                if (key_list.empty()) {
-                    // read all properties
-                    read_status = data_storage_->GetAllEP(e_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, ep_kv_pair_list);
-                } else {
-                    read_status = data_storage_->GetEPByPKeyList(e_id, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, ep_kv_pair_list);
-                }
-
-                if (read_status == READ_STAT::ABORT) {
-                    return false;
-                } else if (read_status == READ_STAT::NOTFOUND) {
-                    continue;
-                }
+            READ_STAT read_status = data_storage_->GetEPBatch(eids, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY,
+                                                              ep_kv_pair_list, offsets, found);
+            if (read_status == READ_STAT::ABORT) {
+                return false;
+            }
 
-                for (auto ep_kv_pair : ep_kv_pair_list) {
+            for (int i = 0; i < eids.size(); i++) {
+                for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+                    auto & ep_kv_pair = ep_kv_pair_list[j];
                     string keyStr;
                     data_storage_->GetNameFromIndex(Index_T::E_PROPERTY, ep_kv_pair.first, keyStr);
 
-                    epid_t epid(e_id, ep_kv_pair.first);
+                    epid_t epid(eids[i], ep_kv_pair.first);
                     string result_value = "{" + keyStr + ":" + ep_kv_pair.second.DebugString() + "}";
                     result.emplace_back(epid.value(), result_value);
                 }
@@ -33,6 +33,8 @@ void StatusExpert::process(const QueryPlan & qplan, Message & msg) {
         ret = data_storage_->GetContainerUsageString();
     } else if (status_key == "gc") {
         ret = GarbageCollector::GetInstance()->GetDepGCTaskStatusStatistics();
+    } else if (status_key == "mailbox") {
+        ret = mailbox_->GetBatchStatistics();
     } else {
         // undefined status key
         ret = "[Error] Invalid status key \"" + status_key;
@@ -51,6 +53,6 @@ void StatusExpert::process(const QueryPlan & qplan, Message & msg) {
 
     // Send Message
     for (auto& msg : msg_vec) {
-        mailbox_->Send(tid, msg);
+        mailbox_->Send(tid, move(msg));
     }
 }
@@ -63,7 +63,7 @@ void TerminateExpert::process(const QueryPlan & qplan, Message & msg) {
     msg.meta.recver_tid = msg.meta.parent_tid;
     msg.data.clear();
     msg.data.emplace_back(history_t(), vector<value_t>{move(result)});
-    mailbox_->Send(tid, msg);
+    mailbox_->Send(tid, move(msg));
 }
 
 void TerminateExpert::prepare_clean_expert_set() {
@@ -67,41 +67,35 @@ class TraversalExpert : public AbstractExpert {
         // Parser treat -1 as empty input, while DataStorage is 0 since it use label_t (uint16_t)
         lid = (lid == -1) ? 0 : lid;
 
+        // Input and output are ids, so they are always processed in columnar form
+        bool columnar = msg.ToColumnData();
+        CHECK(columnar) << "TraversalExpert expects vertex or edge ids as input";
+
         if (qplan.trx_type != TRX_READONLY && config_->isolation_level == ISOLATION_LEVEL::SERIALIZABLE) {
             // Record Input Set
-            for (auto & data_pair : msg.data) {
-                v_obj.RecordInputSetValueT(qplan.trxid, expert_obj.index, inType, data_pair.second, m.step == 1 ? true : false);
+            for (auto & data_pair : msg.col_data) {
+                v_obj.RecordInputSetValueT(qplan.trxid, expert_obj.index, data_pair.second, m.step == 1 ? true : false);
                 PushToRWRecord(qplan.trxid, data_pair.second.size(), true);
             }
         }
 
         // Get Result
         bool read_success = true;
-        if (inType == Element_T::VERTEX) {
-            if (outType == Element_T::VERTEX) {
-                read_success = GetNeighborOfVertex(qplan, lid, dir, msg.data);
-            } else if (outType == Element_T::EDGE) {
-                read_success = GetEdgeOfVertex(qplan, lid, dir, msg.data);
-            } else {
-                cout << "Wrong Out Element Type: " << outType << endl;
-                return;
-            }
-        } else if (inType == Element_T::EDGE) {
-            if (outType == Element_T::VERTEX) {
-                GetVertexOfEdge(lid, dir, msg.data);
-            } else {
-                cout << "Wrong Out Element Type: " << outType << endl;
-                return;
-            }
+        if (inType == Element_T::VERTEX && outType == Element_T::VERTEX) {
+            read_success = GetNeighborOfVertex(qplan, lid, dir, msg.col_data);
+        } else if (inType == Element_T::VERTEX && outType == Element_T::EDGE) {
+            read_success = GetEdgeOfVertex(qplan, lid, dir, msg.col_data);
+        } else if (inType == Element_T::EDGE && outType == Element_T::VERTEX) {
+            GetVertexOfEdge(lid, dir, msg.col_data);
         } else {
-            cout << "Wrong In Element Type: " << inType << endl;
+            cout << "Wrong Element Type: " << inType << " -> " << outType << endl;
             return;
         }
 
         // Create Message
         vector<Message> msg_vec;
         if (read_success) {
-            msg.CreateNextMsg(qplan.experts, msg.data, num_thread_, core_affinity_, msg_vec);
+            msg.CreateNextMsg(qplan.experts, msg.col_data, num_thread_, core_affinity_, msg_vec);
         } else {
             string abort_info = "Abort with [Processing][TraversalExpert::process]";
             msg.CreateAbortMsg(qplan.experts, msg_vec, abort_info);
@@ -109,7 +103,7 @@ class TraversalExpert : public AbstractExpert {
 
         // Send Message
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -140,6 +134,8 @@ class TraversalExpert : public AbstractExpert {
 
     void clean_trx_data(uint64_t TrxID) { v_obj.DeleteInputSet(TrxID); }
 
+    bool SupportColumnData() { return true; }
+
  private:
     // Number of Threads
     int num_thread_;
@@ -155,91 +151,82 @@ class TraversalExpert : public AbstractExpert {
     ExpertValidationObject v_obj;
 
     // ============Vertex===============
-    // Get IN/OUT/BOTH of Vertex
-    bool GetNeighborOfVertex(const QueryPlan & qplan, int lid, Direction_T dir, vector<pair<history_t, vector<value_t>>> & data) {
+    // Get IN/OUT/BOTH of Vertex, vids and eids stay packed from input to output
+    bool GetNeighborOfVertex(const QueryPlan & qplan, int lid, Direction_T dir, vector<pair<history_t, value_column_t>> & data) {
+        vector<vid_t> vids;
+        vector<vid_t> v_nbs;
         for (auto& pair : data) {
-            vector<value_t> newData;
-
-            for (auto & value : pair.second) {
-                // Get the current vertex id and use it to get vertex instance
-                vid_t cur_vtx_id(Tool::value_t2int(value));
-                vector<vid_t> v_nbs;
-                READ_STAT read_status = data_storage_->
-                                        GetConnectedVertexList(cur_vtx_id, lid, dir, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, v_nbs);
-                if (read_status == READ_STAT::ABORT) {
-                    return false;
-                } else if (read_status == READ_STAT::NOTFOUND) {
-                    continue;
-                }
+            vids.clear();
+            v_nbs.clear();
+            for (size_t i = 0; i < pair.second.size(); i++) {
+                vids.emplace_back(static_cast<int>(pair.second.at(i)));
+            }
 
-                for (auto & neighbor : v_nbs) {
-                    value_t new_value;
-                    Tool::str2int(to_string(neighbor.value()), new_value);
-                    newData.push_back(new_value);
-                }
+            READ_STAT read_status = data_storage_->
+                                    GetConnectedVertexListBatch(vids, lid, dir, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, v_nbs);
+            if (read_status == READ_STAT::ABORT) {
+                return false;
+            }
+
+            value_column_t newData(IntValueType);
+            newData.reserve(v_nbs.size());
+            for (auto & neighbor : v_nbs) {
+                newData.push_back(neighbor.value());
             }
 
             // Replace pair.second with new data
-            pair.second.swap(newData);
+            pair.second = move(newData);
         }
         return true;
     }
 
     // Get IN/OUT/BOTH-E of Vertex
-    bool GetEdgeOfVertex(const QueryPlan & qplan, int lid, Direction_T dir, vector<pair<history_t, vector<value_t>>> & data) {
+    bool GetEdgeOfVertex(const QueryPlan & qplan, int lid, Direction_T dir, vector<pair<history_t, value_column_t>> & data) {
+        vector<vid_t> vids;
+        vector<eid_t> e_nbs;
         for (auto& pair : data) {
-            vector<value_t> newData;
-
-            for (auto & value : pair.second) {
-                // Get the current vertex id and use it to get vertex instance
-                vid_t cur_vtx_id(Tool::value_t2int(value));
-                vector<eid_t> e_nbs;
-                READ_STAT read_status = data_storage_->
-                                        GetConnectedEdgeList(cur_vtx_id, lid, dir, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, e_nbs);
-                if (read_status == READ_STAT::ABORT) {
-                    return false;
-                } else if (read_status == READ_STAT::NOTFOUND) {
-                    continue;
-                }
+            vids.clear();
+            e_nbs.clear();
+            for (size_t i = 0; i < pair.second.size(); i++) {
+                vids.emplace_back(static_cast<int>(pair.second.at(i)));
+            }
 
-                for (auto & neighbor : e_nbs) {
-                    value_t new_value;
-                    Tool::str2uint64_t(to_string(neighbor.value()), new_value);
-                    newData.push_back(new_value);
-                }
+            READ_STAT read_status = data_storage_->
+                                    GetConnectedEdgeListBatch(vids, lid, dir, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, e_nbs);
+            if (read_status == READ_STAT::ABORT) {
+                return false;
+            }
+
+            value_column_t newData(UintValueType);
+            newData.reserve(e_nbs.size());
+            for (auto & neighbor : e_nbs) {
+                newData.push_back(neighbor.value());
             }
 
             // Replace pair.second with new data
-            pair.second.swap(newData);
+            pair.second = move(newData);
         }
         return true;
     }
 
     // =============Edge================
-    void GetVertexOfEdge(int lid, Direction_T dir, vector<pair<history_t, vector<value_t>>> & data) {
+    void GetVertexOfEdge(int lid, Direction_T dir, vector<pair<history_t, value_column_t>> & data) {
         for (auto & pair : data) {
-            vector<value_t> newData;
+            value_column_t newData(IntValueType);
+            newData.reserve(dir == Direction_T::BOTH ? pair.second.size() * 2 : pair.second.size());
 
-            for (auto & value : pair.second) {
-                uint64_t eid_value = Tool::value_t2uint64_t(value);
+            for (size_t i = 0; i < pair.second.size(); i++) {
+                uint64_t eid_value = pair.second.at(i);
                 uint64_t dst_v = eid_value >> VID_BITS;
                 uint64_t src_v = eid_value - (dst_v << VID_BITS);
 
                 if (dir == Direction_T::IN) {
-                    value_t new_value;
-                    Tool::str2int(to_string(dst_v), new_value);
-                    newData.push_back(new_value);
+                    newData.push_back(dst_v);
                 } else if (dir == Direction_T::OUT) {
-                    value_t new_value;
-                    Tool::str2int(to_string(src_v), new_value);
-                    newData.push_back(new_value);
+                    newData.push_back(src_v);
                 } else if (dir == Direction_T::BOTH) {
-                    value_t new_value_in;
-                    value_t new_value_out;
-                    Tool::str2int(to_string(dst_v), new_value_in);
-                    Tool::str2int(to_string(src_v), new_value_out);
-                    newData.push_back(new_value_in);
-                    newData.push_back(new_value_out);
+                    newData.push_back(dst_v);
+                    newData.push_back(src_v);
                 } else {
                     cout << "Wrong Direction Type" << endl;
                     return;
@@ -247,7 +234,7 @@ class TraversalExpert : public AbstractExpert {
             }
 
             // Replace pair.second with new data
-            pair.second.swap(newData);
+            pair.second = move(newData);
         }
     }
 };
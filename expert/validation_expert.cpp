@@ -30,7 +30,7 @@ void ValidationExpert::process(const QueryPlan & qplan, Message & msg) {
         // Send Message
         for (auto& msg : msg_vec) {
             msg.meta.msg_type = MSG_T::COMMIT;
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
 
         return;
@@ -91,7 +91,7 @@ void ValidationExpert::process(const QueryPlan & qplan, Message & msg) {
     // Send Message
     for (auto& msg : msg_vec) {
         msg.meta.msg_type = isAbort ? MSG_T::ABORT : MSG_T::COMMIT;
-        mailbox_->Send(tid, msg);
+        mailbox_->Send(tid, move(msg));
     }
 }
 
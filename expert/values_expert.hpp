@@ -83,7 +83,7 @@ class ValuesExpert : public AbstractExpert {
 
         // Send Message
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
@@ -133,29 +133,28 @@ class ValuesExpert : public AbstractExpert {
     ExpertValidationObject v_obj;
 
     bool get_properties_for_vertex(const QueryPlan & qplan, const vector<label_t> & key_list, vector<pair<history_t, vector<value_t>>>& data) {
+        vector<vid_t> vids;
+        vector<std::pair<label_t, value_t>> vp_kv_pair_list;
+        vector<size_t> offsets;
+        vector<bool> found;
         for (auto & pair : data) {
-            vector<value_t> newData;
-
+            vids.clear();
+            vp_kv_pair_list.clear();
             for (auto & value : pair.second) {
-                vid_t v_id(Tool::value_t2int(value));
-                vector<std::pair<label_t, value_t>> vp_kv_pair_list;
-
-                READ_STAT read_status;
-                if (key_list.empty()) {
-                    read_status = data_storage_->GetAllVP(v_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, vp_kv_pair_list);
-                } else {
-                    read_status = data_storage_->GetVPByPKeyList(v_id, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, vp_kv_pair_list);
-                }
+                vids.emplace_back(Tool::value_t2int(value));
+            }
 
-                if (read_status == READ_STAT::ABORT) {
-                    return false;
-                } else if (read_status == READ_STAT::NOTFOUND) {
-                    continue;
-                }
+            // empty key_list means all properties
+            READ_STAT read_status = data_storage_->GetVPBatch(vids, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY,
+                                                              vp_kv_pair_list, offsets, found);
+            if (read_status == READ_STAT::ABORT) {
+                return false;
+            }
 
-                for (auto vp_kv_pair : vp_kv_pair_list) {
-                    newData.emplace_back(vp_kv_pair.second);
-                }
+            vector<value_t> newData;
+            newData.reserve(vp_kv_pair_list.size());
+            for (auto & vp_kv_pair : vp_kv_pair_list) {
+                newData.emplace_back(move(vp_kv_pair.second));
             }
             pair.second.swap(newData);
         }
@@ -163,30 +162,29 @@ class ValuesExpert : public AbstractExpert {
     }
 
     bool get_properties_for_edge(const QueryPlan & qplan, const vector<label_t> & key_list, vector<pair<history_t, vector<value_t>>>& data) {
+        vector<eid_t> eids;
+        vector<std::pair<label_t, value_t>> ep_kv_pair_list;
+        vector<size_t> offsets;
+        vector<bool> found;
         for (auto & pair : data) {
-            vector<value_t> newData;
-
+            eids.clear();
+            ep_kv_pair_list.clear();
             for (auto & value : pair.second) {
                 eid_t e_id;
                 uint2eid_t(Tool::value_t2uint64_t(value), e_id);
-                vector<std::pair<label_t, value_t>> ep_kv_pair_list;
-
-                READ_STAT read_status;
-                if (key_list.empty()) {
-                    read_status = data_storage_->GetAllEP(e_id, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, ep_kv_pair_list);
-                } else {
-                    read_status = data_storage_->GetEPByPKeyList(e_id, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY, ep_kv_pair_list);
-                }
+                eids.emplace_back(e_id);
+            }
 
-                if (read_status == READ_STAT::ABORT) {
-                    return false;
-                } else if (read_status == READ_STAT::NOTFOUND) {
-                    continue;
-                }
+            READ_STAT read_status = data_storage_->GetEPBatch(eids, key_list, qplan.trxid, qplan.st, qplan.trx_type == TRX_READONLY,
+                                                              ep_kv_pair_list, offsets, found);
+            if (read_status == READ_STAT::ABORT) {
+                return false;
+            }
 
-                for (auto ep_kv_pair : ep_kv_pair_list) {
-                    newData.emplace_back(ep_kv_pair.second);
-                }
+            vector<value_t> newData;
+            newData.reserve(ep_kv_pair_list.size());
+            for (auto & ep_kv_pair : ep_kv_pair_list) {
+                newData.emplace_back(move(ep_kv_pair.second));
             }
             pair.second.swap(newData);
         }
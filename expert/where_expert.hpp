@@ -81,7 +81,7 @@ class WhereExpert : public AbstractExpert {
 
                     if (!HasAggregateData(agg_t(m.qid, his_label), tmp_agg_data)) {
                         msg.meta.recver_tid = msg.meta.parent_tid;
-                        mailbox_->Send(tid, msg);
+                        mailbox_->Send(tid, move(msg));
                         return;
                     }
 
@@ -111,7 +111,7 @@ class WhereExpert : public AbstractExpert {
 
         // Send Message
         for (auto& msg : msg_vec) {
-            mailbox_->Send(tid, msg);
+            mailbox_->Send(tid, move(msg));
         }
     }
 
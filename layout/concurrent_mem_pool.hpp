@@ -25,12 +25,21 @@
 #include <mm_malloc.h>
 #endif  // defined(__GNUC__)
 
+#include <algorithm>
 #include <atomic>
 #include <cstdio>
+#include <limits>
 #include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "utils/huge_page_util.hpp"
+#include "utils/numa_util.hpp"
 
 constexpr int CONCURRENT_MEM_POOL_DEFAULT_BLOCK_SIZE = 2048;  // 2K
 constexpr int CONCURRENT_MEM_POOL_ARRAY_MEMORY_ALIGNMENT = 4096;  // 4KB
+// By default, a pool can grow up to (CONCURRENT_MEM_POOL_DEFAULT_MAX_SEGMENT_COUNT * initial cell_count) cells
+constexpr int CONCURRENT_MEM_POOL_DEFAULT_MAX_SEGMENT_COUNT = 8;
 
 /*
 ConcurrentMemPool is a high-throughput multi-thread container for allocating objects.
@@ -62,6 +71,23 @@ Thus, ConcurrentMemPool needs to address the 2 abovementioned problems.:
         (4). If a thread-local block holds more than 2 * BLOCK_SIZE objects, it will free BLOCK_SIZE objects to the shared block (lock required).
         (5). If a thread-local block has no objects available, it will get BLOCK_SIZE objects from the shared block (lock required).
         (6). Only (4) and (5) requires lock, ensuring high throughput.
+    3. To avoid sizing each pool for the worst case, the pool is growable:
+        (1). When memory is allocated by the pool, address space for max_segment_count segments is reserved
+             with mmap(MAP_NORESERVE), and each segment holds the initial cell_count cells.
+             Only the first segment is initialized, pages of other segments are not backed until they are used.
+             If huge_page is true, the reserved space is advised as transparent huge pages, to reduce TLB misses.
+        (2). When the shared block cannot serve (5), the next segment is initialized and appended to the shared block.
+             Since segments are contiguous in the reserved address space, offsets and pointers of existing objects are stable.
+        (3). The shared block counts its cells in each segment. Once all cells of a grown segment are back in the shared block,
+             no thread holds any of them, and pages of the segment are returned to the system (madvise(MADV_DONTNEED)).
+             The segment stays in the free list, and its pages are backed again when its cells are fetched.
+             The high-water mark (the peak count of objects fetched from the shared block) is recorded to size the pool.
+    4. In NUMA mode (numa_aware == true on a machine with more than one node):
+        (1). The reserved address space is split into one arena per node, and pages of an arena prefer its node (mbind).
+             Each arena has its own shared block, and grows by segments independently.
+        (2). Each thread has one thread-local block per node. Get() fetches from the block of the node set by SetNode(),
+             by default the node where the thread is running at the first Get() of the tid.
+             Free() returns the object to the block of the node owning the object, thus free lists never mix nodes.
 -----------------------------------------------------------------------------------
 Usage:
     1. Use Get() to allocate an object, Free() to free the allocated object.
@@ -88,23 +114,57 @@ class ConcurrentMemPool {
         size_t cell_count: The capacity of ConcurrentMemPool
         int nthreads: The count of thread that will use this ConcurrentMemPool
         bool utilization_record_: If true, the count of got and free cells will be recorded.
+        bool numa_aware: If true, cells are split into per-node arenas. Ignored if mem is provided.
+        bool huge_page: If true, memory allocated by the pool is backed by huge pages when possible.
+        int max_segment_count: The pool can grow up to max_segment_count * cell_count cells. Ignored if mem is provided.
     */
-    void Init(CellT* mem, size_t cell_count, int nthreads, bool utilization_record);
+    void Init(CellT* mem, size_t cell_count, int nthreads, bool utilization_record, bool numa_aware, bool huge_page,
+              int max_segment_count);
 
     bool mem_allocated_ __attribute__((aligned(16))) = false;
     CellT* attached_mem_ __attribute__((aligned(16))) = nullptr;
     OffsetT* next_offset_ __attribute__((aligned(16))) = nullptr;
 
-    OffsetT cell_count_;
+    // Count of cells in a segment, i.e., the initial cell_count of an arena
+    OffsetT segment_size_;
+    // Count of cells reserved for each arena, equal to segment_size_ if mem is not allocated by the pool
+    OffsetT arena_cell_count_;
+    size_t reserved_bytes_;
+    size_t next_offset_bytes_ = 0;
     int nthreads_;
+    int node_count_;
     bool utilization_record_;
 
-    // Next avaliable cell index, modified in Get()
-    OffsetT head_ __attribute__((aligned(64)));
-    // Last avaliable cell index, modified in Free()
-    OffsetT tail_ __attribute__((aligned(64)));
+    // The shared block of an arena
+    struct SharedBlock {
+        // Next avaliable cell index, modified in Get()
+        OffsetT head __attribute__((aligned(64)));
+        // Last avaliable cell index, modified in Free()
+        OffsetT tail;
+        // End of initialized segments in this arena, modified in Grow()
+        OffsetT cell_end;
+        // Count of cells in the shared block, and the high-water mark of cells fetched from it
+        OffsetT free_count;
+        OffsetT high_water_mark;
+        // Count of cells in the shared block of each segment, and whether the pages of each segment have been released
+        std::vector<OffsetT> segment_free_count;
+        std::vector<bool> segment_released;
+        int released_count;
+        pthread_spinlock_t lock;
+    } __attribute__((aligned(64)));
+
+    SharedBlock* shared_blocks_;
+
+    // Initialize the next segment of the arena and append it to the shared block, called with the lock held
+    void Grow(SharedBlock& shared_block, int node);
+
+    // Index of the segment holding the cell in the arena of node
+    inline int GetSegment(OffsetT offset, int node) const __attribute__((always_inline)) {
+        return (offset - arena_cell_count_ * node) / segment_size_;
+    }
 
-    pthread_spinlock_t lock_ __attribute__((aligned(64)));
+    // Return the pages of segment to the system, called with the lock held when all its cells are in the shared block
+    void TryReleaseSegment(SharedBlock& shared_block, int node, int segment);
 
     struct ThreadLocalBlock {
         OffsetT block_head __attribute__((aligned(16)));
@@ -115,16 +175,28 @@ class ConcurrentMemPool {
 
     static_assert(sizeof(ThreadLocalBlock) % 64 == 0, "concurrent_mem_pool.hpp, sizeof(ThreadLocalBlock) % 64 != 0");
 
+    // thread_local_block_[tid * node_count_ + node]
     ThreadLocalBlock* thread_local_block_ __attribute__((aligned(64)));
+    // The node where each tid gets objects from, -1 if unknown
+    int* tid_node_;
+
+    inline ThreadLocalBlock& GetLocalBlock(int tid, int node) __attribute__((always_inline)) {
+        return thread_local_block_[tid * node_count_ + node];
+    }
+
+    // Move BLOCK_SIZE cells from the shared block to the thread-local block
+    void FetchFromSharedBlock(ThreadLocalBlock& local_block, int node);
 
  public:
     static ConcurrentMemPool* GetInstance(CellT* mem, size_t cell_count,
-                                          int nthreads, bool utilization_record) {
+                                          int nthreads, bool utilization_record, bool numa_aware = false,
+                                          bool huge_page = false,
+                                          int max_segment_count = CONCURRENT_MEM_POOL_DEFAULT_MAX_SEGMENT_COUNT) {
         static ConcurrentMemPool* p = nullptr;
 
         if (p == nullptr && cell_count > 0) {
             p = new ConcurrentMemPool();
-            p->Init(mem, cell_count, nthreads, utilization_record);
+            p->Init(mem, cell_count, nthreads, utilization_record, numa_aware, huge_page, max_segment_count);
         }
 
         return p;
@@ -133,9 +205,18 @@ class ConcurrentMemPool {
     CellT * Get(int tid = 0);
     void Free(CellT* cell, int tid = 0);
 
+    // Get() of tid serves from the arena of node from now on, -1 to use the node where tid is running.
+    // Only called by the thread of tid, or before it starts
+    void SetNode(int tid, int node) {
+        if (node_count_ > 1)
+            tid_node_[tid] = (node < node_count_) ? node : -1;
+    }
+
     std::string UsageString();
     std::pair<uint64_t, uint64_t> UsageStatistic();  // <usage_byte, total_byte>
     std::pair<OffsetT, OffsetT> GetUsage();  // <get_count, free_count>
+    std::pair<OffsetT, OffsetT> GetHighWaterMark();  // <peak count of cells fetched from the shared blocks, current capacity>
+    int GetReleasedSegmentCount();  // count of empty segments whose pages have been returned to the system
 };
 
 #include "concurrent_mem_pool.tpp"
@@ -14,80 +14,166 @@
 
 template<class CellT, class OffsetT, int BLOCK_SIZE>
 ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::~ConcurrentMemPool() {
-    if (next_offset_ != nullptr)
-        _mm_free(next_offset_);
+    HugePageUtil::Unmap(next_offset_, next_offset_bytes_);
     if (mem_allocated_)
-        _mm_free(attached_mem_);
+        HugePageUtil::Unmap(attached_mem_, reserved_bytes_);
+    delete[] shared_blocks_;
+    delete[] tid_node_;
 }
 
 template<class CellT, class OffsetT, int BLOCK_SIZE>
-void ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::Init(CellT* mem, size_t cell_count,
-                                                         int nthreads, bool utilization_record) {
+void ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::Init(CellT* mem, size_t cell_count, int nthreads,
+                                                         bool utilization_record, bool numa_aware, bool huge_page,
+                                                         int max_segment_count) {
     // make sure that enough cells are available for all threads
     assert(cell_count > nthreads * (BLOCK_SIZE + 2));
+    CHECK(max_segment_count >= 1) << "ConcurrentMemPool: max_segment_count should be at least 1";
 
-    cell_count_ = cell_count;
+    // Cannot grow or split memory provided by the caller
+    node_count_ = (numa_aware && mem == nullptr) ? NumaUtil::GetNodeCount() : 1;
+
+    if (node_count_ == 1) {
+        segment_size_ = cell_count;
+    } else {
+        size_t node_cell_count = (cell_count + node_count_ - 1) / node_count_;
+        segment_size_ = std::max(node_cell_count, static_cast<size_t>(nthreads * (BLOCK_SIZE + 2)));
+    }
     // Make sure that OffsetT can hold cell_count
-    assert(cell_count_ == cell_count);
+    assert(segment_size_ * node_count_ >= cell_count);
 
     if (mem != nullptr) {
         attached_mem_ = mem;
         mem_allocated_ = false;
+        arena_cell_count_ = cell_count;
     } else {
-        attached_mem_ = reinterpret_cast<CellT*>(_mm_malloc(sizeof(CellT) * cell_count, CONCURRENT_MEM_POOL_ARRAY_MEMORY_ALIGNMENT));
+        size_t max_cell_count = static_cast<size_t>(std::numeric_limits<OffsetT>::max()) / node_count_;
+        size_t arena_cell_count = std::min(static_cast<size_t>(segment_size_) * max_segment_count, max_cell_count);
+        // Arenas should be page-aligned for mbind
+        if (node_count_ > 1)
+            arena_cell_count -= arena_cell_count % CONCURRENT_MEM_POOL_ARRAY_MEMORY_ALIGNMENT;
+        CHECK(arena_cell_count >= segment_size_) << "ConcurrentMemPool: too many cells for OffsetT";
+        arena_cell_count_ = arena_cell_count;
+
+        reserved_bytes_ = sizeof(CellT) * arena_cell_count_ * node_count_;
+        // mmap returns page-aligned memory, satisfying CONCURRENT_MEM_POOL_ARRAY_MEMORY_ALIGNMENT
+        void* ptr = HugePageUtil::Map(reserved_bytes_, huge_page, true);
+        CHECK(ptr != nullptr) << "ConcurrentMemPool: failed to reserve " << reserved_bytes_ << " bytes";
+        attached_mem_ = reinterpret_cast<CellT*>(ptr);
         mem_allocated_ = true;
     }
 
-    next_offset_ = reinterpret_cast<OffsetT*>(_mm_malloc(sizeof(OffsetT) * cell_count, CONCURRENT_MEM_POOL_ARRAY_MEMORY_ALIGNMENT));
+    next_offset_bytes_ = sizeof(OffsetT) * arena_cell_count_ * node_count_;
+    void* ptr = HugePageUtil::Map(next_offset_bytes_, huge_page, true);
+    CHECK(ptr != nullptr) << "ConcurrentMemPool: failed to reserve next offsets";
+    next_offset_ = reinterpret_cast<OffsetT*>(ptr);
 
-    for (OffsetT i = 0; i < cell_count; i++) {
-        next_offset_[i] = i + 1;
+    // Pages are not touched yet, so that they will be allocated on the preferred node
+    if (node_count_ > 1) {
+        for (int node = 0; node < node_count_; node++) {
+            size_t arena_begin = static_cast<size_t>(arena_cell_count_) * node;
+            NumaUtil::PreferNode(attached_mem_ + arena_begin, sizeof(CellT) * arena_cell_count_, node);
+            NumaUtil::PreferNode(next_offset_ + arena_begin, sizeof(OffsetT) * arena_cell_count_, node);
+        }
     }
 
-    head_ = 0;
-    tail_ = cell_count - 1;
+    thread_local_block_ = reinterpret_cast<ThreadLocalBlock*>(_mm_malloc(sizeof(ThreadLocalBlock) * nthreads * node_count_,
+                                                                         CONCURRENT_MEM_POOL_ARRAY_MEMORY_ALIGNMENT));
+    shared_blocks_ = new SharedBlock[node_count_];
+    tid_node_ = new int[nthreads];
+    for (int tid = 0; tid < nthreads; tid++)
+        tid_node_[tid] = (node_count_ == 1) ? 0 : -1;
 
-    thread_local_block_ = reinterpret_cast<ThreadLocalBlock*>(_mm_malloc(sizeof(ThreadLocalBlock) * nthreads, CONCURRENT_MEM_POOL_ARRAY_MEMORY_ALIGNMENT));
+    for (int node = 0; node < node_count_; node++) {
+        auto& shared_block = shared_blocks_[node];
+        OffsetT arena_begin = arena_cell_count_ * node;
 
-    // initialize and allocate objects for the thread-local block
-    for (int tid = 0; tid < nthreads; tid++) {
-        auto& local_block = thread_local_block_[tid];
+        // First touch of the segment, in parallel for large pools
+        HugePageUtil::ParallelFor(arena_begin, arena_begin + segment_size_, nthreads, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                next_offset_[i] = static_cast<OffsetT>(i + 1);
+            }
+        });
 
-        local_block.free_cell_count = BLOCK_SIZE;
-        local_block.block_head = head_;
-        local_block.block_tail = head_ + BLOCK_SIZE - 1;
-        local_block.get_counter = 0;
-        local_block.free_counter = 0;
+        shared_block.head = arena_begin;
+        shared_block.tail = arena_begin + segment_size_ - 1;
+        shared_block.cell_end = arena_begin + segment_size_;
+        shared_block.free_count = segment_size_ - nthreads * BLOCK_SIZE;
+        shared_block.high_water_mark = nthreads * BLOCK_SIZE;
+        int segment_count = arena_cell_count_ / segment_size_;
+        shared_block.segment_free_count.assign(segment_count, 0);
+        shared_block.segment_free_count[0] = shared_block.free_count;
+        shared_block.segment_released.assign(segment_count, false);
+        shared_block.released_count = 0;
+        pthread_spin_init(&shared_block.lock, 0);
 
-        head_ = head_ + BLOCK_SIZE;
-    }
+        // initialize and allocate objects for the thread-local block
+        for (int tid = 0; tid < nthreads; tid++) {
+            auto& local_block = GetLocalBlock(tid, node);
 
-    pthread_spin_init(&lock_, 0);
+            local_block.free_cell_count = BLOCK_SIZE;
+            local_block.block_head = shared_block.head;
+            local_block.block_tail = shared_block.head + BLOCK_SIZE - 1;
+            local_block.get_counter = 0;
+            local_block.free_counter = 0;
+
+            shared_block.head = shared_block.head + BLOCK_SIZE;
+        }
+    }
 
     nthreads_ = nthreads;
     utilization_record_ = utilization_record;
 }
 
+template<class CellT, class OffsetT, int BLOCK_SIZE>
+void ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::FetchFromSharedBlock(ThreadLocalBlock& local_block, int node) {
+    auto& shared_block = shared_blocks_[node];
+
+    pthread_spin_lock(&shared_block.lock);
+    // Keep at least one cell (tail) in the shared block
+    if (shared_block.free_count <= BLOCK_SIZE + 1)
+        Grow(shared_block, node);
+    shared_block.free_count -= BLOCK_SIZE;
+
+    OffsetT fetched_count = shared_block.cell_end - arena_cell_count_ * node - shared_block.free_count;
+    shared_block.high_water_mark = std::max(shared_block.high_water_mark, fetched_count);
+
+    OffsetT tmp_head = shared_block.head;
+    local_block.free_cell_count += BLOCK_SIZE;
+    next_offset_[local_block.block_tail] = tmp_head;
+    for (OffsetT i = 0; i < BLOCK_SIZE; i++) {
+        if (i == BLOCK_SIZE - 1)
+            local_block.block_tail = tmp_head;
+
+        int segment = GetSegment(tmp_head, node);
+        shared_block.segment_free_count[segment]--;
+        if (shared_block.segment_released[segment]) {
+            // Pages are backed again when the cells are touched
+            shared_block.segment_released[segment] = false;
+            shared_block.released_count--;
+        }
+
+        tmp_head = next_offset_[tmp_head];
+        assert(tmp_head != shared_block.tail);
+    }
+    shared_block.head = tmp_head;
+    pthread_spin_unlock(&shared_block.lock);
+}
+
 template<class CellT, class OffsetT, int BLOCK_SIZE>
 CellT* ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::Get(int tid) {
     CellT* ret;
-    auto& local_block = thread_local_block_[tid];
+    int node = tid_node_[tid];
+    if (node < 0) {
+        node = NumaUtil::GetCurrentNode();
+        tid_node_[tid] = node;
+    }
+
+    auto& local_block = GetLocalBlock(tid, node);
 
     if (next_offset_[local_block.block_head] == local_block.block_tail) {
         // insufficient cells in the thred local block
         // fetch BLOCK_SIZE cells from the shared block to the tail of of the thread-local block
-        pthread_spin_lock(&lock_);
-        OffsetT tmp_head = head_;
-        local_block.free_cell_count += BLOCK_SIZE;
-        next_offset_[local_block.block_tail] = tmp_head;
-        for (OffsetT i = 0; i < BLOCK_SIZE; i++) {
-            if (i == BLOCK_SIZE - 1)
-                local_block.block_tail = tmp_head;
-            tmp_head = next_offset_[tmp_head];
-            assert(tmp_head != tail_);
-        }
-        head_ = tmp_head;
-        pthread_spin_unlock(&lock_);
+        FetchFromSharedBlock(local_block, node);
     }
 
     // fetch one cell from the head of thread-local block
@@ -105,7 +191,9 @@ template<class CellT, class OffsetT, int BLOCK_SIZE>
 void ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::Free(CellT* cell, int tid) {
     OffsetT mem_off = cell - attached_mem_;
 
-    auto& local_block = thread_local_block_[tid];
+    // the cell goes back to the arena it belongs to
+    int node = (node_count_ == 1) ? 0 : mem_off / arena_cell_count_;
+    auto& local_block = GetLocalBlock(tid, node);
 
     // attach the free cell to the tail of thread-local block
     next_offset_[local_block.block_tail] = mem_off;
@@ -115,59 +203,133 @@ void ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::Free(CellT* cell, int tid) {
     if (local_block.free_cell_count == 2 * BLOCK_SIZE) {
         // too many free cells in the thread-local block
         // get BLOCK_SIZE cells from the head of the thread-local block
+        // and count them into their segments, under the lock since the counts are of the shared block
+        auto& shared_block = shared_blocks_[node];
+        pthread_spin_lock(&shared_block.lock);
         OffsetT tmp_head = local_block.block_head;
         OffsetT tmp_tail = tmp_head;
-        for (int i = 0; i < BLOCK_SIZE - 1; i++)
-            tmp_tail = next_offset_[tmp_tail];
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            if (i > 0)
+                tmp_tail = next_offset_[tmp_tail];
+            int segment = GetSegment(tmp_tail, node);
+            if (++shared_block.segment_free_count[segment] == segment_size_)
+                TryReleaseSegment(shared_block, node, segment);
+        }
         local_block.block_head = next_offset_[tmp_tail];
         local_block.free_cell_count -= BLOCK_SIZE;
 
         // attach those cells to the tail of the shared block
-        pthread_spin_lock(&lock_);
-        next_offset_[tail_] = tmp_head;
-        tail_ = tmp_tail;
-        pthread_spin_unlock(&lock_);
+        next_offset_[shared_block.tail] = tmp_head;
+        shared_block.tail = tmp_tail;
+        shared_block.free_count += BLOCK_SIZE;
+        pthread_spin_unlock(&shared_block.lock);
     }
 
     if (utilization_record_)
         local_block.free_counter++;
 }
 
+template<class CellT, class OffsetT, int BLOCK_SIZE>
+void ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::Grow(SharedBlock& shared_block, int node) {
+    size_t arena_end = static_cast<size_t>(arena_cell_count_) * (node + 1);
+    CHECK(static_cast<size_t>(shared_block.cell_end) + segment_size_ <= arena_end)
+        << "ConcurrentMemPool exhausted on node " << node
+        << ", enlarge the pool size or MEM_POOL_MAX_SEGMENT_COUNT in config";
+
+    OffsetT begin = shared_block.cell_end;
+    OffsetT end = shared_block.cell_end + segment_size_;
+    for (OffsetT i = begin; i < end; i++) {
+        next_offset_[i] = i + 1;
+    }
+
+    // attach the new segment to the tail of the shared block
+    next_offset_[shared_block.tail] = begin;
+    shared_block.tail = end - 1;
+
+    shared_block.cell_end = end;
+    shared_block.free_count += segment_size_;
+    shared_block.segment_free_count[GetSegment(begin, node)] = segment_size_;
+}
+
+template<class CellT, class OffsetT, int BLOCK_SIZE>
+void ConcurrentMemPool<CellT, OffsetT, BLOCK_SIZE>::TryReleaseSegment(SharedBlock& shared_block, int node, int segment) {
+    // The first segment is kept as the base capacity, and memory provided by the caller is never released
+    if (!mem_allocated_ || segment == 0 || shared_block.segment_released[segment])
+        return;
+
+    // next_offset_ of the segment is kept, since the free list goes through it
+    OffsetT begin = arena_cell_count_ * node + static_cast<OffsetT>(segment) * segment_size_;
+    HugePageUtil::Release(attached_mem_ + begin, sizeof(CellT) * segment_size_);
+    shared_block.segment_released[segment] = true;
+    shared_block.released_count++;
+}
+
 template<class CellT, class OffsetT, int THREAD_BLOCK_SIZE>
 std::string ConcurrentMemPool<CellT, OffsetT, THREAD_BLOCK_SIZE>::UsageString() {
     OffsetT get_counter = 0;
     OffsetT free_counter = 0;
-    for (int tid = 0; tid < nthreads_; tid++) {
-        get_counter += thread_local_block_[tid].get_counter;
-        free_counter += thread_local_block_[tid].free_counter;
+    for (int i = 0; i < nthreads_ * node_count_; i++) {
+        get_counter += thread_local_block_[i].get_counter;
+        free_counter += thread_local_block_[i].free_counter;
     }
-    OffsetT cell_avail = cell_count_ - get_counter + free_counter - 2;
+    std::pair<OffsetT, OffsetT> peak_total = GetHighWaterMark();
+    OffsetT cell_count = peak_total.second;
+    OffsetT cell_avail = cell_count - get_counter + free_counter - 2;
 
     return "Get: " + std::to_string(get_counter) + ", Free: " + std::to_string(free_counter)
-           + ", Total: " + std::to_string(cell_count_) + ", Avail: " + std::to_string(cell_avail);
+           + ", Total: " + std::to_string(cell_count) + ", Avail: " + std::to_string(cell_avail)
+           + ", Peak: " + std::to_string(peak_total.first) + ", Segments: " + std::to_string(cell_count / segment_size_)
+           + ", Released: " + std::to_string(GetReleasedSegmentCount()) + ", Nodes: " + std::to_string(node_count_);
 }
 
 template<class CellT, class OffsetT, int THREAD_BLOCK_SIZE>
 std::pair<uint64_t, uint64_t> ConcurrentMemPool<CellT, OffsetT, THREAD_BLOCK_SIZE>::UsageStatistic() {
     OffsetT get_counter = 0;
     OffsetT free_counter = 0;
-    for (int tid = 0; tid < nthreads_; tid++) {
-        get_counter += thread_local_block_[tid].get_counter;
-        free_counter += thread_local_block_[tid].free_counter;
+    for (int i = 0; i < nthreads_ * node_count_; i++) {
+        get_counter += thread_local_block_[i].get_counter;
+        free_counter += thread_local_block_[i].free_counter;
     }
     uint64_t usage_counter = get_counter - free_counter + 2;
+    uint64_t cell_count = GetHighWaterMark().second;
 
-    return std::pair<uint64_t, uint64_t>(usage_counter * (sizeof(CellT) + sizeof(OffsetT)), cell_count_ * (sizeof(CellT) + sizeof(OffsetT)));
+    return std::pair<uint64_t, uint64_t>(usage_counter * (sizeof(CellT) + sizeof(OffsetT)), cell_count * (sizeof(CellT) + sizeof(OffsetT)));
 }
 
 template<class CellT, class OffsetT, int THREAD_BLOCK_SIZE>
 std::pair<OffsetT, OffsetT> ConcurrentMemPool<CellT, OffsetT, THREAD_BLOCK_SIZE>::GetUsage() {
     OffsetT get_counter = 0;
     OffsetT free_counter = 0;
-    for (int tid = 0; tid < nthreads_; tid++) {
-        get_counter += thread_local_block_[tid].get_counter;
-        free_counter += thread_local_block_[tid].free_counter;
+    for (int i = 0; i < nthreads_ * node_count_; i++) {
+        get_counter += thread_local_block_[i].get_counter;
+        free_counter += thread_local_block_[i].free_counter;
     }
 
     return std::make_pair(get_counter, free_counter);
 }
+
+template<class CellT, class OffsetT, int THREAD_BLOCK_SIZE>
+std::pair<OffsetT, OffsetT> ConcurrentMemPool<CellT, OffsetT, THREAD_BLOCK_SIZE>::GetHighWaterMark() {
+    OffsetT high_water_mark = 0;
+    OffsetT cell_count = 0;
+    for (int node = 0; node < node_count_; node++) {
+        auto& shared_block = shared_blocks_[node];
+        pthread_spin_lock(&shared_block.lock);
+        high_water_mark += shared_block.high_water_mark;
+        cell_count += shared_block.cell_end - arena_cell_count_ * node;
+        pthread_spin_unlock(&shared_block.lock);
+    }
+    return std::make_pair(high_water_mark, cell_count);
+}
+
+template<class CellT, class OffsetT, int THREAD_BLOCK_SIZE>
+int ConcurrentMemPool<CellT, OffsetT, THREAD_BLOCK_SIZE>::GetReleasedSegmentCount() {
+    int released_count = 0;
+    for (int node = 0; node < node_count_; node++) {
+        auto& shared_block = shared_blocks_[node];
+        pthread_spin_lock(&shared_block.lock);
+        released_count += shared_block.released_count;
+        pthread_spin_unlock(&shared_block.lock);
+    }
+    return released_count;
+}
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "layout/data_storage.hpp"
+#include "layout/epoch_manager.hpp"
 #include "layout/garbage_collector.hpp"
 
 // defined in mvcc_list.hpp, for recording reading dependencies
@@ -21,6 +22,7 @@ tbb::concurrent_hash_map<uint64_t, depend_trx_lists> dep_trx_map;
 template<class MVCC> ConcurrentMemPool<MVCC>* MVCCList<MVCC>::mem_pool_ = nullptr;
 template<class PropertyRow> ConcurrentMemPool<PropertyRow>* PropertyRowList<PropertyRow>::mem_pool_ = nullptr;
 template<class PropertyRow> MVCCValueStore* PropertyRowList<PropertyRow>::value_store_ = nullptr;
+template<class PropertyRow> unordered_set<label_t>* PropertyRowList<PropertyRow>::dict_pkeys_ = nullptr;
 ConcurrentMemPool<VertexEdgeRow>* TopologyRowList::mem_pool_ = nullptr;
 MVCCValueStore* VPropertyMVCCItem::value_store = nullptr;
 MVCCValueStore* EPropertyMVCCItem::value_store = nullptr;
@@ -50,6 +52,7 @@ void DataStorage::Init() {
                        sizeof(PropertyMVCCItem), sizeof(VertexMVCCItem), sizeof(EdgeMVCCItem));
 
     CreateContainer();
+    vertex_table_.Init(worker_size_, worker_rank_);
 
     hdfs_data_loader_ = HDFSDataLoader::GetInstance();
 
@@ -79,25 +82,32 @@ void DataStorage::Init() {
 void DataStorage::CreateContainer() {
     ve_row_pool_ = ConcurrentMemPool<VertexEdgeRow>::GetInstance(
                             nullptr, config_->global_ve_row_pool_size, container_nthreads_,
-                            config_->global_enable_mem_pool_utilization_record);
+                            config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                            config_->global_enable_huge_page, config_->global_mem_pool_max_segment_count);
     vp_row_pool_ = ConcurrentMemPool<VertexPropertyRow>::GetInstance(
                             nullptr, config_->global_vp_row_pool_size, container_nthreads_,
-                            config_->global_enable_mem_pool_utilization_record);
+                            config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                            config_->global_enable_huge_page, config_->global_mem_pool_max_segment_count);
     ep_row_pool_ = ConcurrentMemPool<EdgePropertyRow>::GetInstance(
                             nullptr, config_->global_ep_row_pool_size, container_nthreads_,
-                            config_->global_enable_mem_pool_utilization_record);
+                            config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                            config_->global_enable_huge_page, config_->global_mem_pool_max_segment_count);
     vp_mvcc_pool_ = ConcurrentMemPool<VPropertyMVCCItem>::GetInstance(
                             nullptr, config_->global_vp_mvcc_pool_size, container_nthreads_,
-                            config_->global_enable_mem_pool_utilization_record);
+                            config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                            config_->global_enable_huge_page, config_->global_mem_pool_max_segment_count);
     ep_mvcc_pool_ = ConcurrentMemPool<EPropertyMVCCItem>::GetInstance(
                             nullptr, config_->global_ep_mvcc_pool_size, container_nthreads_,
-                            config_->global_enable_mem_pool_utilization_record);
+                            config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                            config_->global_enable_huge_page, config_->global_mem_pool_max_segment_count);
     vertex_mvcc_pool_ = ConcurrentMemPool<VertexMVCCItem>::GetInstance(
                             nullptr, config_->global_v_mvcc_pool_size, container_nthreads_,
-                            config_->global_enable_mem_pool_utilization_record);
+                            config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                            config_->global_enable_huge_page, config_->global_mem_pool_max_segment_count);
     edge_mvcc_pool_ = ConcurrentMemPool<EdgeMVCCItem>::GetInstance(
                             nullptr, config_->global_e_mvcc_pool_size, container_nthreads_,
-                            config_->global_enable_mem_pool_utilization_record);
+                            config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                            config_->global_enable_huge_page, config_->global_mem_pool_max_segment_count);
 
     MVCCList<VPropertyMVCCItem>::SetGlobalMemoryPool(vp_mvcc_pool_);
     MVCCList<EPropertyMVCCItem>::SetGlobalMemoryPool(ep_mvcc_pool_);
@@ -110,13 +120,41 @@ void DataStorage::CreateContainer() {
     uint64_t vp_sz = GiB2B(config_->global_vertex_property_kv_sz_gb);
     uint64_t ep_sz = GiB2B(config_->global_edge_property_kv_sz_gb);
     vp_store_ = new MVCCValueStore(nullptr, vp_sz / (MEM_CELL_SIZE + sizeof(OffsetT)), container_nthreads_,
-                                   config_->global_enable_mem_pool_utilization_record);
+                                   config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                                   config_->global_enable_huge_page);
     ep_store_ = new MVCCValueStore(nullptr, ep_sz / (MEM_CELL_SIZE + sizeof(OffsetT)), container_nthreads_,
-                                   config_->global_enable_mem_pool_utilization_record);
+                                   config_->global_enable_mem_pool_utilization_record, config_->global_enable_numa_pool,
+                                   config_->global_enable_huge_page);
     PropertyRowList<VertexPropertyRow>::SetGlobalValueStore(vp_store_);
     PropertyRowList<EdgePropertyRow>::SetGlobalValueStore(ep_store_);
     VPropertyMVCCItem::SetGlobalValueStore(vp_store_);
     EPropertyMVCCItem::SetGlobalValueStore(ep_store_);
+
+    if (config_->global_enable_numa_pool && NumaUtil::GetNodeCount() > 1) {
+        // Expert threads bound to cores allocate on their own nodes.
+        // Loaded vertices are spread in proportion to the expert threads on each node, since any expert thread
+        // may serve a vertex under work stealing; if threads are not bound, they are spread over all nodes
+        for (int tid = 0; tid < thread_nodes_.size(); tid++) {
+            if (thread_nodes_[tid] >= 0) {
+                SetContainerNode(tid, thread_nodes_[tid]);
+                placement_nodes_.emplace_back(thread_nodes_[tid]);
+            }
+        }
+        if (placement_nodes_.empty()) {
+            for (int node = 0; node < NumaUtil::GetNodeCount(); node++)
+                placement_nodes_.emplace_back(node);
+        }
+    }
+}
+
+void DataStorage::SetContainerNode(int tid, int node) {
+    ve_row_pool_->SetNode(tid, node);
+    vp_row_pool_->SetNode(tid, node);
+    ep_row_pool_->SetNode(tid, node);
+    vp_mvcc_pool_->SetNode(tid, node);
+    ep_mvcc_pool_->SetNode(tid, node);
+    vertex_mvcc_pool_->SetNode(tid, node);
+    edge_mvcc_pool_->SetNode(tid, node);
 }
 
 // Calculate the thresholds of printing progress lines in the "load V" loop.
@@ -332,43 +370,54 @@ double DataStorage::GetContainerUsage() {
 void DataStorage::FillVertexContainer() {
     indexes_ = hdfs_data_loader_->indexes_;
 
+    if (!indexes_->dict_vpks.empty())
+        PropertyRowList<VertexPropertyRow>::SetGlobalDictKeys(&indexes_->dict_vpks);
+    if (!indexes_->dict_epks.empty())
+        PropertyRowList<EdgePropertyRow>::SetGlobalDictKeys(&indexes_->dict_epks);
+
     int max_vid = worker_rank_;
     int v_printed_progress = 0;
+    int loader_tid = TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER);
 
     InitPrintFillVProgress();
     for (int i = 0; i < hdfs_data_loader_->shuffled_vtx_.size(); i++) {
         PrintFillingProgress(i, v_printed_progress, threshold_print_progress_v_, "DataStorage::FillVertexContainer");
 
         const TMPVertex& vtx = hdfs_data_loader_->shuffled_vtx_[i];
+        if (!placement_nodes_.empty())
+            SetContainerNode(loader_tid, GetPlacementNode(vtx.id));
 
-        // std::pair<VertexIterator iterator_to_inserted_item, bool insert_occurred>
-        auto insert_result = vertex_map_.insert(pair<uint32_t, Vertex>(vtx.id.value(), Vertex()));
-        VertexIterator v_itr = insert_result.first;
+        Vertex* vertex = vertex_table_.Insert(vtx.id);
 
         if (max_vid < vtx.id.value())
             max_vid = vtx.id.value();
 
-        v_itr->second.label = vtx.label;
+        vertex->label = vtx.label;
         // create row lists that attached to the Vertex
-        v_itr->second.vp_row_list = new PropertyRowList<VertexPropertyRow>;
-        v_itr->second.ve_row_list = new TopologyRowList;
+        vertex->vp_row_list = new PropertyRowList<VertexPropertyRow>;
+        vertex->ve_row_list = new TopologyRowList;
 
-        v_itr->second.vp_row_list->Init();
-        v_itr->second.ve_row_list->Init(vtx.id);
-
-        v_itr->second.mvcc_list = new MVCCList<VertexMVCCItem>;
-        *(v_itr->second.mvcc_list->AppendInitialVersion()) = true;  // true ==> visible
+        vertex->vp_row_list->Init();
+        vertex->ve_row_list->Init(vtx.id);
 
         // Insert vertex properties
         for (int i = 0; i < vtx.vp_label_list.size(); i++) {
-            v_itr->second.vp_row_list->InsertInitialCell(vpid_t(vtx.id, vtx.vp_label_list[i]),
-                                                                vtx.vp_value_list[i]);
+            vertex->vp_row_list->InsertInitialCell(vpid_t(vtx.id, vtx.vp_label_list[i]),
+                                                   vtx.vp_value_list[i]);
         }
+
+        // the vertex is visible in vertex_table_ after mvcc_list is set
+        auto* mvcc_list = new MVCCList<VertexMVCCItem>;
+        *(mvcc_list->AppendInitialVersion()) = true;  // true ==> visible
+        vertex->mvcc_list = mvcc_list;
     }
     PrintFillingProgress(hdfs_data_loader_->shuffled_vtx_.size(), v_printed_progress, threshold_print_progress_v_, "DataStorage::FillVertexContainer");
+    if (!placement_nodes_.empty())
+        SetContainerNode(loader_tid, -1);
 
     num_of_vertex_local_ = (max_vid - worker_rank_) / worker_size_;
 
+    node_.LocalSequentialDebugPrint("vertex_table_: " + to_string(vertex_table_.GetSegmentCount()) + " segments");
     node_.LocalSequentialDebugPrint("vp_row_pool_: " + vp_row_pool_->UsageString());
     node_.LocalSequentialDebugPrint("vp_mvcc_pool_: " + vp_mvcc_pool_->UsageString());
     node_.LocalSequentialDebugPrint("vertex_mvcc_pool_: " + vertex_mvcc_pool_->UsageString());
@@ -380,6 +429,7 @@ void DataStorage::FillVertexContainer() {
 void DataStorage::FillEdgeContainer() {
     int out_e_printed_progress = 0;
     int in_e_printed_progress = 0;
+    int loader_tid = TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER);
 
     InitPrintFillEProgress();
 
@@ -389,14 +439,17 @@ void DataStorage::FillEdgeContainer() {
                              threshold_print_progress_out_e_, "DataStorage::FillEdgeContainer, out edge");
 
         const TMPOutEdge& edge = hdfs_data_loader_->shuffled_out_edge_[i];
+        // Edge properties are placed with the src vertex
+        if (!placement_nodes_.empty())
+            SetContainerNode(loader_tid, GetPlacementNode(edge.id.src_v));
 
-        VertexIterator v_itr = vertex_map_.find(edge.id.src_v);
+        Vertex* vertex = vertex_table_.Find(edge.id.src_v);
 
         auto* ep_row_list = new PropertyRowList<EdgePropertyRow>;
         ep_row_list->Init();
 
         // "true" means that is_out = true, as this edge is an outE for the Vertex
-        auto* mvcc_list = v_itr->second.ve_row_list->InsertInitialCell(true, edge.id.dst_v, edge.label, ep_row_list);
+        auto* mvcc_list = vertex->ve_row_list->InsertInitialCell(true, edge.id.dst_v, edge.label, ep_row_list);
 
         // edge map will have pointer of MVCCList<EdgeMVCCItem> in ve_row_list, similarly hereinafter.
         OutEdgeIterator out_e_itr = out_edge_map_.insert(pair<uint64_t, OutEdge>(edge.id.value(), OutEdge())).first;
@@ -412,10 +465,12 @@ void DataStorage::FillEdgeContainer() {
 
         // check if the dst_v on this worker
         if (id_mapper_->IsVertexLocal(edge.id.dst_v)) {
-            VertexIterator v_itr = vertex_map_.find(edge.id.dst_v);
+            if (!placement_nodes_.empty())
+                SetContainerNode(loader_tid, GetPlacementNode(edge.id.dst_v));
+            Vertex* vertex = vertex_table_.Find(edge.id.dst_v);
 
             // "false" => is_out = false => inE
-            auto* mvcc_list = v_itr->second.ve_row_list
+            auto* mvcc_list = vertex->ve_row_list
                               ->InsertInitialCell(false, edge.id.src_v, edge.label, nullptr);
 
             InEdgeIterator in_e_itr = in_edge_map_.insert(pair<uint64_t, InEdge>(edge.id.value(), InEdge())).first;
@@ -430,12 +485,13 @@ void DataStorage::FillEdgeContainer() {
                              threshold_print_progress_in_e_, "DataStorage::FillEdgeContainer, in edge");
 
         const TMPInEdge& edge = hdfs_data_loader_->shuffled_in_edge_[i];
-    
+        if (!placement_nodes_.empty())
+            SetContainerNode(loader_tid, GetPlacementNode(edge.id.dst_v));
 
-        VertexIterator v_itr = vertex_map_.find(edge.id.dst_v);
+        Vertex* vertex = vertex_table_.Find(edge.id.dst_v);
 
         // "false" => is_out = false => inE
-        auto* mvcc_list = v_itr->second.ve_row_list
+        auto* mvcc_list = vertex->ve_row_list
                           ->InsertInitialCell(false, edge.id.src_v, edge.label, nullptr);
 
         InEdgeIterator in_e_itr = in_edge_map_.insert(pair<uint64_t, InEdge>(edge.id.value(), InEdge())).first;
@@ -443,6 +499,8 @@ void DataStorage::FillEdgeContainer() {
     }
     PrintFillingProgress(hdfs_data_loader_->shuffled_in_edge_.size(), in_e_printed_progress,
                          threshold_print_progress_in_e_, "DataStorage::FillEdgeContainer, in edge");
+    if (!placement_nodes_.empty())
+        SetContainerNode(loader_tid, -1);
 
     node_.LocalSequentialDebugPrint("ve_row_pool_: " + ve_row_pool_->UsageString());
     node_.LocalSequentialDebugPrint("ep_row_pool_: " + ep_row_pool_->UsageString());
@@ -453,11 +511,15 @@ void DataStorage::FillEdgeContainer() {
     node_.Rank0PrintfWithWorkerBarrier("DataStorage::FillEdgeContainer() finished\n");
 }
 
-READ_STAT DataStorage::CheckVertexVisibility(const VertexConstIterator& v_iterator, const uint64_t& trx_id,
+READ_STAT DataStorage::CheckVertexVisibility(const Vertex* vertex, const uint64_t& trx_id,
                                              const uint64_t& begin_time, const bool& read_only) {
-    VertexMVCCItem* visible_version;
+    // vertex->mvcc_list can be detached by VertexTable::Erase concurrently, load it only once
+    MVCCList<VertexMVCCItem>* mvcc_list = vertex->mvcc_list;
+    if (mvcc_list == nullptr)
+        return READ_STAT::NOTFOUND;
+
     bool exists;
-    pair<bool, bool> is_visible = v_iterator->second.mvcc_list->GetVisibleVersion(trx_id, begin_time, read_only, exists);
+    pair<bool, bool> is_visible = mvcc_list->GetVisibleVersion(trx_id, begin_time, read_only, exists);
 
     if (!is_visible.first)
         return READ_STAT::ABORT;
@@ -472,18 +534,18 @@ READ_STAT DataStorage::CheckVertexVisibility(const VertexConstIterator& v_iterat
     return READ_STAT::SUCCESS;
 }
 
-READ_STAT DataStorage::GetVertexIterator(VertexConstIterator& v_iterator, const vid_t& vid, const uint64_t& trx_id,
-                                         const uint64_t& begin_time, const bool& read_only) {
-    v_iterator = vertex_map_.find(vid.value());
+READ_STAT DataStorage::GetVertex(Vertex*& vertex, const vid_t& vid, const uint64_t& trx_id,
+                                 const uint64_t& begin_time, const bool& read_only) {
+    vertex = vertex_table_.Find(vid);
 
-    if (v_iterator == vertex_map_.end()) {
+    if (vertex == nullptr) {
         return READ_STAT::NOTFOUND;
     }
 
     /* Check if the vertex with given vid is invisible, which means that the read dependency (vertex)
      * of this transaction has been modified.
      */
-    auto read_stat = CheckVertexVisibility(v_iterator, trx_id, begin_time, read_only);
+    auto read_stat = CheckVertexVisibility(vertex, trx_id, begin_time, read_only);
     if (read_stat == READ_STAT::ABORT) {
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
         return READ_STAT::ABORT;
@@ -495,7 +557,11 @@ READ_STAT DataStorage::GetVertexIterator(VertexConstIterator& v_iterator, const
 READ_STAT DataStorage::GetOutEdgeVersion(const eid_t& eid, const uint64_t& trx_id, const uint64_t& begin_time,
                                          const bool& read_only, EdgeVersion& version_ref) {
     ReaderLockGuard reader_lock_guard(out_edge_erase_rwlock_);
+    return GetOutEdgeVersionWithoutLock(eid, trx_id, begin_time, read_only, version_ref);
+}
 
+READ_STAT DataStorage::GetOutEdgeVersionWithoutLock(const eid_t& eid, const uint64_t& trx_id, const uint64_t& begin_time,
+                                                    const bool& read_only, EdgeVersion& version_ref) {
     OutEdgeConstIterator out_e_iterator = out_edge_map_.find(eid.value());
 
     if (out_e_iterator == out_edge_map_.end())
@@ -521,13 +587,17 @@ READ_STAT DataStorage::GetOutEdgeVersion(const eid_t& eid, const uint64_t& trx_i
 
 READ_STAT DataStorage::GetVPByPKey(const vpid_t& pid, const uint64_t& trx_id, const uint64_t& begin_time,
                                    const bool& read_only, value_t& ret) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, pid.vid, trx_id, begin_time, read_only);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, pid.vid, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS)
         return read_stat;
 
-    auto stat = v_iterator->second.vp_row_list->ReadProperty(pid, trx_id, begin_time, read_only, ret);
+    // vertex->vp_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    PropertyRowList<VertexPropertyRow>* vp_row_list = vertex->vp_row_list;
+    if (vp_row_list == nullptr)
+        return READ_STAT::NOTFOUND;
+
+    auto stat = vp_row_list->ReadProperty(pid, trx_id, begin_time, read_only, ret);
 
     if (stat == READ_STAT::ABORT)
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
@@ -537,13 +607,17 @@ READ_STAT DataStorage::GetVPByPKey(const vpid_t& pid, const uint64_t& trx_id, co
 
 READ_STAT DataStorage::GetAllVP(const vid_t& vid, const uint64_t& trx_id, const uint64_t& begin_time,
                                 const bool& read_only, vector<pair<label_t, value_t>>& ret) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, read_only);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS)
         return read_stat;
 
-    auto stat = v_iterator->second.vp_row_list->ReadAllProperty(trx_id, begin_time, read_only, ret);
+    // vertex->vp_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    PropertyRowList<VertexPropertyRow>* vp_row_list = vertex->vp_row_list;
+    if (vp_row_list == nullptr)
+        return READ_STAT::NOTFOUND;
+
+    auto stat = vp_row_list->ReadAllProperty(trx_id, begin_time, read_only, ret);
 
     if (stat == READ_STAT::ABORT)
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
@@ -554,13 +628,17 @@ READ_STAT DataStorage::GetAllVP(const vid_t& vid, const uint64_t& trx_id, const
 READ_STAT DataStorage::GetVPByPKeyList(const vid_t& vid, const vector<label_t>& p_key,
                                        const uint64_t& trx_id, const uint64_t& begin_time,
                                        const bool& read_only, vector<pair<label_t, value_t>>& ret) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, read_only);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS)
         return read_stat;
 
-    auto stat = v_iterator->second.vp_row_list->ReadPropertyByPKeyList(p_key, trx_id, begin_time, read_only, ret);
+    // vertex->vp_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    PropertyRowList<VertexPropertyRow>* vp_row_list = vertex->vp_row_list;
+    if (vp_row_list == nullptr)
+        return READ_STAT::NOTFOUND;
+
+    auto stat = vp_row_list->ReadPropertyByPKeyList(p_key, trx_id, begin_time, read_only, ret);
 
     if (stat == READ_STAT::ABORT)
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
@@ -570,13 +648,17 @@ READ_STAT DataStorage::GetVPByPKeyList(const vid_t& vid, const vector<label_t>&
 
 READ_STAT DataStorage::GetVPidList(const vid_t& vid, const uint64_t& trx_id, const uint64_t& begin_time,
                                    const bool& read_only, vector<vpid_t>& ret) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, read_only);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS)
         return read_stat;
 
-    auto stat = v_iterator->second.vp_row_list->ReadPidList(trx_id, begin_time, read_only, ret);
+    // vertex->vp_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    PropertyRowList<VertexPropertyRow>* vp_row_list = vertex->vp_row_list;
+    if (vp_row_list == nullptr)
+        return READ_STAT::NOTFOUND;
+
+    auto stat = vp_row_list->ReadPidList(trx_id, begin_time, read_only, ret);
 
     if (stat == READ_STAT::ABORT)
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
@@ -586,13 +668,12 @@ READ_STAT DataStorage::GetVPidList(const vid_t& vid, const uint64_t& trx_id, con
 
 READ_STAT DataStorage::GetVL(const vid_t& vid, const uint64_t& trx_id,
                              const uint64_t& begin_time, const bool& read_only, label_t& ret) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, read_only);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS)
         return read_stat;
 
-    ret = v_iterator->second.label;
+    ret = vertex->label;
 
     return READ_STAT::SUCCESS;
 }
@@ -674,14 +755,18 @@ READ_STAT DataStorage::GetEL(const eid_t& eid, const uint64_t& trx_id,
 READ_STAT DataStorage::GetConnectedVertexList(const vid_t& vid, const label_t& edge_label, const Direction_T& direction,
                                               const uint64_t& trx_id, const uint64_t& begin_time,
                                               const bool& read_only, vector<vid_t>& ret) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, read_only);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS)
         return read_stat;
 
-    auto stat = v_iterator->second.ve_row_list->ReadConnectedVertex(direction, edge_label,
-                                                                    trx_id, begin_time, read_only, ret);
+    // vertex->ve_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    TopologyRowList* ve_row_list = vertex->ve_row_list;
+    if (ve_row_list == nullptr)
+        return READ_STAT::NOTFOUND;
+
+    auto stat = ve_row_list->ReadConnectedVertex(direction, edge_label,
+                                                 trx_id, begin_time, read_only, ret);
 
     if (stat == READ_STAT::ABORT)
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
@@ -691,16 +776,19 @@ READ_STAT DataStorage::GetConnectedVertexList(const vid_t& vid, const label_t& e
 
 READ_STAT DataStorage::GetConnectedEdgeList(const vid_t& vid, const label_t& edge_label, const Direction_T& direction,
                                             const uint64_t& trx_id, const uint64_t& begin_time,
-                                            const bool& read_only, vector<eid_t>& ret, bool need_read_lock) {
-    WritePriorRWLock* lock_ptr = need_read_lock ? &vertex_map_erase_rwlock_ : nullptr;
-    ReaderLockGuard reader_lock_guard(*lock_ptr);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, read_only);
+                                            const bool& read_only, vector<eid_t>& ret) {
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS)
         return read_stat;
 
-    auto stat = v_iterator->second.ve_row_list->ReadConnectedEdge(direction, edge_label,
-                                                                  trx_id, begin_time, read_only, ret);
+    // vertex->ve_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    TopologyRowList* ve_row_list = vertex->ve_row_list;
+    if (ve_row_list == nullptr)
+        return READ_STAT::NOTFOUND;
+
+    auto stat = ve_row_list->ReadConnectedEdge(direction, edge_label,
+                                               trx_id, begin_time, read_only, ret);
 
     if (stat == READ_STAT::ABORT)
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
@@ -710,29 +798,25 @@ READ_STAT DataStorage::GetConnectedEdgeList(const vid_t& vid, const label_t& edg
 
 READ_STAT DataStorage::GetAllVertices(const uint64_t& trx_id, const uint64_t& begin_time,
                                       const bool& read_only, vector<vid_t>& ret) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    for (auto v_pair = vertex_map_.begin(); v_pair != vertex_map_.end(); v_pair++) {
-        auto& v_item = v_pair->second;
-
-        bool exists;
-        MVCCList<VertexMVCCItem>* mvcc_list = v_item.mvcc_list;
-
-        // the insertion of this vertex is not finished
-        if (mvcc_list == nullptr)
-            continue;
+    bool abort = false;
+    vertex_table_.ForEach([&](const vid_t& vid, const Vertex& vertex) {
+        if (abort)
+            return;
 
-        pair<bool, bool> is_visible = mvcc_list->GetVisibleVersion(trx_id, begin_time, read_only, exists);
-        if (!is_visible.first) {
-            trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
-            return READ_STAT::ABORT;
+        auto read_stat = CheckVertexVisibility(&vertex, trx_id, begin_time, read_only);
+        if (read_stat == READ_STAT::ABORT) {
+            abort = true;
+            return;
         }
 
-        if (!is_visible.second)
-            continue;
-
         // if this vertex is visible
-        if (exists)
-            ret.emplace_back(vid_t(v_pair->first));
+        if (read_stat == READ_STAT::SUCCESS)
+            ret.emplace_back(vid);
+    });
+
+    if (abort) {
+        trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+        return READ_STAT::ABORT;
     }
 
     return READ_STAT::SUCCESS;
@@ -773,14 +857,13 @@ READ_STAT DataStorage::GetAllEdges(const uint64_t& trx_id, const uint64_t& begin
 bool DataStorage::CheckVertexVisibilityWithVid(const uint64_t& trx_id, const uint64_t& begin_time,
                                                const bool& read_only, vid_t& vid) {
     // Check visibility of the vertex
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator = vertex_map_.find(vid.value());
+    Vertex* vertex = vertex_table_.Find(vid);
 
-    if (v_iterator == vertex_map_.end()) {
+    if (vertex == nullptr) {
         return false;
     }
 
-    auto read_stat = CheckVertexVisibility(v_iterator, trx_id, begin_time, read_only);
+    auto read_stat = CheckVertexVisibility(vertex, trx_id, begin_time, read_only);
     if (read_stat != READ_STAT::SUCCESS) {
         // Invisible
         return false;
@@ -800,6 +883,142 @@ bool DataStorage::CheckEdgeVisibilityWithEid(const uint64_t& trx_id, const uint6
     return true;
 }
 
+READ_STAT DataStorage::GetConnectedVertexListBatch(const vector<vid_t>& vids, const label_t& edge_label,
+                                                   const Direction_T& direction, const uint64_t& trx_id,
+                                                   const uint64_t& begin_time, const bool& read_only,
+                                                   vector<vid_t>& ret) {
+    for (int i = 0; i < vids.size(); i++) {
+        if (i + BATCH_PREFETCH_DISTANCE < vids.size())
+            vertex_table_.Prefetch(vids[i + BATCH_PREFETCH_DISTANCE]);
+
+        Vertex* vertex;
+        auto read_stat = GetVertex(vertex, vids[i], trx_id, begin_time, read_only);
+        if (read_stat == READ_STAT::ABORT)
+            return READ_STAT::ABORT;
+        if (read_stat == READ_STAT::NOTFOUND)
+            continue;
+
+        TopologyRowList* ve_row_list = vertex->ve_row_list;
+        if (ve_row_list == nullptr)
+            continue;
+
+        auto stat = ve_row_list->ReadConnectedVertex(direction, edge_label,
+                                                     trx_id, begin_time, read_only, ret);
+        if (stat == READ_STAT::ABORT) {
+            trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+            return READ_STAT::ABORT;
+        }
+    }
+
+    return READ_STAT::SUCCESS;
+}
+
+READ_STAT DataStorage::GetConnectedEdgeListBatch(const vector<vid_t>& vids, const label_t& edge_label,
+                                                 const Direction_T& direction, const uint64_t& trx_id,
+                                                 const uint64_t& begin_time, const bool& read_only,
+                                                 vector<eid_t>& ret) {
+    for (int i = 0; i < vids.size(); i++) {
+        if (i + BATCH_PREFETCH_DISTANCE < vids.size())
+            vertex_table_.Prefetch(vids[i + BATCH_PREFETCH_DISTANCE]);
+
+        Vertex* vertex;
+        auto read_stat = GetVertex(vertex, vids[i], trx_id, begin_time, read_only);
+        if (read_stat == READ_STAT::ABORT)
+            return READ_STAT::ABORT;
+        if (read_stat == READ_STAT::NOTFOUND)
+            continue;
+
+        TopologyRowList* ve_row_list = vertex->ve_row_list;
+        if (ve_row_list == nullptr)
+            continue;
+
+        auto stat = ve_row_list->ReadConnectedEdge(direction, edge_label,
+                                                   trx_id, begin_time, read_only, ret);
+        if (stat == READ_STAT::ABORT) {
+            trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+            return READ_STAT::ABORT;
+        }
+    }
+
+    return READ_STAT::SUCCESS;
+}
+
+READ_STAT DataStorage::GetVPBatch(const vector<vid_t>& vids, const vector<label_t>& p_key,
+                                  const uint64_t& trx_id, const uint64_t& begin_time, const bool& read_only,
+                                  vector<pair<label_t, value_t>>& ret, vector<size_t>& offsets, vector<bool>& found) {
+    offsets.resize(vids.size() + 1);
+    found.assign(vids.size(), false);
+    offsets[0] = ret.size();
+
+    for (int i = 0; i < vids.size(); i++) {
+        if (i + BATCH_PREFETCH_DISTANCE < vids.size())
+            vertex_table_.Prefetch(vids[i + BATCH_PREFETCH_DISTANCE]);
+
+        Vertex* vertex;
+        auto read_stat = GetVertex(vertex, vids[i], trx_id, begin_time, read_only);
+        if (read_stat == READ_STAT::ABORT)
+            return READ_STAT::ABORT;
+
+        // vertex->vp_row_list can be detached by VertexTable::Erase concurrently, load it only once
+        PropertyRowList<VertexPropertyRow>* vp_row_list = nullptr;
+        if (read_stat == READ_STAT::SUCCESS)
+            vp_row_list = vertex->vp_row_list;
+
+        if (vp_row_list != nullptr) {
+            found[i] = true;
+            READ_STAT stat;
+            if (p_key.empty())
+                stat = vp_row_list->ReadAllProperty(trx_id, begin_time, read_only, ret);
+            else
+                stat = vp_row_list->ReadPropertyByPKeyList(p_key, trx_id, begin_time, read_only, ret);
+
+            if (stat == READ_STAT::ABORT) {
+                trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+                return READ_STAT::ABORT;
+            }
+        }
+
+        offsets[i + 1] = ret.size();
+    }
+
+    return READ_STAT::SUCCESS;
+}
+
+READ_STAT DataStorage::GetEPBatch(const vector<eid_t>& eids, const vector<label_t>& p_key,
+                                  const uint64_t& trx_id, const uint64_t& begin_time, const bool& read_only,
+                                  vector<pair<label_t, value_t>>& ret, vector<size_t>& offsets, vector<bool>& found) {
+    offsets.resize(eids.size() + 1);
+    found.assign(eids.size(), false);
+    offsets[0] = ret.size();
+
+    // Lock once for the whole batch
+    ReaderLockGuard reader_lock_guard(out_edge_erase_rwlock_);
+    for (int i = 0; i < eids.size(); i++) {
+        EdgeVersion edge_version;
+        auto read_stat = GetOutEdgeVersionWithoutLock(eids[i], trx_id, begin_time, read_only, edge_version);
+        if (read_stat == READ_STAT::ABORT)
+            return READ_STAT::ABORT;
+
+        if (read_stat == READ_STAT::SUCCESS) {
+            found[i] = true;
+            READ_STAT stat;
+            if (p_key.empty())
+                stat = edge_version.ep_row_list->ReadAllProperty(trx_id, begin_time, read_only, ret);
+            else
+                stat = edge_version.ep_row_list->ReadPropertyByPKeyList(p_key, trx_id, begin_time, read_only, ret);
+
+            if (stat == READ_STAT::ABORT) {
+                trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+                return READ_STAT::ABORT;
+            }
+        }
+
+        offsets[i + 1] = ret.size();
+    }
+
+    return READ_STAT::SUCCESS;
+}
+
 void DataStorage::InsertAggData(agg_t key, vector<value_t> & data) {
     lock_guard<mutex> lock(agg_mutex);
 
@@ -896,7 +1115,8 @@ vid_t DataStorage::AssignVID() {
  * instance will be modified. InsertTrxProcessHistory will record the pointer of MVCCList in corresponding trx's
  * TrxProcessHistory, used when calling Abort or Commit.
  */
-void DataStorage::InsertTrxProcessHistory(const uint64_t& trx_id, const TrxProcessHistory::ProcessType& type, void* mvcc_list) {
+void DataStorage::InsertTrxProcessHistory(const uint64_t& trx_id, const TrxProcessHistory::ProcessType& type,
+                                          void* mvcc_list, const vid_t& vid) {
     CHECK(type != TrxProcessHistory::PROCESS_ADD_V);
     TransactionAccessor t_accessor;
     transaction_process_history_map_.insert(t_accessor, trx_id);
@@ -906,11 +1126,12 @@ void DataStorage::InsertTrxProcessHistory(const uint64_t& trx_id, const TrxProce
     q_item.mvcc_list = mvcc_list;
 
     t_accessor->second.process_vector.emplace_back(q_item);
+    t_accessor->second.touched_vid_set.emplace(vid.value());
 }
 
 /* However, if we want to abort AddV, the pointer of MVCCList is not enough, since we need to free vp_row_list
  * and ve_row_list attached to the Vertex. To free those row lists in the abort phase, vid is required to retrieve
- * the Vertex in the vertex_map_.
+ * the Vertex in the vertex_table_.
  */
 void DataStorage::InsertTrxAddVHistory(const uint64_t& trx_id, void* mvcc_list, vid_t vid) {
     TransactionAccessor t_accessor;
@@ -924,54 +1145,63 @@ void DataStorage::InsertTrxAddVHistory(const uint64_t& trx_id, void* mvcc_list,
 
     // store the vid in a map indexed with the pointer of MVCCList
     t_accessor->second.mvcclist_to_vid_map[mvcc_list] = vid.value();
+    t_accessor->second.touched_vid_set.emplace(vid.value());
+}
+
+/* When a transaction finishes, versions it replaced become garbage once GlobalMinBT > finish_time.
+ * GCProducer keeps the touched vertices until then, and rescans only those vertices instead of the whole vertex table.
+ */
+void DataStorage::PushTouchedVids(TrxProcessHistory& history, const uint64_t& finish_time) {
+    if (history.touched_vid_set.empty())
+        return;
+
+    vector<pair<vid_t, uint64_t>>* dirty_vids = new vector<pair<vid_t, uint64_t>>();
+    dirty_vids->reserve(history.touched_vid_set.size());
+    for (uint32_t vid : history.touched_vid_set)
+        dirty_vids->emplace_back(vid_t(vid), finish_time);
+    garbage_collector_->PushDirtyVidsToQueue(dirty_vids);
 }
 
 vid_t DataStorage::ProcessAddV(const label_t& label, const uint64_t& trx_id, const uint64_t& begin_time) {
     // Guaranteed that the vid is identical in the whole system, it's impossible to insert two vertices with the same vid
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
     vid_t vid = AssignVID();
 
-    // std::pair<VertexIterator iterator, bool insert_occurred>
-    auto insert_result = vertex_map_.insert(pair<uint32_t, Vertex>(vid.value(), Vertex()));
-    VertexIterator v_iterator = insert_result.first;
-    CHECK(insert_result.second) << "Vid " << to_string(vid.value()) << " already exist in vertex_map_";
+    Vertex* vertex = vertex_table_.Insert(vid);
 
-    v_iterator->second.label = label;
-    v_iterator->second.vp_row_list = new PropertyRowList<VertexPropertyRow>;
-    v_iterator->second.ve_row_list = new TopologyRowList;
+    vertex->label = label;
+    vertex->vp_row_list = new PropertyRowList<VertexPropertyRow>;
+    vertex->ve_row_list = new TopologyRowList;
 
-    v_iterator->second.ve_row_list->Init(vid);
-    v_iterator->second.vp_row_list->Init();
+    vertex->ve_row_list->Init(vid);
+    vertex->vp_row_list->Init();
 
     auto* mvcc_list = new MVCCList<VertexMVCCItem>;
 
     *(mvcc_list->AppendVersion(trx_id, begin_time)) = true;
 
-    v_iterator->second.mvcc_list = mvcc_list;
+    vertex->mvcc_list = mvcc_list;
 
-    InsertTrxAddVHistory(trx_id, v_iterator->second.mvcc_list, vid.value());
+    InsertTrxAddVHistory(trx_id, mvcc_list, vid.value());
 
     return vid;
 }
 
 PROCESS_STAT DataStorage::ProcessDropV(const vid_t& vid, const uint64_t& trx_id, const uint64_t& begin_time,
                                        vector<eid_t>& in_eids, vector<eid_t>& out_eids) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, false);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, false);
     if (read_stat != READ_STAT::SUCCESS)
         return (read_stat == READ_STAT::NOTFOUND) ? PROCESS_STAT::SUCCESS : PROCESS_STAT::ABORT;
 
     vector<eid_t> all_connected_edge;
-    // Do not need to acquire read lock for vertex_map_erase_rwlock_ in GetConnectedEdgeList
-    read_stat = GetConnectedEdgeList(vid, 0, BOTH, trx_id, begin_time, false, all_connected_edge, false);
+    read_stat = GetConnectedEdgeList(vid, 0, BOTH, trx_id, begin_time, false, all_connected_edge);
 
     if (read_stat != READ_STAT::SUCCESS) {
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
         return PROCESS_STAT::ABORT_DROP_V_GET_CONN_E;
     }
 
-    bool* mvcc_value_ptr = v_iterator->second.mvcc_list->AppendVersion(trx_id, begin_time);
+    bool* mvcc_value_ptr = vertex->mvcc_list->AppendVersion(trx_id, begin_time);
 
     // If AppendVersion returns nullptr, the transaction should be aborted. Similarly hereinafter.
     if (mvcc_value_ptr == nullptr) {
@@ -982,7 +1212,7 @@ PROCESS_STAT DataStorage::ProcessDropV(const vid_t& vid, const uint64_t& trx_id,
     // false ==> invisible
     *mvcc_value_ptr = false;
 
-    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_V, v_iterator->second.mvcc_list);
+    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_V, vertex->mvcc_list, vid);
 
     for (auto eid : all_connected_edge) {
         if (eid.src_v == vid.value()) {
@@ -1004,7 +1234,6 @@ PROCESS_STAT DataStorage::ProcessDropV(const vid_t& vid, const uint64_t& trx_id,
  */
 PROCESS_STAT DataStorage::ProcessAddE(const eid_t& eid, const label_t& label, const bool& is_out,
                                       const uint64_t& trx_id, const uint64_t& begin_time) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
     WritePriorRWLock* erase_rwlock_;
 
     InEdgeIterator in_e_iterator;
@@ -1034,14 +1263,21 @@ PROCESS_STAT DataStorage::ProcessAddE(const eid_t& eid, const label_t& label, co
 
     ReaderLockGuard edge_map_rlock_guard(*erase_rwlock_);
 
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, vid, trx_id, begin_time, false);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, vid, trx_id, begin_time, false);
     if (read_stat != READ_STAT::SUCCESS) {
-        if (read_stat != READ_STAT::ABORT)  // if ABORT, update_status is already called in GetVertexIterator
+        if (read_stat != READ_STAT::ABORT)  // if ABORT, update_status is already called in GetVertex
             trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
         return PROCESS_STAT::ABORT_ADD_E_INVISIBLE_V;
     }
 
+    // vertex->ve_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    TopologyRowList* ve_row_list = vertex->ve_row_list;
+    if (ve_row_list == nullptr) {
+        trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+        return PROCESS_STAT::ABORT_ADD_E_INVISIBLE_V;
+    }
+
     if (is_out) {
         // std::pair<OutEdgeIterator itr, bool insert_occurred>
         auto insert_result = out_edge_map_.insert(pair<uint64_t, OutEdge>(eid.value(), OutEdge()));
@@ -1067,7 +1303,7 @@ PROCESS_STAT DataStorage::ProcessAddE(const eid_t& eid, const label_t& label, co
         } else {
             ep_row_list = nullptr;
         }
-        mvcc_list = v_iterator->second.ve_row_list->ProcessAddEdge(is_out, adj_vid, label, ep_row_list, trx_id, begin_time);
+        mvcc_list = ve_row_list->ProcessAddEdge(is_out, adj_vid, label, ep_row_list, trx_id, begin_time);
         if (is_out) {
             out_e_iterator->second.mvcc_list = mvcc_list;
         } else {
@@ -1086,6 +1322,9 @@ PROCESS_STAT DataStorage::ProcessAddE(const eid_t& eid, const label_t& label, co
             return PROCESS_STAT::ABORT_MULTIPLE_TRX_ADD_SAME_EDGE;
         }
 
+        // the label cached in VertexEdgeRow should be invalidated before the new version is visible
+        ve_row_list->ProcessRelabelEdge(is_out, adj_vid, label);
+
         EdgeVersion* e_item = mvcc_list->AppendVersion(trx_id, begin_time);
 
         if (e_item == nullptr) {
@@ -1105,7 +1344,7 @@ PROCESS_STAT DataStorage::ProcessAddE(const eid_t& eid, const label_t& label, co
         e_item->ep_row_list = ep_row_list;
     }
 
-    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_ADD_E, mvcc_list);
+    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_ADD_E, mvcc_list, vid);
 
     return PROCESS_STAT::SUCCESS;
 }
@@ -1150,6 +1389,7 @@ PROCESS_STAT DataStorage::ProcessDropE(const eid_t& eid, const bool& is_out,
     } else {
         mvcc_list = in_e_iterator->second.mvcc_list;
     }
+
     EdgeVersion* e_item = mvcc_list->AppendVersion(trx_id, begin_time);
 
     if (e_item == nullptr) {
@@ -1161,24 +1401,29 @@ PROCESS_STAT DataStorage::ProcessDropE(const eid_t& eid, const bool& is_out,
     e_item->label = 0;
     e_item->ep_row_list = nullptr;
 
-    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_E, mvcc_list);
+    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_E, mvcc_list, is_out ? src_vid : dst_vid);
 
     return PROCESS_STAT::SUCCESS;
 }
 
 PROCESS_STAT DataStorage::ProcessModifyVP(const vpid_t& pid, const value_t& value, value_t& old_value,
                                           const uint64_t& trx_id, const uint64_t& begin_time) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, pid.vid, trx_id, begin_time, false);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, pid.vid, trx_id, begin_time, false);
     if (read_stat != READ_STAT::SUCCESS) {
-        if (read_stat != READ_STAT::ABORT)  // if ABORT, update_status is already called in GetVertexIterator
+        if (read_stat != READ_STAT::ABORT)  // if ABORT, update_status is already called in GetVertex
             trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
         return PROCESS_STAT::ABORT_MODIFY_VP_INVISIBLE_V;
     }
 
-    auto ret = v_iterator->second.vp_row_list->ProcessModifyProperty(pid, value, old_value, trx_id, begin_time);
+    // vertex->vp_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    PropertyRowList<VertexPropertyRow>* vp_row_list = vertex->vp_row_list;
+    if (vp_row_list == nullptr) {
+        trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+        return PROCESS_STAT::ABORT_MODIFY_VP_INVISIBLE_V;
+    }
+
+    auto ret = vp_row_list->ProcessModifyProperty(pid, value, old_value, trx_id, begin_time);
 
     // ret.second: pointer of MVCCList<VP>
     if (ret.second == nullptr) {
@@ -1193,7 +1438,7 @@ PROCESS_STAT DataStorage::ProcessModifyVP(const vpid_t& pid, const value_t& valu
     else
         process_type = TrxProcessHistory::PROCESS_ADD_VP;
 
-    InsertTrxProcessHistory(trx_id, process_type, ret.second);
+    InsertTrxProcessHistory(trx_id, process_type, ret.second, vid_t(pid.vid));
 
     return PROCESS_STAT::SUCCESS;
 }
@@ -1223,31 +1468,36 @@ PROCESS_STAT DataStorage::ProcessModifyEP(const epid_t& pid, const value_t& valu
     else
         process_type = TrxProcessHistory::PROCESS_ADD_EP;
 
-    InsertTrxProcessHistory(trx_id, process_type, ret.second);
+    InsertTrxProcessHistory(trx_id, process_type, ret.second, vid_t(pid.src_vid));
 
     return PROCESS_STAT::SUCCESS;
 }
 
 PROCESS_STAT DataStorage::ProcessDropVP(const vpid_t& pid, const uint64_t& trx_id, const uint64_t& begin_time, value_t & old_value) {
-    ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-
-    VertexConstIterator v_iterator;
-    auto read_stat = GetVertexIterator(v_iterator, pid.vid, trx_id, begin_time, false);
+    Vertex* vertex;
+    auto read_stat = GetVertex(vertex, pid.vid, trx_id, begin_time, false);
     if (read_stat != READ_STAT::SUCCESS) {
-        if (read_stat != READ_STAT::ABORT)  // if ABORT, update_status is already called in GetVertexIterator
+        if (read_stat != READ_STAT::ABORT)  // if ABORT, update_status is already called in GetVertex
             trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
         return PROCESS_STAT::ABORT_MODIFY_VP_INVISIBLE_V;
     }
 
+    // vertex->vp_row_list can be detached by VertexTable::Erase concurrently, load it only once
+    PropertyRowList<VertexPropertyRow>* vp_row_list = vertex->vp_row_list;
+    if (vp_row_list == nullptr) {
+        trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
+        return PROCESS_STAT::ABORT_MODIFY_VP_INVISIBLE_V;
+    }
+
     // ret: pointer of MVCCList<VP>
-    auto ret = v_iterator->second.vp_row_list->ProcessDropProperty(pid, trx_id, begin_time, old_value);
+    auto ret = vp_row_list->ProcessDropProperty(pid, trx_id, begin_time, old_value);
 
     if (ret == nullptr) {
         trx_table_stub_->update_status(trx_id, TRX_STAT::ABORT);
         return PROCESS_STAT::ABORT_DROP_VP_DROP;
     }
 
-    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_VP, ret);
+    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_VP, ret, vid_t(pid.vid));
 
     return PROCESS_STAT::SUCCESS;
 }
@@ -1269,7 +1519,7 @@ PROCESS_STAT DataStorage::ProcessDropEP(const epid_t& pid, const uint64_t& trx_i
         return PROCESS_STAT::ABORT_DROP_EP_DROP;
     }
 
-    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_EP, ret);
+    InsertTrxProcessHistory(trx_id, TrxProcessHistory::PROCESS_DROP_EP, ret, vid_t(pid.src_vid));
 
     return PROCESS_STAT::SUCCESS;
 }
@@ -1321,6 +1571,7 @@ void DataStorage::Commit(const uint64_t& trx_id, const uint64_t& commit_time) {
         }
     }
 
+    PushTouchedVids(t_accessor->second, commit_time);
     transaction_process_history_map_.erase(t_accessor);
 }
 
@@ -1371,14 +1622,13 @@ void DataStorage::Abort(const uint64_t& trx_id) {
         } else if (process_item.type == TrxProcessHistory::PROCESS_DROP_V ||
                    process_item.type == TrxProcessHistory::PROCESS_ADD_V) {
             // V related
-            // the erasure of vertex_map will be done by GC.
+            // the erasure of vertex_table will be done by GC.
             MVCCList<VertexMVCCItem>* v_mvcc_list = process_item.mvcc_list;
             v_mvcc_list->AbortVersion(trx_id);
             if (process_item.type == TrxProcessHistory::PROCESS_ADD_V) {
-                ReaderLockGuard reader_lock_guard(vertex_map_erase_rwlock_);
-                VertexIterator v_iterator = vertex_map_.find(mvcclist_to_vid_map[v_mvcc_list]);
+                Vertex* vertex = vertex_table_.Find(vid_t(mvcclist_to_vid_map[v_mvcc_list]));
 
-                if (v_iterator == vertex_map_.end()) {
+                if (vertex == nullptr) {
                     CHECK(false) << "[DataStorage] Cannot find vertex when aborting";
                 }
 
@@ -1386,16 +1636,21 @@ void DataStorage::Abort(const uint64_t& trx_id) {
                 vector<pair<eid_t, bool>> * deletable_eids = new vector<pair<eid_t, bool>>();
                 vid_t vid;
                 uint2vid_t(mvcclist_to_vid_map[v_mvcc_list], vid);
-                v_iterator->second.ve_row_list->SelfGarbageCollect(deletable_eids);
+                vertex->ve_row_list->SelfGarbageCollect(deletable_eids);
                 garbage_collector_->PushGCAbleEidToQueue(deletable_eids);
 
-                delete v_iterator->second.ve_row_list;
-                v_iterator->second.ve_row_list = nullptr;
-                v_iterator->second.vp_row_list->SelfGarbageCollect();
-                delete v_iterator->second.vp_row_list;
-                v_iterator->second.vp_row_list = nullptr;
-                v_iterator->second.mvcc_list->SelfGarbageCollect();
-                // Do not delete v_iterator->second.mvcc_list, since it will still be referred during scanning.
+                TopologyRowList* ve_row_list = vertex->ve_row_list;
+                vertex->ve_row_list = nullptr;
+                vertex->vp_row_list->SelfGarbageCollect();
+                PropertyRowList<VertexPropertyRow>* vp_row_list = vertex->vp_row_list;
+                vertex->vp_row_list = nullptr;
+                // Readers may still hold the pointers
+                EpochManager::GetInstance()->Retire([ve_row_list, vp_row_list]() {
+                    delete ve_row_list;
+                    delete vp_row_list;
+                });
+                vertex->mvcc_list->SelfGarbageCollect();
+                // Do not delete vertex->mvcc_list, since it will still be referred during scanning.
                 // Delete it during erasing v_map.
 
                 // The aborted MVCCList<V> is empty. In GC scanning, empty MVCCList<V> means "already marked to be erased".
@@ -1411,5 +1666,7 @@ void DataStorage::Abort(const uint64_t& trx_id) {
         }
     }
 
+    // Aborted versions are freed above, but cells of aborted edges are left in row lists until defrag
+    PushTouchedVids(t_accessor->second, 0);
     transaction_process_history_map_.erase(t_accessor);
 }
@@ -26,6 +26,7 @@
 #include "core/factory.hpp"
 #include "layout/hdfs_data_loader.hpp"
 #include "layout/layout_type.hpp"
+#include "layout/vertex_table.hpp"
 #include "utils/config.hpp"
 #include "utils/mymath.hpp"
 
@@ -77,6 +78,12 @@ struct TrxProcessHistory {
      * Used in DataStorage::Abort.
      */
     std::unordered_map<void*, uint32_t> mvcclist_to_vid_map;
+
+    /* Local vertices whose MVCCLists (including those of its properties and out edges) are modified.
+     * Modified in DataStorage::InsertTrxProcessHistory and DataStorage::InsertTrxAddVHistory.
+     * Passed to GCProducer in DataStorage::Commit and DataStorage::Abort, so that GC only rescans these vertices.
+     */
+    std::unordered_set<uint32_t> touched_vid_set;
 };
 
 class GCProducer;
@@ -94,6 +101,18 @@ class DataStorage {
     void FillVertexContainer();
     void FillEdgeContainer();
 
+    // ================ NUMA placement of containers ================
+    // NUMA node of each expert thread, -1 if unknown
+    vector<int> thread_nodes_;
+    // Nodes that loaded vertices are spread over, one entry per expert thread on the node. Empty if not NUMA-aware
+    vector<int> placement_nodes_;
+    // Let ConcurrentMemPool::Get() of tid serve from node
+    void SetContainerNode(int tid, int node);
+    // Rows and MVCCLists of a loaded vertex (and its edges) are allocated on this node
+    int GetPlacementNode(const vid_t& vid) const {
+        return placement_nodes_[(vid.value() / worker_size_) % placement_nodes_.size()];
+    }
+
 
     // ================ Printing the loading progress ================
     // For each type of tmp container (V, InE, OutE), how many line will be printed during its loading process.
@@ -148,16 +167,14 @@ class DataStorage {
     typedef tbb::concurrent_unordered_map<uint64_t, InEdge>::iterator InEdgeIterator;
     typedef tbb::concurrent_unordered_map<uint64_t, InEdge>::const_iterator InEdgeConstIterator;
 
-    tbb::concurrent_unordered_map<uint32_t, Vertex> vertex_map_;
-    typedef tbb::concurrent_unordered_map<uint32_t, Vertex>::iterator VertexIterator;
-    typedef tbb::concurrent_unordered_map<uint32_t, Vertex>::const_iterator VertexConstIterator;
+    // Lock-free for insert, find and erase, see VertexTable
+    VertexTable vertex_table_;
 
-    // These three locks are only used to avoid conflict between
+    // These two locks are only used to avoid conflict between
     // erase operator (always batch erase) and others (insert, find);
     // write_lock -> erase
     // read_lock -> others
     // concurrency for others is guaranteed by concurrent_unordered_map
-    WritePriorRWLock vertex_map_erase_rwlock_;
     WritePriorRWLock out_edge_erase_rwlock_;
     WritePriorRWLock in_edge_erase_rwlock_;
 
@@ -175,20 +192,30 @@ class DataStorage {
     typedef tbb::concurrent_hash_map<uint64_t, TrxProcessHistory>::const_accessor TransactionConstAccessor;
 
     // Record process type and pointer of MVCCList for non-readonly transaction.
-    void InsertTrxProcessHistory(const uint64_t& trx_id, const TrxProcessHistory::ProcessType& type, void* mvcc_list);
+    // vid is the local vertex that the MVCCList is attached to.
+    void InsertTrxProcessHistory(const uint64_t& trx_id, const TrxProcessHistory::ProcessType& type, void* mvcc_list, const vid_t& vid);
+    // Pass touched_vid_set of a finished transaction to GCProducer
+    void PushTouchedVids(TrxProcessHistory& history, const uint64_t& finish_time);
     // Specifically, for AddV operation, vid need to be recorded in addition
     void InsertTrxAddVHistory(const uint64_t& trx_id, void* mvcc_list, vid_t vid);
 
 
     // ================ Locate a vertex or an edge in the maps ================
-    READ_STAT CheckVertexVisibility(const VertexConstIterator& v_iterator, const uint64_t& trx_id,
+    READ_STAT CheckVertexVisibility(const Vertex* vertex, const uint64_t& trx_id,
                                     const uint64_t& begin_time, const bool& read_only);
-    READ_STAT GetVertexIterator(VertexConstIterator& v_iterator, const vid_t& vid, const uint64_t& trx_id,
-                                const uint64_t& begin_time, const bool& read_only);
+    READ_STAT GetVertex(Vertex*& vertex, const vid_t& vid, const uint64_t& trx_id,
+                        const uint64_t& begin_time, const bool& read_only);
     // for an eid, there can be multiple versions of edges
     READ_STAT GetOutEdgeVersion(const eid_t& eid, const uint64_t& trx_id, const uint64_t& begin_time,
                                 const bool& read_only, EdgeVersion& item_ref);
 
+    // the caller should hold the reader lock of out_edge_erase_rwlock_
+    READ_STAT GetOutEdgeVersionWithoutLock(const eid_t& eid, const uint64_t& trx_id, const uint64_t& begin_time,
+                                           const bool& read_only, EdgeVersion& item_ref);
+
+    // In batched data access, the Vertex of the element BATCH_PREFETCH_DISTANCE ahead is prefetched
+    static constexpr int BATCH_PREFETCH_DISTANCE = 4;
+
 
     // ================ Aggregated data related ================
     unordered_map<agg_t, vector<value_t>> agg_data_table;
@@ -230,7 +257,7 @@ class DataStorage {
                                      const bool& read_only, vector<vid_t>& ret);
     READ_STAT GetConnectedEdgeList(const vid_t& vid, const label_t& edge_label, const Direction_T& direction,
                                    const uint64_t& trx_id, const uint64_t& begin_time,
-                                   const bool& read_only, vector<eid_t>& ret, bool need_read_lock = true);
+                                   const bool& read_only, vector<eid_t>& ret);
     bool CheckVertexVisibilityWithVid(const uint64_t& trx_id, const uint64_t& begin_time, const bool& read_only, vid_t& vid);
 
 
@@ -251,6 +278,27 @@ class DataStorage {
     bool CheckEdgeVisibilityWithEid(const uint64_t& trx_id, const uint64_t& begin_time, const bool& read_only, eid_t& eid);
 
 
+    // ================ Batched data access ================
+    /* Batched versions of the functions above, reading all elements of a message with one transaction context.
+     * For the connected vertex/edge lists, the results of all input vertices are appended to ret.
+     * For the properties, results of input[i] are in ret[offsets[i], offsets[i + 1]), and found[i] is false if
+     * input[i] is invisible. An empty p_key means reading all properties.
+     * Returns ABORT once an element aborts (the transaction status is updated), otherwise SUCCESS.
+     */
+    READ_STAT GetConnectedVertexListBatch(const vector<vid_t>& vids, const label_t& edge_label, const Direction_T& direction,
+                                          const uint64_t& trx_id, const uint64_t& begin_time,
+                                          const bool& read_only, vector<vid_t>& ret);
+    READ_STAT GetConnectedEdgeListBatch(const vector<vid_t>& vids, const label_t& edge_label, const Direction_T& direction,
+                                        const uint64_t& trx_id, const uint64_t& begin_time,
+                                        const bool& read_only, vector<eid_t>& ret);
+    READ_STAT GetVPBatch(const vector<vid_t>& vids, const vector<label_t>& p_key,
+                         const uint64_t& trx_id, const uint64_t& begin_time, const bool& read_only,
+                         vector<pair<label_t, value_t>>& ret, vector<size_t>& offsets, vector<bool>& found);
+    READ_STAT GetEPBatch(const vector<eid_t>& eids, const vector<label_t>& p_key,
+                         const uint64_t& trx_id, const uint64_t& begin_time, const bool& read_only,
+                         vector<pair<label_t, value_t>>& ret, vector<size_t>& offsets, vector<bool>& found);
+
+
     // ================ Data modification ================
     vid_t ProcessAddV(const label_t& label, const uint64_t& trx_id, const uint64_t& begin_time);
     PROCESS_STAT ProcessDropV(const vid_t& vid, const uint64_t& trx_id, const uint64_t& begin_time,
@@ -285,6 +333,8 @@ class DataStorage {
     void DeleteAggData(uint64_t qid);
 
     // Initialization related
+    // NUMA node of each expert thread, -1 if unknown, called before Init()
+    void SetThreadNodes(const vector<int>& thread_nodes) { thread_nodes_ = thread_nodes; }
     void Init();
 
     // Dependency Read
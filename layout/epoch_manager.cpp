@@ -0,0 +1,80 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "layout/epoch_manager.hpp"
+
+#include "glog/logging.h"
+
+thread_local EpochManager::ThreadState EpochManager::thread_state_;
+
+EpochManager::ThreadState::~ThreadState() {
+    if (slot != nullptr) {
+        slot->epoch.store(QUIESCENT, std::memory_order_release);
+        slot->in_use.store(false, std::memory_order_release);
+    }
+}
+
+EpochManager::Slot* EpochManager::AcquireSlot() {
+    std::lock_guard<std::mutex> lock(slot_mutex_);
+
+    // Reuse a slot released by an exited thread
+    int slot_count = slot_count_.load(std::memory_order_relaxed);
+    for (int i = 0; i < slot_count; i++) {
+        if (!slots_[i].in_use.load(std::memory_order_acquire)) {
+            slots_[i].in_use.store(true, std::memory_order_relaxed);
+            return &slots_[i];
+        }
+    }
+
+    CHECK_LT(slot_count, MAX_THREAD_COUNT) << "[EpochManager] Too many reader threads";
+    slots_[slot_count].in_use.store(true, std::memory_order_relaxed);
+    slot_count_.store(slot_count + 1, std::memory_order_release);
+    return &slots_[slot_count];
+}
+
+void EpochManager::Retire(std::function<void()> deleter) {
+    // Readers entering after this increment cannot reach the unlinked memory
+    uint64_t epoch = global_epoch_.fetch_add(1, std::memory_order_seq_cst);
+
+    std::lock_guard<std::mutex> lock(retire_mutex_);
+    retired_.emplace_back(epoch, std::move(deleter));
+}
+
+void EpochManager::Reclaim() {
+    uint64_t min_epoch = QUIESCENT;
+    int slot_count = slot_count_.load(std::memory_order_acquire);
+    for (int i = 0; i < slot_count; i++) {
+        uint64_t epoch = slots_[i].epoch.load(std::memory_order_seq_cst);
+        if (epoch < min_epoch)
+            min_epoch = epoch;
+    }
+
+    std::vector<std::function<void()>> reclaimable;
+    {
+        std::lock_guard<std::mutex> lock(retire_mutex_);
+        size_t kept = 0;
+        for (size_t i = 0; i < retired_.size(); i++) {
+            // A reader with epoch e may refer to the memory retired at epoch >= e
+            if (retired_[i].first < min_epoch)
+                reclaimable.emplace_back(std::move(retired_[i].second));
+            else
+                retired_[kept++] = std::move(retired_[i]);
+        }
+        retired_.resize(kept);
+    }
+
+    // Deleters may retire more memory, thus they are called without retire_mutex_
+    for (auto& deleter : reclaimable)
+        deleter();
+}
@@ -0,0 +1,124 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/* Epoch-based reclamation for the memory that readers of TopologyRowList and PropertyRowList
+ * access without locks: rows, cell maps, MVCCLists of properties, and MVCCLists of edges erased from edge maps.
+ *
+ * Readers:
+ *   Hold an EpochGuard while they may touch such memory. Guards nest, and only the outermost guard of
+ *   a thread announces the global epoch (a store and a fence on its own cache line).
+ *   Experts hold a guard for each message, thus the row list reads inside only touch thread-local state.
+ *
+ * GC:
+ *   A GC task first unlinks memory from the row list, so that readers entering later cannot reach it,
+ *   and then calls Retire() with a function to free it. Retire() advances the global epoch.
+ *   Reclaim() calls the functions retired before the epoch of the oldest active reader.
+ *   Readers never wait for GC, and GC never waits for readers.
+ */
+class EpochManager {
+ public:
+    static constexpr int MAX_THREAD_COUNT = 1024;
+    static constexpr uint64_t QUIESCENT = UINT64_MAX;
+
+    static EpochManager* GetInstance() {
+        static EpochManager epoch_manager;
+        return &epoch_manager;
+    }
+
+    void Enter() {
+        ThreadState& state = thread_state_;
+        if (state.depth++ > 0)
+            return;
+
+        if (state.slot == nullptr)
+            state.slot = AcquireSlot();
+
+        state.slot->epoch.store(global_epoch_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        // The announcement must be visible to Reclaim() before reading any pointer in row lists
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void Exit() {
+        ThreadState& state = thread_state_;
+        if (--state.depth > 0)
+            return;
+
+        state.slot->epoch.store(QUIESCENT, std::memory_order_release);
+    }
+
+    // The memory freed by deleter should have been unlinked from row lists
+    void Retire(std::function<void()> deleter);
+
+    // Call the deleters that no active reader can refer to, in the calling thread
+    void Reclaim();
+
+ private:
+    EpochManager() : global_epoch_(0), slot_count_(0) {}
+    EpochManager(const EpochManager&);
+    ~EpochManager() {}
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch;
+        std::atomic<bool> in_use;
+
+        Slot() : epoch(QUIESCENT), in_use(false) {}
+    };
+
+    // Released when the thread exits
+    struct ThreadState {
+        Slot* slot = nullptr;
+        int depth = 0;
+
+        ~ThreadState();
+    };
+
+    Slot* AcquireSlot();
+
+    static thread_local ThreadState thread_state_;
+
+    std::atomic<uint64_t> global_epoch_;
+
+    Slot slots_[MAX_THREAD_COUNT];
+    // slots_[0, slot_count_) have been used
+    std::atomic<int> slot_count_;
+    std::mutex slot_mutex_;
+
+    // <epoch when retired, deleter>
+    std::vector<std::pair<uint64_t, std::function<void()>>> retired_;
+    std::mutex retire_mutex_;
+};
+
+class EpochGuard {
+ public:
+    EpochGuard() {
+        EpochManager::GetInstance()->Enter();
+    }
+
+    ~EpochGuard() {
+        EpochManager::GetInstance()->Exit();
+    }
+
+ private:
+    EpochGuard(const EpochGuard&);
+    EpochGuard& operator=(const EpochGuard&);
+};
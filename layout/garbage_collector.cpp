@@ -141,6 +141,14 @@ bool GarbageCollector::PopGCAbleVidFromQueue(vid_t& vid) {
     return gcable_vid_queue.try_pop(vid);
 }
 
+void GarbageCollector::PushDirtyVidsToQueue(vector<pair<vid_t, uint64_t>>* vec_p) {
+    dirty_vid_queue.push(vec_p);
+}
+
+bool GarbageCollector::PopDirtyVidsFromQueue(vector<pair<vid_t, uint64_t>>*& vec_p) {
+    return dirty_vid_queue.try_pop(vec_p);
+}
+
 string GarbageCollector::GetDepGCTaskStatusStatistics() {
     string ret;
     for (int i = 0; i < (int)DepGCTaskType::COUNT; i++) {
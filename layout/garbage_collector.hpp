@@ -45,6 +45,8 @@ class GarbageCollector {
     bool PopGCAbleEidFromQueue(vector<pair<eid_t, bool>>*&);
     void PushGCAbleVidToQueue(vid_t);
     bool PopGCAbleVidFromQueue(vid_t&);
+    void PushDirtyVidsToQueue(vector<pair<vid_t, uint64_t>>*);
+    bool PopDirtyVidsFromQueue(vector<pair<vid_t, uint64_t>>*&);
 
     // Used in StatusExpert
     string GetDepGCTaskStatusStatistics();
@@ -65,6 +67,10 @@ class GarbageCollector {
     tbb::concurrent_queue<vector<pair<eid_t, bool>>*> gcable_eid_queue;
     tbb::concurrent_queue<vid_t> gcable_vid_queue;
 
+    // Vertices touched by finished transactions, with the commit time (0 if aborted).
+    // Pushed by DataStorage::Commit/Abort, and GCProducer only rescans these vertices in most rounds
+    tbb::concurrent_queue<vector<pair<vid_t, uint64_t>>*> dirty_vid_queue;
+
     // the pointer of job instances in GCProducer
     DependentGCJob* producer_jobs_[(int)DepGCTaskType::COUNT];
 
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "layout/gc_consumer.hpp"
+#include "layout/epoch_manager.hpp"
 #include "layout/garbage_collector.hpp"
 #include "layout/pmt_rct_table.hpp"
 
@@ -109,19 +110,17 @@ void GCConsumer::Execute() {
 
         // After finish a task, push it back to GarbageCollector
         garbage_collector_->PushJobToFinishedQueue(job);
+
+        // Free the memory retired by this and other jobs, if no reader can refer to it anymore
+        EpochManager::GetInstance()->Reclaim();
     }
 }
 
 void GCConsumer::ExecuteEraseVJob(EraseVJob * job) {
-    // Erase a set of vertices from vertex_map in data_storage
-    WriterLockGuard writer_lock_guard(data_storage_->vertex_map_erase_rwlock_);
+    // Erase a set of vertices from vertex_table in data_storage
     for (auto t : job->tasks_) {
         CHECK(t != nullptr);
-        auto iterator = data_storage_->vertex_map_.find(static_cast<EraseVTask*>(t)->target.value());
-        CHECK(iterator != data_storage_->vertex_map_.end());
-
-        delete iterator->second.mvcc_list;
-        data_storage_->vertex_map_.unsafe_erase(iterator);
+        data_storage_->vertex_table_.Erase(static_cast<EraseVTask*>(t)->target);
     }
 }
 
@@ -138,7 +137,8 @@ void GCConsumer::ExecuteEraseOutEJob(EraseOutEJob * job) {
             MVCCList<EdgeMVCCItem>* mvcc_list = out_e_iterator->second.mvcc_list;
             CHECK(mvcc_list != nullptr);
             if (mvcc_list->head_ != nullptr) { continue; }  // // this edge was added back after its deletion
-            delete mvcc_list;
+            // Readers of rows retired by SelfGarbageCollect/SelfDefragment may still refer to it
+            EpochManager::GetInstance()->Retire([mvcc_list]() { delete mvcc_list; });
             data_storage_->out_edge_map_.unsafe_erase(eid_value);
         }
     }
@@ -157,7 +157,8 @@ void GCConsumer::ExecuteEraseInEJob(EraseInEJob * job) {
             MVCCList<EdgeMVCCItem>* mvcc_list = in_e_iterator->second.mvcc_list;
             CHECK(mvcc_list != nullptr);
             if (mvcc_list->head_ != nullptr) { continue; }  // // this edge was added back after its deletion
-            delete mvcc_list;
+            // Readers of rows retired by SelfGarbageCollect/SelfDefragment may still refer to it
+            EpochManager::GetInstance()->Retire([mvcc_list]() { delete mvcc_list; });
             data_storage_->in_edge_map_.unsafe_erase(eid_value);
         }
     }
@@ -271,7 +272,8 @@ void GCConsumer::ExecuteTopoRowListGCJob(TopoRowListGCJob* job) {
         TopologyRowList* target = static_cast<TopoRowListGCTask*>(t)->target;
         CHECK(target != nullptr);
         target->SelfGarbageCollect(gcable_eid);
-        delete target;
+        // Readers may still hold the pointer
+        EpochManager::GetInstance()->Retire([target]() { delete target; });
     }
     garbage_collector_->PushGCAbleEidToQueue(gcable_eid);
 }
@@ -299,7 +301,7 @@ void GCConsumer::ExecuteTopoRowListDefragJob(TopoRowListDefragJob* job) {
             if (out_e_iterator != data_storage_->out_edge_map_.end()) {
                 MVCCList<EdgeMVCCItem>* mvcc_list = out_e_iterator->second.mvcc_list;
                 CHECK(mvcc_list->head_ == nullptr);
-                delete mvcc_list;
+                EpochManager::GetInstance()->Retire([mvcc_list]() { delete mvcc_list; });
                 data_storage_->out_edge_map_.unsafe_erase(p.first.value());
             }
         } else {
@@ -307,7 +309,7 @@ void GCConsumer::ExecuteTopoRowListDefragJob(TopoRowListDefragJob* job) {
             if (in_e_iterator != data_storage_->in_edge_map_.end()) {
                 MVCCList<EdgeMVCCItem>* mvcc_list = in_e_iterator->second.mvcc_list;
                 CHECK(mvcc_list->head_ == nullptr);
-                delete mvcc_list;
+                EpochManager::GetInstance()->Retire([mvcc_list]() { delete mvcc_list; });
                 data_storage_->in_edge_map_.unsafe_erase(p.first.value());
             }
         }
@@ -320,7 +322,7 @@ void GCConsumer::ExecuteVPRowListGCJob(VPRowListGCJob* job) {
         PropertyRowList<VertexPropertyRow>* target = static_cast<VPRowListGCTask*>(t)->target;
         CHECK(target != nullptr);
         target->SelfGarbageCollect();
-        delete target;
+        EpochManager::GetInstance()->Retire([target]() { delete target; });
     }
 }
 
@@ -340,7 +342,7 @@ void GCConsumer::ExecuteEPRowListGCJob(EPRowListGCJob* job) {
         PropertyRowList<EdgePropertyRow>* target = static_cast<EPRowListGCTask*>(t)->target;
         CHECK(target != nullptr);
         target->SelfGarbageCollect();
-        delete target;
+        EpochManager::GetInstance()->Retire([target]() { delete target; });
     }
 }
 
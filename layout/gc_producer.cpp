@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "layout/gc_producer.hpp"
+#include "layout/epoch_manager.hpp"
 #include "layout/garbage_collector.hpp"
 
 GCTaskDAG::GCTaskDAG() {
@@ -482,6 +483,7 @@ void GCProducer::Init() {
     node_ = Node::StaticInstance();
     running_trx_list_ = RunningTrxList::GetInstance();
     rct_table_ = RCTable::GetInstance();
+    num_scanner_ = config_->num_gc_producer;
 
     // Put thread at the end of Init()
     scanner_ = thread(&GCProducer::Execute, this);
@@ -493,11 +495,19 @@ void GCProducer::Stop() {
 
 void GCProducer::Execute() {
     while (true) {
-        // Do Scan with DFS for whole DataStorage
         uint64_t start_time = timer::get_usec();
         running_trx_list_->UpdateGlobalMinBT();
 
-        scan_vertex_map();
+        // Rescan the vertices touched by finished transactions.
+        // Do Scan with DFS for whole DataStorage only every GC_Full_Scan_Period rounds
+        collect_dirty_vids();
+        bool full_scan = (++round_count_ >= config_->GC_Full_Scan_Period);
+        if (full_scan) {
+            round_count_ = 0;
+            scan_vertex_map();
+        }
+        size_t dirty_vid_count = dirty_vid_map_.size();
+        scan_dirty_vertices(full_scan);
 
         // Scan Index Store
         scan_topo_index_update_region();
@@ -508,8 +518,11 @@ void GCProducer::Execute() {
 
         uint64_t end_time = timer::get_usec();
 
-        cout << "[Node " << node_.get_local_rank() << "][GCProducer] Scan Time: " << ((end_time - start_time) / 1000)
-             << "ms, container usage: " << data_storage_->GetContainerUsage() * 100 << "%" << endl;
+        if (full_scan) {
+            cout << "[Node " << node_.get_local_rank() << "][GCProducer] Scan Time: " << ((end_time - start_time) / 1000)
+                 << "ms, dirty vertices: " << dirty_vid_count
+                 << ", container usage: " << data_storage_->GetContainerUsage() * 100 << "%" << endl;
+        }
 
         // Currently, sleep for a while and the do next scan
         sleep(SCAN_PERIOD);
@@ -524,49 +537,98 @@ void GCProducer::Execute() {
 
 
 void GCProducer::scan_vertex_map() {
-    // Scan the vertex map
-    ReaderLockGuard reader_lock_guard(data_storage_->vertex_map_erase_rwlock_);
-    for (auto v_pair = data_storage_->vertex_map_.begin(); v_pair != data_storage_->vertex_map_.end(); v_pair++) {
-        auto& v_item = v_pair->second;
+    // Scan the vertex table, each scanner takes every num_scanner_-th segment
+    parallel_scan([&](int scanner_id, vector<ScannedGCTask>& scanned_tasks) {
+        // Vertices may be erased by GCConsumer during the scan
+        EpochGuard epoch_guard;
+        data_storage_->vertex_table_.ForEach([&](vid_t vid, Vertex& v_item) {
+            scan_vertex(vid, v_item, scanned_tasks);
+        }, scanner_id, num_scanner_);
+    });
+}
 
-        MVCCList<VertexMVCCItem>* mvcc_list = v_item.mvcc_list;
-        if (mvcc_list == nullptr) { continue; }  // the insertion is not finished
+void GCProducer::collect_dirty_vids() {
+    vector<pair<vid_t, uint64_t>>* dirty_vids;
+    while (garbage_collector_->PopDirtyVidsFromQueue(dirty_vids)) {
+        for (auto& dirty_vid : *dirty_vids) {
+            uint64_t& finish_time = dirty_vid_map_[dirty_vid.first];
+            finish_time = max(finish_time, dirty_vid.second);
+        }
+        delete dirty_vids;
+    }
+}
 
-        SimpleSpinLockGuard lock_guard(&(mvcc_list->lock_));
+void GCProducer::scan_dirty_vertices(bool full_scanned) {
+    uint64_t global_min_bt = running_trx_list_->GetGlobalMinBT();
+    vector<vid_t> scannable_vids;
+    for (auto itr = dirty_vid_map_.begin(); itr != dirty_vid_map_.end();) {
+        // Versions replaced by the transaction are still visible to some running transaction
+        if (itr->second >= global_min_bt) {
+            itr++;
+            continue;
+        }
 
-        VertexMVCCItem* mvcc_item = mvcc_list->GetHead();
-        if (mvcc_item == nullptr) { continue; }  // already marked to be erased
+        if (!full_scanned)
+            scannable_vids.emplace_back(itr->first);
+        itr = dirty_vid_map_.erase(itr);
+    }
 
-        // Uncommitted new vertex, ignore
-        if (mvcc_item->GetTransactionID() != 0) { continue; }
+    if (scannable_vids.empty())
+        return;
 
-        // VertexMVCCList is different with other MVCCList since it only has at most
-        // two versions and the second version must be deleted version
-        // Therefore, if the first version is unvisible to any transaction
-        // (i.e. version->end_time < MINIMUM_ACTIVE_TRANSACTION_BT), the vertex can be GC.
-        vid_t vid;
-        uint2vid_t(v_pair->first, vid);
+    // Partitioned by segments of VertexTable, the same as scan_vertex_map
+    parallel_scan([&](int scanner_id, vector<ScannedGCTask>& scanned_tasks) {
+        EpochGuard epoch_guard;
+        for (const vid_t& vid : scannable_vids) {
+            if (data_storage_->vertex_table_.GetSegmentId(vid) % num_scanner_ != scanner_id)
+                continue;
+
+            Vertex* v_item = data_storage_->vertex_table_.Find(vid);
+            // nullptr if already erased
+            if (v_item != nullptr)
+                scan_vertex(vid, *v_item, scanned_tasks);
+        }
+    });
+}
+
+void GCProducer::scan_vertex(vid_t vid, Vertex& v_item, vector<ScannedGCTask>& scanned_tasks) {
+    MVCCList<VertexMVCCItem>* mvcc_list = v_item.mvcc_list;
+    if (mvcc_list == nullptr) { return; }  // already erased
 
-        if (mvcc_item->GetEndTime() < running_trx_list_->GetGlobalMinBT()) {
-            // Deleted vertex, GCable
+    SimpleSpinLockGuard lock_guard(&(mvcc_list->lock_));
+
+    VertexMVCCItem* mvcc_item = mvcc_list->GetHead();
+    if (mvcc_item == nullptr) { return; }  // already marked to be erased
+
+    // Uncommitted new vertex, ignore
+    if (mvcc_item->GetTransactionID() != 0) { return; }
+
+    // VertexMVCCList is different with other MVCCList since it only has at most
+    // two versions and the second version must be deleted version
+    // Therefore, if the first version is unvisible to any transaction
+    // (i.e. version->end_time < MINIMUM_ACTIVE_TRANSACTION_BT), the vertex can be GC.
+    if (mvcc_item->GetEndTime() < running_trx_list_->GetGlobalMinBT()) {
+        // Deleted vertex, GCable
+        {
+            MVCCList<VertexMVCCItem>::SeqWriteScope seq_write_scope(mvcc_list);
             mvcc_list->head_ = nullptr;
             mvcc_list->tail_ = nullptr;
             mvcc_list->pre_tail_ = nullptr;
             mvcc_list->tmp_pre_tail_ = nullptr;
-
-            spawn_erase_vertex_gctask(vid);
-            spawn_v_mvcc_gctask(mvcc_item);
-            spawn_vp_row_list_gctask(v_item.vp_row_list, vid);
-            spawn_topo_row_list_gctask(v_item.ve_row_list, vid);
-        } else {
-            // go deeper, to prop first and then topo
-            scan_prop_row_list(vid.value(), v_item.vp_row_list);
-            scan_topo_row_list(vid, v_item.ve_row_list);
         }
+
+        scanned_tasks.emplace_back(ScannedGCTask::ERASE_V, nullptr, vid.value(), 1);
+        scanned_tasks.emplace_back(ScannedGCTask::V_MVCC, mvcc_item, vid.value(), 1);
+        scanned_tasks.emplace_back(ScannedGCTask::VP_ROW_LIST, v_item.vp_row_list, vid.value(), 1);
+        scanned_tasks.emplace_back(ScannedGCTask::TOPO_ROW_LIST, v_item.ve_row_list, vid.value(), 1);
+    } else {
+        // go deeper, to prop first and then topo
+        scan_prop_row_list(vid.value(), v_item.vp_row_list, scanned_tasks);
+        scan_topo_row_list(vid, v_item.ve_row_list, scanned_tasks);
     }
 }
 
-void GCProducer::scan_topo_row_list(const vid_t& vid, TopologyRowList* topo_row_list) {
+void GCProducer::scan_topo_row_list(const vid_t& vid, TopologyRowList* topo_row_list, vector<ScannedGCTask>& scanned_tasks) {
     if (topo_row_list == nullptr) { return; }
     ReaderLockGuard reader_lock_guard(topo_row_list->gc_rwlock_);
     pthread_spin_lock(&(topo_row_list->lock_));
@@ -593,7 +655,7 @@ void GCProducer::scan_topo_row_list(const vid_t& vid, TopologyRowList* topo_row_
 
         MVCCList<EdgeMVCCItem>* cur_edge_mvcc_list = adjacent_edge_header->mvcc_list;
         // scan attached mvcc list and count empty cell
-        if (scan_mvcc_list(eid.value(), cur_edge_mvcc_list)) {
+        if (scan_mvcc_list(eid.value(), cur_edge_mvcc_list, scanned_tasks)) {
             gcable_cell_count++;
         }
     }
@@ -605,7 +667,48 @@ void GCProducer::scan_topo_row_list(const vid_t& vid, TopologyRowList* topo_row_
 
     // spawn defrag task when one or more rows can be recycled
     if (original_row_count > after_row_count) {
-        spawn_topo_row_list_defrag_gctask(topo_row_list, vid, gcable_cell_count);
+        scanned_tasks.emplace_back(ScannedGCTask::TOPO_ROW_DEFRAG, topo_row_list, vid.value(), gcable_cell_count);
+    }
+}
+
+void GCProducer::spawn_scanned_tasks(vector<ScannedGCTask>& scanned_tasks) {
+    for (ScannedGCTask& task : scanned_tasks) {
+        vid_t vid;
+        uint2vid_t(task.element_id, vid);
+        switch (task.type) {
+          case ScannedGCTask::ERASE_V:
+            spawn_erase_vertex_gctask(vid);
+            break;
+          case ScannedGCTask::V_MVCC:
+            spawn_v_mvcc_gctask(static_cast<VertexMVCCItem*>(task.target));
+            break;
+          case ScannedGCTask::VP_MVCC:
+            spawn_vp_mvcc_list_gctask(static_cast<VPropertyMVCCItem*>(task.target), task.cost);
+            break;
+          case ScannedGCTask::EP_MVCC:
+            spawn_ep_mvcc_list_gctask(static_cast<EPropertyMVCCItem*>(task.target), task.cost);
+            break;
+          case ScannedGCTask::EDGE_MVCC:
+            spawn_edge_mvcc_list_gctask(static_cast<EdgeMVCCItem*>(task.target), task.element_id, task.cost);
+            break;
+          case ScannedGCTask::VP_ROW_LIST:
+            spawn_vp_row_list_gctask(static_cast<PropertyRowList<VertexPropertyRow>*>(task.target), vid);
+            break;
+          case ScannedGCTask::TOPO_ROW_LIST:
+            spawn_topo_row_list_gctask(static_cast<TopologyRowList*>(task.target), vid);
+            break;
+          case ScannedGCTask::VP_ROW_DEFRAG:
+            spawn_vp_row_defrag_gctask(static_cast<PropertyRowList<VertexPropertyRow>*>(task.target),
+                                       task.element_id, task.cost);
+            break;
+          case ScannedGCTask::EP_ROW_DEFRAG:
+            spawn_ep_row_defrag_gctask(static_cast<PropertyRowList<EdgePropertyRow>*>(task.target),
+                                       task.element_id, task.cost);
+            break;
+          case ScannedGCTask::TOPO_ROW_DEFRAG:
+            spawn_topo_row_list_defrag_gctask(static_cast<TopologyRowList*>(task.target), vid, task.cost);
+            break;
+        }
     }
 }
 
@@ -30,16 +30,45 @@
 /* GCProducer encapsulates methods to scan the whole data layout and generate garbage collection tasks to
  * free memory allocated for those objects that are invisible to all transactions in the system.
  *
- * In GCProducer, a single thread will regularly scan the whole data layout and generates GC tasks.
+ * In GCProducer, the producer thread will regularly scan the data layout and generates GC tasks.
  * If the sum of costs of a specific type of GC task has reach the given threshold, all tasks of this
  * type will be packed as a Job and push to GCConsumer.
  *
+ * The vertex scan is sharded across num_gc_producer scanner threads, each owning a partition of vid ranges
+ * (segments of VertexTable). A scanner only cuts MVCCLists of its own vertices and records the GC tasks found
+ * as ScannedGCTask; the producer thread then spawns them partition by partition.
+ *
  * GCProducer maintains containers (jobs) of unpushed tasks.
  * For tasks with dependency, their pointers are also stored in the GCTaskDAG.
+ * Both are only modified by the producer thread.
  */
 
 class GarbageCollector;
 
+// A GC task found by a scanner thread, to be spawned by the producer thread
+struct ScannedGCTask {
+    enum Type {
+        ERASE_V,
+        V_MVCC,
+        VP_MVCC,
+        EP_MVCC,
+        EDGE_MVCC,
+        VP_ROW_LIST,
+        TOPO_ROW_LIST,
+        VP_ROW_DEFRAG,
+        EP_ROW_DEFRAG,
+        TOPO_ROW_DEFRAG
+    };
+
+    Type type;
+    void* target;  // nullptr for ERASE_V
+    uint64_t element_id;  // vid, eid or the id of the element owning the target
+    int cost;
+
+    ScannedGCTask(Type _type, void* _target, uint64_t _element_id, int _cost) :
+        type(_type), target(_target), element_id(_element_id), cost(_cost) {}
+};
+
 /*
 The dependency of dependent tasks can form a DAG.
 
@@ -292,16 +321,40 @@ class GCProducer {
 
     // Scan Period (unit:sec)
     // For every SCAN_PERIOD, producer scan once;
-    const int SCAN_PERIOD = 5;
+    const int SCAN_PERIOD = 1;
+
+    // Count of threads scanning the vertex table, from Config::num_gc_producer
+    int num_scanner_;
+
+    // Vertices touched by finished transactions, mapped to the latest finish time.
+    // A vertex is rescanned once GlobalMinBT passes its finish time, and then removed.
+    // The whole vertex table is only scanned once every Config::GC_Full_Scan_Period rounds,
+    // as a background sweep for the garbage not reported by transactions.
+    unordered_map<vid_t, uint64_t, VidHash> dirty_vid_map_;
+    int round_count_ = 0;
 
     // -------Scanning Function---------
+    // Call scan_func(scanner_id, scanned_tasks) on num_scanner_ threads,
+    // and then spawn the tasks found by each scanner in the order of scanner_id
+    template <class ScanFunc>
+    void parallel_scan(const ScanFunc& scan_func);
+    void spawn_scanned_tasks(vector<ScannedGCTask>&);
+
     void scan_vertex_map();
-    void scan_topo_row_list(const vid_t&, TopologyRowList*);
+    // Move vertices from GarbageCollector::dirty_vid_queue to dirty_vid_map_
+    void collect_dirty_vids();
+    // Scan the dirty vertices whose garbage is collectible.
+    // If the whole vertex table is already scanned in this round, they are just removed
+    void scan_dirty_vertices(bool full_scanned);
+
+    // Functions below are called by scanner threads. Found tasks are appended to the last argument
+    void scan_vertex(vid_t, Vertex&, vector<ScannedGCTask>&);
+    void scan_topo_row_list(const vid_t&, TopologyRowList*, vector<ScannedGCTask>&);
     // Scan RowList && MVCCList
     template <class PropertyRow>
-    void scan_prop_row_list(const uint64_t& element_id, PropertyRowList<PropertyRow>*);
+    void scan_prop_row_list(const uint64_t& element_id, PropertyRowList<PropertyRow>*, vector<ScannedGCTask>&);
     template <class MVCCItem>
-    bool scan_mvcc_list(const uint64_t& element_id, MVCCList<MVCCItem>*);
+    bool scan_mvcc_list(const uint64_t& element_id, MVCCList<MVCCItem>*, vector<ScannedGCTask>&);
 
     // Index Store Scan
     void scan_topo_index_update_region();
@@ -331,10 +384,6 @@ class GCProducer {
     void spawn_ep_row_list_gctask(PropertyRowList<EdgePropertyRow>*, eid_t&);
     void spawn_ep_row_defrag_gctask(PropertyRowList<EdgePropertyRow>*, const uint64_t& element_id, const int& cost);
 
-    template <class MVCCItem>
-    void spawn_mvcc_list_gctask(MVCCItem*, const uint64_t& element_id, const int& cost);
-    template <class PropertyRow>
-    void spawn_prop_row_defrag_gctask(PropertyRowList<PropertyRow>*, const uint64_t& element_id, const int& cost);
 
     // Index Store Task Spawn
     void spawn_topo_index_gctask(Element_T);
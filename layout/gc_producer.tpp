@@ -13,7 +13,8 @@
 // limitations under the License.
 
 template <class PropertyRow>
-void GCProducer::scan_prop_row_list(const uint64_t& element_id, PropertyRowList<PropertyRow> * prop_row_list) {
+void GCProducer::scan_prop_row_list(const uint64_t& element_id, PropertyRowList<PropertyRow> * prop_row_list,
+                                    vector<ScannedGCTask>& scanned_tasks) {
     if (prop_row_list == nullptr) { return; }
     ReaderLockGuard gc_reader_lock_guard(prop_row_list->gc_rwlock_);
 
@@ -36,7 +37,7 @@ void GCProducer::scan_prop_row_list(const uint64_t& element_id, PropertyRowList<
 
         cur_mvcc_list_ptr = row_ptr->cells_[cell_id_in_row].mvcc_list;
         // scan mvcc list and count empty cell
-        if (scan_mvcc_list(element_id, cur_mvcc_list_ptr)) {
+        if (scan_mvcc_list(element_id, cur_mvcc_list_ptr, scanned_tasks)) {
             gcable_cell_counter++;
         }
     }
@@ -48,13 +49,20 @@ void GCProducer::scan_prop_row_list(const uint64_t& element_id, PropertyRowList<
 
     // spawn defrag task when one or more rows can be recycled
     if (original_row_count > after_row_count) {
-        spawn_prop_row_defrag_gctask(prop_row_list, element_id, gcable_cell_counter);
+        ScannedGCTask::Type type = is_same<PropertyRow, VertexPropertyRow>::value ?
+                                   ScannedGCTask::VP_ROW_DEFRAG : ScannedGCTask::EP_ROW_DEFRAG;
+        scanned_tasks.emplace_back(type, prop_row_list, element_id, gcable_cell_counter);
     }
 }
 
 template <class MVCCItem>
-bool GCProducer::scan_mvcc_list(const uint64_t& element_id, MVCCList<MVCCItem>* mvcc_list) {
+bool GCProducer::scan_mvcc_list(const uint64_t& element_id, MVCCList<MVCCItem>* mvcc_list,
+                                vector<ScannedGCTask>& scanned_tasks) {
     static_assert(is_base_of<AbstractMVCCItem, MVCCItem>::value, "scan_mvcc_list must take MVCCList");
+    // VertexMVCCList is not scanned here
+    const ScannedGCTask::Type scanned_mvcc_list_type =
+        is_same<MVCCItem, VPropertyMVCCItem>::value ? ScannedGCTask::VP_MVCC :
+        is_same<MVCCItem, EPropertyMVCCItem>::value ? ScannedGCTask::EP_MVCC : ScannedGCTask::EDGE_MVCC;
     if (mvcc_list == nullptr) { return true; }
 
     SimpleSpinLockGuard lock_guard(&(mvcc_list->lock_));
@@ -92,7 +100,7 @@ bool GCProducer::scan_mvcc_list(const uint64_t& element_id, MVCCList<MVCCItem>*
                 break;
             } else {
                 CHECK(bool(is_same<EdgeMVCCItem, MVCCItem>::value));
-                scan_prop_row_list(element_id, ((EdgeMVCCItem*)cur_ptr)->GetValue().ep_row_list);
+                scan_prop_row_list(element_id, ((EdgeMVCCItem*)cur_ptr)->GetValue().ep_row_list, scanned_tasks);
             }
         }
 
@@ -101,12 +109,15 @@ bool GCProducer::scan_mvcc_list(const uint64_t& element_id, MVCCList<MVCCItem>*
     }
 
     if (gc_checkpoint != nullptr) {
+        typename MVCCList<MVCCItem>::SeqWriteScope seq_write_scope(mvcc_list);
         auto* new_head = gc_checkpoint->next;
         gc_checkpoint->next = nullptr;
 
-        spawn_mvcc_list_gctask(mvcc_list->head_, element_id, gc_version_count);
+        scanned_tasks.emplace_back(scanned_mvcc_list_type, mvcc_list->head_, element_id, gc_version_count);
         // Cut the mvcc_list down
         mvcc_list->head_ = new_head;  // Could be nullptr or a uncommitted version
+        if (new_head != nullptr)
+            new_head->prev = nullptr;
         if (gc_checkpoint == iterate_tail) {  // There is at most one left
             if (!uncommitted_version_exists) {
                 mvcc_list->tail_ = nullptr;
@@ -129,39 +140,20 @@ bool GCProducer::scan_mvcc_list(const uint64_t& element_id, MVCCList<MVCCItem>*
     return false;
 }
 
-/* For spawn_prop_row_defrag_gctask and spawn_mvcc_list_gctask, 
- *  We directly Cast pointer to specific class type
- *  which is dangerous but the most easy way to distinguish different types
- *  If our gcc could be updated to 7.x version
- *  we can use 'if constexpr' (c++17 feature but need 7.x gcc to support)
- *  to solve it with code commented in each function
- */
-template<class PropertyRow>
-void GCProducer::spawn_prop_row_defrag_gctask(PropertyRowList<PropertyRow> * prop_row_list,
-        const uint64_t& element_id, const int& gcable_cell_counter) {
-    if (is_same<PropertyRow, VertexPropertyRow>::value) {
-        spawn_vp_row_defrag_gctask((PropertyRowList<VertexPropertyRow>*)prop_row_list, element_id, gcable_cell_counter);
-    } else if (is_same<PropertyRow, EdgePropertyRow>::value) {
-        spawn_ep_row_defrag_gctask((PropertyRowList<EdgePropertyRow>*)prop_row_list, element_id, gcable_cell_counter);
+template <class ScanFunc>
+void GCProducer::parallel_scan(const ScanFunc& scan_func) {
+    vector<vector<ScannedGCTask>> scanned_tasks(num_scanner_);
+    if (num_scanner_ == 1) {
+        scan_func(0, scanned_tasks[0]);
     } else {
-        cout << "[GCProducer] Unexpected error in spawn_prop_row_defrag_gctask" << endl;
-        CHECK(false);
+        vector<thread> scanners;
+        for (int i = 0; i < num_scanner_; i++)
+            scanners.emplace_back([&scan_func, &scanned_tasks, i]() { scan_func(i, scanned_tasks[i]); });
+        for (auto& scanner : scanners)
+            scanner.join();
     }
-}
-
-
-template<class MVCCItem>
-void GCProducer::spawn_mvcc_list_gctask(MVCCItem* gc_header, const uint64_t& element_id, const int& gc_version_count) {
-    static_assert(is_base_of<AbstractMVCCItem, MVCCItem>::value, "spawn_mvcc_list_gc_task must take MVCCItem");
 
-    if (is_same<MVCCItem, VPropertyMVCCItem>::value) {
-        spawn_vp_mvcc_list_gctask((VPropertyMVCCItem*)gc_header, gc_version_count);
-    } else if (is_same<MVCCItem, EPropertyMVCCItem>::value) {
-        spawn_ep_mvcc_list_gctask((EPropertyMVCCItem*)gc_header, gc_version_count);
-    } else if (is_same<MVCCItem, EdgeMVCCItem>::value) {
-        spawn_edge_mvcc_list_gctask((EdgeMVCCItem*)gc_header, element_id, gc_version_count);
-    } else {
-        cout << "[GCProducer] VertexMVCCListGCTask should not be created in spawn_mvcc_list_gctask or there is a unexpected error" << endl;
-        CHECK(false);
-    }
+    // Merge: GCTaskDAG and jobs are only modified by the producer thread
+    for (auto& tasks : scanned_tasks)
+        spawn_scanned_tasks(tasks);
 }
@@ -193,7 +193,7 @@ class DependentGCTask : public AbstractGCTask {
     int blocked_count_ = 0;
 };
 
-// Erase a specific vid on vertex_map_
+// Erase a specific vid on vertex_table_
 class EraseVTask : public IndependentGCTask {
  public:
     vid_t target;
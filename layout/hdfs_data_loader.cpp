@@ -351,9 +351,49 @@ void HDFSDataLoader::GetStringIndexes() {
         }
     }
     hdfsCloseFile(fs, vpk_file);
+
+    // optional
+    GetStringDicts(fs, config_->HDFS_INDEX_PATH + "./vtx_property_dict", indexes_->str2vpk, indexes_->dict_vpks);
+    GetStringDicts(fs, config_->HDFS_INDEX_PATH + "./edge_property_dict", indexes_->str2epk, indexes_->dict_epks);
+    // The strings are the same on all workers, and so are the sorted codes
+    string_dict::GetInstance()->Sort();
     hdfsDisconnect(fs);
 }
 
+// Format
+// p_key [\t] string_value
+// Strings of all keys share one string_dict, whose codes are assigned by string_dict::Sort()
+void HDFSDataLoader::GetStringDicts(hdfsFS fs, const string& path, const unordered_map<string, label_t>& str2pk,
+                                    unordered_set<label_t>& dict_pkeys) {
+    if (hdfsExists(fs, path.c_str()) != 0)
+        return;
+
+    hdfsFile dict_file = get_r_handle(path.c_str(), fs);
+    LineReader dict_reader(fs, dict_file);
+    while (true) {
+        dict_reader.read_line();
+        if (!dict_reader.eof()) {
+            char * line = dict_reader.get_line();
+            char * pch = strchr(line, '\t');
+            if (pch == nullptr)
+                continue;
+            string key(line, pch);
+            string value(pch + 1);
+
+            // ignore unknown property keys
+            auto itr = str2pk.find(key);
+            if (itr == str2pk.end())
+                continue;
+
+            dict_pkeys.insert(itr->second);
+            string_dict::GetInstance()->Add(value);
+        } else {
+            break;
+        }
+    }
+    hdfsCloseFile(fs, dict_file);
+}
+
 void HDFSDataLoader::GetVertices() {
     const char * indir = config_->HDFS_VTX_SUBFOLDER.c_str();
 
@@ -472,7 +512,7 @@ void HDFSDataLoader::ToVP(char* line) {
     // insert label to VProperty
     V_KVpair v_pair;
     v_pair.key = vpid_t(vid, 0);
-    Tool::str2int(to_string(label), v_pair.value);
+    Tool::int2value_t(label, v_pair.value);
     // push to property_list of v
     vp->plist.push_back(v_pair);
 
@@ -548,7 +588,7 @@ void HDFSDataLoader::ToEP(char* line) {
     // insert label to EProperty
     E_KVpair e_pair;
     e_pair.key = epid_t(dst_v, src_v, 0);
-    Tool::str2int(to_string(label), e_pair.value);
+    Tool::int2value_t(label, e_pair.value);
     // push to property_list of v
     ep->plist.push_back(e_pair);
 
@@ -131,6 +131,8 @@ class HDFSDataLoader {
     TMPVertexInfo* ToVertex(char* line);
     void ToVP(char* line);
     void ToEP(char* line);
+    void GetStringDicts(hdfsFS fs, const string& path, const unordered_map<string, label_t>& str2pk,
+                        unordered_set<label_t>& dict_pkeys);
 
     bool ReadVertexSnapshot();
     void WriteVertexSnapshot();
@@ -247,6 +247,7 @@ void IndexStore::VtxSelfGarbageCollect(const uint64_t& threshold) {
     WriterLockGuard writer_lock_guard(vtx_topo_gc_rwlock_);
 
     vector<vid_t> addV_vec;
+    vector<label_t> addV_label_vec;
     set<vid_t> delV_set;
     // tbb::concurrent_vector does NOT support erase store
     // un-mergable elements into new vector and swap
@@ -268,6 +269,7 @@ void IndexStore::VtxSelfGarbageCollect(const uint64_t& threshold) {
             if (trx_stat == TRX_STAT::COMMITTED) {
                 if (up_elem.isAdd) {
                     addV_vec.emplace_back(vid);
+                    addV_label_vec.emplace_back(up_elem.label);
                 } else {
                     delV_set.emplace(vid);
                 }
@@ -298,8 +300,15 @@ void IndexStore::VtxSelfGarbageCollect(const uint64_t& threshold) {
 
     if (delV_set.size() != 0) {
         topo_vtx_data.erase(remove_if(topo_vtx_data.begin(), topo_vtx_data.end(), checkFunc), topo_vtx_data.end());
+        for (auto & label_pair : topo_vtx_label_data) {
+            vector<vid_t>& vec = label_pair.second;
+            vec.erase(remove_if(vec.begin(), vec.end(), checkFunc), vec.end());
+        }
     }
     topo_vtx_data.insert(topo_vtx_data.end(), addV_vec.begin(), addV_vec.end());
+    for (int i = 0; i < addV_vec.size(); i++) {
+        topo_vtx_label_data[addV_label_vec[i]].emplace_back(addV_vec[i]);
+    }
     vtx_update_list.swap(new_update_list);
 }
 
@@ -429,7 +438,7 @@ void IndexStore::PropSelfGarbageCollect(const uint64_t& threshold, const int& pi
 }
 
 void IndexStore::InsertToUpdateBuffer(const uint64_t& trx_id, vector<uint64_t>& ids, ID_T type, bool isAdd,
-                                      value_t* new_val = NULL, vector<value_t>* old_vals = NULL) {
+                                      value_t* new_val, vector<value_t>* old_vals, label_t label) {
     vector<update_element> up_list;
     if (old_vals != NULL) {
         CHECK(ids.size() == old_vals->size());
@@ -437,6 +446,7 @@ void IndexStore::InsertToUpdateBuffer(const uint64_t& trx_id, vector<uint64_t>&
 
     for (int i = 0; i < ids.size(); i++) {
         update_element up_elem(ids.at(i), isAdd, trx_id);
+        up_elem.label = label;
         if (new_val != NULL && old_vals != NULL) {  // ModifyToNew V/EP
             up_elem.isAdd = true;
             up_elem.set_modify_value(*new_val, PropertyUpdateT::MODIFY);
@@ -613,6 +623,65 @@ void IndexStore::ReadVtxTopoIndex(const uint64_t & trx_id, const uint64_t & begi
     }
 }
 
+void IndexStore::ReadVtxLabelIndex(const uint64_t & trx_id, const uint64_t & begin_time, const bool & read_only,
+                                   const vector<label_t> & labels, vector<vid_t> & data) {
+    auto matchFunc = [&](const label_t& label) {
+        return find(labels.begin(), labels.end(), label) != labels.end();
+    };
+
+    // Only the visibility of updated vertices is checked,
+    // all others are served from the label partition directly
+    vector<vid_t> addV_vec;
+    set<vid_t> delV_set;
+    for (int i = 0; i < vtx_update_list.size(); i++) {
+        update_element up_elem = vtx_update_list[i];
+        if (up_elem.element_id == 0) { continue; }
+        if (up_elem.isAdd && !matchFunc(up_elem.label)) { continue; }
+        vid_t vid;
+        uint2vid_t(up_elem.element_id, vid);
+        if (data_storage_->CheckVertexVisibilityWithVid(trx_id, begin_time, read_only, vid)) {
+            // Visible (For Add)
+            if (up_elem.isAdd) {
+                addV_vec.emplace_back(vid);
+            }
+        } else {
+            // Invisible (For Del)
+            if (!up_elem.isAdd) {
+                delV_set.emplace(vid);
+            }
+        }
+    }
+
+    auto checkFunc = [&](vid_t& vid) {
+        return delV_set.find(vid) != delV_set.end();
+    };
+
+    ReaderLockGuard reader_lock_guard(vtx_topo_gc_rwlock_);
+    data.clear();
+    for (auto & label : labels) {
+        auto itr = topo_vtx_label_data.find(label);
+        if (itr != topo_vtx_label_data.end()) {
+            data.insert(data.end(), itr->second.begin(), itr->second.end());
+        }
+    }
+    if (delV_set.size() != 0) {
+        data.erase(remove_if(data.begin(), data.end(), checkFunc), data.end());
+    }
+    data.insert(data.end(), addV_vec.begin(), addV_vec.end());
+
+    // Check Update Buffer to Read self-added data
+    up_buf_const_accessor cac;
+    if (vtx_update_buffers.find(cac, trx_id)) {
+        for (auto & up_elem : cac->second) {
+            if (up_elem.isAdd && matchFunc(up_elem.label)) {
+                vid_t vid;
+                uint2vid_t(up_elem.element_id, vid);
+                data.emplace_back(vid);
+            }
+        }
+    }
+}
+
 void IndexStore::ReadEdgeTopoIndex(const uint64_t & trx_id, const uint64_t & begin_time,
                                    const bool & read_only, vector<eid_t> & data) {
     set<eid_t> addE_set;
@@ -920,6 +989,18 @@ void IndexStore::build_topo_data() {
     cout << "[InitData] Got Vertex with size " << topo_vtx_data.size() << endl;
     cout << "[Timer] " << (end_t - start_t) / 1000 << " ms for Building InitVData in init_expert" << endl;
 
+    start_t = timer::get_usec();
+    // Partition Vertex Init Data by label
+    for (auto & vid : topo_vtx_data) {
+        label_t label;
+        if (data_storage_->GetVL(vid, 0, 0, true, label) == READ_STAT::SUCCESS) {
+            topo_vtx_label_data[label].emplace_back(vid);
+        }
+    }
+    end_t = timer::get_usec();
+    cout << "[InitData] Got Vertex Labels with size " << topo_vtx_label_data.size() << endl;
+    cout << "[Timer] " << (end_t - start_t) / 1000 << " ms for Building InitVLabelData in init_expert" << endl;
+
     start_t = timer::get_usec();
     // Build Edge Init Data
     data_storage_->GetAllEdges(0, 0, true, topo_edge_data);
@@ -81,6 +81,9 @@ class IndexStore {
         value_t value;
         PropertyUpdateT update_type = PropertyUpdateT::NONE;
 
+        // For Add V, label of the new vertex
+        label_t label = 0;
+
         update_element(uint64_t element_id_, bool isAdd_, uint64_t trxid_) :
             element_id(element_id_), isAdd(isAdd_), trxid(trxid_) { ct = 0; }
 
@@ -103,7 +106,7 @@ class IndexStore {
 
     // Write Update Data
     void InsertToUpdateBuffer(const uint64_t & trx_id, vector<uint64_t>& ids, ID_T type, bool isAdd,
-                            value_t* new_val = NULL, vector<value_t>* old_vals = NULL);
+                            value_t* new_val = NULL, vector<value_t>* old_vals = NULL, label_t label = 0);
     void MoveTopoBufferToRegion(const uint64_t & trx_id, const uint64_t & ct);  // Invoke when validation begins
     void MovePropBufferToRegion(const uint64_t & trx_id, const uint64_t & ct);  // Invoke when commit successfully
     void UpdateTrxStatus(const uint64_t & trx_id, TRX_STAT stat);  // Update trx status in trx_status_and_count_table
@@ -115,6 +118,9 @@ class IndexStore {
 
     // Read Index
     void ReadVtxTopoIndex(const uint64_t & trx_id, const uint64_t & begin_time, const bool & read_only, vector<vid_t> & data);
+    // Vertices with any of the given labels, i.e. g.V().hasLabel(...)
+    void ReadVtxLabelIndex(const uint64_t & trx_id, const uint64_t & begin_time, const bool & read_only,
+                           const vector<label_t> & labels, vector<vid_t> & data);
     void ReadEdgeTopoIndex(const uint64_t & trx_id, const uint64_t & begin_time, const bool & read_only, vector<eid_t> & data);
     void ReadPropIndex(Element_T type, vector<pair<int, PredicateValue>>& pred_chain, vector<value_t>& data);  // For Prop
     bool GetRandomValue(Element_T type, int pid, string& value_str, const bool& is_update);
@@ -164,6 +170,7 @@ class IndexStore {
     // Original init data
     //  Read Only except during GC
     vector<vid_t> topo_vtx_data;
+    unordered_map<label_t, vector<vid_t>> topo_vtx_label_data;  // topo_vtx_data partitioned by vertex label
     vector<eid_t> topo_edge_data;
     unordered_map<int, index_> vtx_prop_index;  // key: PropertyKey
     unordered_map<int, index_> edge_prop_index;  // key: PropertyKey
@@ -89,17 +89,33 @@ struct EPHeader {
 
 #define EP_ROW_CELL_COUNT InferElementCount<EPHeader>(64, sizeof(void*))
 
-// EPHeader is the cell in VERow
+// EdgeHeader is the cell in VERow
 struct EdgeHeader {
  public:
     bool is_out;
+    /* The label of the edge, kept in the cell so that label-filtered traversals
+     * can skip non-matching edges without touching mvcc_list.
+     * An edge re-added with a different label is marked as LABEL_MIXED, and its
+     * label can only be read from the visible EdgeVersion.
+     * (Fits into the padding between is_out and conn_vtx_id.)
+     */
+    label_t label;
     vid_t conn_vtx_id;
     tbb::atomic<MVCCList<EdgeMVCCItem>*> mvcc_list;
 
+    static constexpr label_t LABEL_MIXED = 0;
+
+    // Return false only if the edge can never carry edge_label
+    bool MayMatchLabel(const label_t& edge_label) const {
+        return edge_label == 0 || label == LABEL_MIXED || label == edge_label;
+    }
+
     EdgeHeader& operator= (const EdgeHeader& _edge_header) {
         this->is_out = _edge_header.is_out;
+        this->label = _edge_header.label;
         this->conn_vtx_id = _edge_header.conn_vtx_id;
         this->mvcc_list = _edge_header.mvcc_list;
+        return *this;
     }
 };
 
@@ -111,6 +127,8 @@ struct VertexPropertyRow {
     VPHeader cells_[VP_ROW_CELL_COUNT];
 
     template<class PropertyRow> friend class PropertyRowList;
+    template<class PropertyRow> friend class PropertyCellIndex;
+    template<class Row, class MVCCListType> friend class RowPrefetcher;
     friend class GCProducer;
     friend class GCConsumer;
 
@@ -125,6 +143,8 @@ struct EdgePropertyRow {
     EPHeader cells_[EP_ROW_CELL_COUNT];
 
     template<class PropertyRow> friend class PropertyRowList;
+    template<class PropertyRow> friend class PropertyCellIndex;
+    template<class Row, class MVCCListType> friend class RowPrefetcher;
     friend class GCProducer;
     friend class GCConsumer;
 
@@ -139,8 +159,12 @@ struct VertexEdgeRow {
     EdgeHeader cells_[VE_ROW_CELL_COUNT];
 
     friend class TopologyRowList;
+    template<class Row, class MVCCListType> friend class RowPrefetcher;
     friend class GCProducer;
     friend class GCConsumer;
+
+ public:
+    static constexpr int ROW_CELL_COUNT = VE_ROW_CELL_COUNT;
 }  __attribute__((aligned(64)));
 
 
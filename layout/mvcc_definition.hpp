@@ -36,6 +36,11 @@ struct AbstractMVCCItem {
     uint64_t begin_time;
     uint64_t end_time;
     AbstractMVCCItem* next;
+    /* Link to the previous (older) version, so that readers can search from the newest
+     * committed version and stop at the first version with begin_time <= trx.begin_time.
+     * The oldest version in the list has prev == nullptr.
+     */
+    AbstractMVCCItem* prev;
     /* MVCCList is not the friend class of AbstractMVCCItem, which means that
      * variable begin_time and end_time cannot be directly modified.
      */
@@ -55,14 +60,16 @@ struct AbstractMVCCItem {
      *      This happens during processing stage; _trx_id is the transaction
      *      id, and _begin_time is the begin timestamp of the transaction.
      */
-    uint64_t Init(const uint64_t& _trx_id, const uint64_t& _begin_time) {
+    void Init(const uint64_t& _trx_id, const uint64_t& _begin_time) {
         begin_time = _trx_id;
         end_time = _begin_time;  // notice that this is not commit time
         next = nullptr;
+        prev = nullptr;
     }
 
     void AppendNextVersion(AbstractMVCCItem* new_version) {
         next = new_version;
+        new_version->prev = this;
         end_time = new_version->begin_time;  // TrxID of the new_version
     }
 
@@ -75,7 +82,7 @@ struct AbstractMVCCItem {
      * The end_time of the previous MVCCItem of the current MVCCItem need to be modified,
      * and it won't be visible to transaction with timestamp >= commit_time after Commit.
      */
-    uint64_t Commit(AbstractMVCCItem* previous_item, const uint64_t& commit_time) {
+    void Commit(AbstractMVCCItem* previous_item, const uint64_t& commit_time) {
         end_time = MAX_TIME;
         begin_time = commit_time;
 
@@ -89,6 +96,7 @@ struct AbstractMVCCItem {
 
  public:
     AbstractMVCCItem* GetNext() const {return next;}
+    AbstractMVCCItem* GetPrev() const {return prev;}
 
     friend class GCProducer;
     friend class GCConsumer;
@@ -105,13 +113,14 @@ struct AbstractMVCCItem {
 
 struct PropertyMVCCItem : public AbstractMVCCItem {
  protected:
-    // ValueHeader is the metadata of a inserted value in MVCCValueStore
+    // ValueHeader is the metadata of a inserted value in MVCCValueStore, or the value itself if it is small
     ValueHeader val;
 
  public:
     ValueHeader GetValue() const {return val;}
 
-    bool NeedGC() {return !val.IsEmpty();}
+    // Inlined values have nothing to free in MVCCValueStore
+    bool NeedGC() {return !val.IsEmpty() && !val.IsInline();}
 
     template<class MVCC> friend class MVCCList;
 };
@@ -16,6 +16,9 @@
 
 #include <pthread.h>
 
+#include <emmintrin.h>
+
+#include <atomic>
 #include <cstdio>
 
 #include "core/factory.hpp"
@@ -61,6 +64,13 @@ class MVCCList {
                                                         const bool& read_only, ValueType& ret);
     bool SnapshotLevelGetVisibleVersion(const uint64_t& trx_id, const uint64_t& begin_time, ValueType& ret);
 
+    /* Lock-free read path for read-only transactions, see seq_.
+     * Return false if the read cannot be done without lock_,
+     * i.e. an uncommitted version might need to be pre-read under serializable isolation.
+     * Otherwise, visible is set to false if no version visible.
+     */
+    bool ReadOnlyGetVisibleVersion(const uint64_t& trx_id, const uint64_t& begin_time, bool& visible, ValueType& ret);
+
     // Called by GetVisibleVersion. Check if the tail_ (uncommited) is to be read.
     // if ret.first == false, abort;
     // If pre-read is performed, dependency will be recorded in this function.
@@ -78,6 +88,13 @@ class MVCCList {
 
     Item* GetHead();
 
+    // Prefetch the versions checked first by GetVisibleVersion, used by RowPrefetcher.
+    // Only a hint, thus no lock is needed.
+    void PrefetchVersions() const {
+        __builtin_prefetch(head_);
+        __builtin_prefetch(tail_);
+    }
+
     // Clear the MVCCList
     void SelfGarbageCollect();
 
@@ -94,6 +111,52 @@ class MVCCList {
     // tmp_pre_tail_ is not nullptr only when the tail_ is uncommitted
     pthread_spinlock_t lock_;
 
+    /* Sequence counter for lock-free readers (seqlock).
+     * Writers holding lock_ make it odd before modifying the list, and even again after that.
+     * Readers retry if seq_ is odd or has been changed during the read.
+     * Items are allocated from ConcurrentMemPool, whose memory is never released,
+     * so a reader racing with GC only reads stale items and then retries.
+     */
+    std::atomic<uint32_t> seq_;
+
+    // Must be held with lock_ when modifying head_, tail_ or the versions in the list
+    class SeqWriteScope {
+     public:
+        explicit SeqWriteScope(MVCCList* list) : list_(list) {
+            list_->seq_.store(list_->seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        ~SeqWriteScope() {
+            list_->seq_.store(list_->seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+     private:
+        MVCCList* list_;
+    };
+
+    // The newest committed version, valid only if head_ is committed
+    Item* GetNewestCommitted() const {
+        return tail_->GetTransactionID() == 0 ? tail_ : pre_tail_;
+    }
+
+    // Search for the version visible at begin_time, from head_ or the newest committed version.
+    // Only called when head_ is committed and head_->GetBeginTime() <= begin_time.
+    Item* LocateVisibleVersion(const uint64_t& begin_time) const;
+
+    // True if begin_time is closer to the begin_time of head than to that of newest,
+    // i.e., the visible version is likely in the older half of the list
+    static bool SearchFromHead(const Item* head, const Item* newest, const uint64_t& begin_time) {
+        return newest->GetBeginTime() > begin_time
+               && begin_time - head->GetBeginTime() < newest->GetBeginTime() - begin_time;
+    }
+
+    enum class LockFreeReadResult { VISIBLE, INVISIBLE, NEED_LOCK };
+
+    // Called by ReadOnlyGetVisibleVersion, the result is valid only if seq_ is still equal to seq after that
+    LockFreeReadResult TryLockFreeRead(const uint32_t& seq, const uint64_t& trx_id,
+                                       const uint64_t& begin_time, ValueType& ret);
+
     friend class GCProducer;
     friend class GCConsumer;
 };
@@ -15,6 +15,7 @@
 template<class Item>
 MVCCList<Item>::MVCCList() {
     pthread_spin_init(&lock_, 0);
+    seq_ = 0;
 }
 
 template<class Item>
@@ -92,6 +93,13 @@ pair<bool, bool> MVCCList<Item>::TryPreReadUncommittedTail(const uint64_t& trx_i
 template<class Item>
 pair<bool, bool> MVCCList<Item>::GetVisibleVersion(const uint64_t& trx_id, const uint64_t& begin_time,
                                                    const bool& read_only, ValueType& ret) {
+    if (read_only) {
+        // Read-only transactions do not wait for the writers of this list
+        bool visible;
+        if (ReadOnlyGetVisibleVersion(trx_id, begin_time, visible, ret))
+            return make_pair(true, visible);
+    }
+
     if (config_->isolation_level == ISOLATION_LEVEL::SERIALIZABLE)
         return SerializableLevelGetVisibleVersion(trx_id, begin_time, read_only, ret);
     else
@@ -140,16 +148,7 @@ pair<bool, bool> MVCCList<Item>::SerializableLevelGetVisibleVersion(const uint64
     }
 
     // locate a version that trx.begin_time is within [version.begin_time, version.end_time)
-    Item* version = head_;
-    while (true) {
-        // If visible, break
-        if (begin_time < version->GetEndTime())
-            break;
-
-        CHECK(version != tail_);
-
-        version = static_cast<Item*>(version->GetNext());
-    }
+    Item* version = LocateVisibleVersion(begin_time);
 
     if (version->NextIsUncommitted()) {
         pair<bool, bool> preread_visible = TryPreReadUncommittedTail(trx_id, begin_time, read_only);
@@ -194,25 +193,133 @@ bool MVCCList<Item>::SnapshotLevelGetVisibleVersion(const uint64_t& trx_id, cons
         return false;
 
     // locate a version that trx.begin_time is within [version.begin_time, version.end_time)
-    Item* version = head_;
+    Item* version = LocateVisibleVersion(begin_time);
+
+    ret = version->val;
+    return true;
+}
+
+/* The versions are linked in both directions, and the begin_time of committed versions is increasing.
+ * The search starts from the end closer to begin_time, which is estimated by the begin_time of head_ and
+ * the newest committed version (GetNewestCommitted()):
+ *  backwards: the first version with begin_time <= trx.begin_time is visible, since its end_time is the
+ *             begin_time of the next version (> trx.begin_time), MAX_TIME or a trx_id;
+ *  forwards:  the first version with trx.begin_time < end_time is visible, as the search before
+ *             the versions were linked backwards.
+ * Thus, reading the latest snapshot only costs one step, and an old snapshot does not walk the versions
+ * newer than it, e.g., when a long read-only transaction reads a hot vertex.
+ */
+template<class Item>
+Item* MVCCList<Item>::LocateVisibleVersion(const uint64_t& begin_time) const {
+    Item* version = GetNewestCommitted();
+    if (SearchFromHead(head_, version, begin_time)) {
+        version = head_;
+        while (begin_time >= version->GetEndTime()) {
+            CHECK(version != tail_);
+            version = static_cast<Item*>(version->GetNext());
+        }
+        return version;
+    }
+
+    while (version->GetBeginTime() > begin_time) {
+        CHECK(version != head_);
+        version = static_cast<Item*>(version->GetPrev());
+    }
+    return version;
+}
+
+template<class Item>
+bool MVCCList<Item>::ReadOnlyGetVisibleVersion(const uint64_t& trx_id, const uint64_t& begin_time,
+                                               bool& visible, ValueType& ret) {
     while (true) {
-        // If visible, break
-        if (begin_time < version->GetEndTime())
-            break;
+        uint32_t seq = seq_.load(std::memory_order_acquire);
+        // Being modified by a writer
+        if (seq & 1) {
+            _mm_pause();
+            continue;
+        }
 
-        CHECK(version != tail_);
+        ValueType val;
+        LockFreeReadResult result = TryLockFreeRead(seq, trx_id, begin_time, val);
 
-        version = static_cast<Item*>(version->GetNext());
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != seq)
+            continue;
+
+        if (result == LockFreeReadResult::NEED_LOCK)
+            return false;
+
+        visible = (result == LockFreeReadResult::VISIBLE);
+        if (visible)
+            ret = val;
+        return true;
+    }
+}
+
+// Same as SnapshotLevelGetVisibleVersion and SerializableLevelGetVisibleVersion with read_only == true,
+// except that cases involving TryPreReadUncommittedTail are left to the locked path.
+template<class Item>
+typename MVCCList<Item>::LockFreeReadResult MVCCList<Item>::TryLockFreeRead(const uint32_t& seq, const uint64_t& trx_id,
+                                                                          const uint64_t& begin_time, ValueType& ret) {
+    bool serializable = (config_->isolation_level == ISOLATION_LEVEL::SERIALIZABLE);
+    Item* head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+    Item* tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+
+    // The MVCCList is empty
+    if (head == nullptr || tail == nullptr)
+        return LockFreeReadResult::INVISIBLE;
+
+    // One special case: the uncommitted tail is created by the same transaction
+    if (tail->GetTransactionID() == trx_id) {
+        ret = tail->val;
+        return LockFreeReadResult::VISIBLE;
+    }
+
+    // head_ == tail_, uncommited
+    if (head->GetTransactionID() != 0)
+        return serializable ? LockFreeReadResult::NEED_LOCK : LockFreeReadResult::INVISIBLE;
+
+    if (head->GetBeginTime() > begin_time)
+        return LockFreeReadResult::INVISIBLE;
+
+    // locate a version that trx.begin_time is within [version.begin_time, version.end_time),
+    // from the end closer to begin_time, see LocateVisibleVersion
+    Item* version = (tail->GetTransactionID() == 0) ? tail : __atomic_load_n(&pre_tail_, __ATOMIC_RELAXED);
+    if (version != nullptr && SearchFromHead(head, version, begin_time)) {
+        version = head;
+        while (version != nullptr && begin_time >= version->GetEndTime()) {
+            version = static_cast<Item*>(version->GetNext());
+
+            // The list has been modified, the result will be discarded by the caller.
+            if (seq_.load(std::memory_order_relaxed) != seq)
+                return LockFreeReadResult::NEED_LOCK;
+        }
+    } else {
+        while (version != nullptr && version->GetBeginTime() > begin_time) {
+            version = static_cast<Item*>(version->GetPrev());
+
+            // The list has been modified, the result will be discarded by the caller.
+            if (seq_.load(std::memory_order_relaxed) != seq)
+                return LockFreeReadResult::NEED_LOCK;
+        }
     }
 
+    // Leave the broken list to the locked path
+    if (version == nullptr)
+        return LockFreeReadResult::NEED_LOCK;
+
+    if (serializable && version->NextIsUncommitted())
+        return LockFreeReadResult::NEED_LOCK;
+
     ret = version->val;
-    return true;
+    return LockFreeReadResult::VISIBLE;
 }
 
 template<class Item>
 decltype(Item::val)* MVCCList<Item>::AppendVersion(const uint64_t& trx_id, const uint64_t& begin_time,
                                                    decltype(Item::val)* old_val_header, bool* old_val_exists) {
     SimpleSpinLockGuard lock_guard(&lock_);
+    SeqWriteScope seq_write_scope(this);
 
     if (head_ == nullptr) {
         Item* head_mvcc = mem_pool_->Get(TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER));
@@ -288,6 +395,7 @@ decltype(Item::val)* MVCCList<Item>::AppendInitialVersion() {
 template<class Item>
 void MVCCList<Item>::CommitVersion(const uint64_t& trx_id, const uint64_t& commit_time) {
     SimpleSpinLockGuard lock_guard(&lock_);
+    SeqWriteScope seq_write_scope(this);
     CHECK(tail_->GetTransactionID() == trx_id);
 
     tail_->Commit(pre_tail_, commit_time);
@@ -298,6 +406,7 @@ void MVCCList<Item>::CommitVersion(const uint64_t& trx_id, const uint64_t& commi
 template<class Item>
 void MVCCList<Item>::AbortVersion(const uint64_t& trx_id) {
     SimpleSpinLockGuard lock_guard(&lock_);
+    SeqWriteScope seq_write_scope(this);
     CHECK(tail_->GetTransactionID() == trx_id);
 
     if (tail_->NeedGC())
@@ -322,6 +431,7 @@ void MVCCList<Item>::AbortVersion(const uint64_t& trx_id) {
 template<class Item>
 void MVCCList<Item>::SelfGarbageCollect() {
     SimpleSpinLockGuard lock_guard(&lock_);
+    SeqWriteScope seq_write_scope(this);
     while (head_ != nullptr) {
         if (head_->NeedGC())
             head_->ValueGC();
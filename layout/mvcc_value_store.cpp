@@ -15,18 +15,19 @@
 
 #include "mvcc_value_store.hpp"
 
-MVCCValueStore::MVCCValueStore(char* mem, size_t cell_count, int nthreads, bool utilization_record) {
-    Init(mem, cell_count, nthreads, utilization_record);
+MVCCValueStore::MVCCValueStore(char* mem, size_t cell_count, int nthreads, bool utilization_record,
+                               bool numa_aware, bool huge_page) {
+    Init(mem, cell_count, nthreads, utilization_record, numa_aware, huge_page);
 }
 
 MVCCValueStore::~MVCCValueStore() {
-    if (next_offset_ != nullptr)
-        _mm_free(next_offset_);
+    HugePageUtil::Unmap(next_offset_, next_offset_bytes_);
     if (mem_allocated_)
-        _mm_free(attached_mem_);
+        HugePageUtil::Unmap(attached_mem_, mem_bytes_);
 }
 
-void MVCCValueStore::Init(char* mem, size_t cell_count, int nthreads, bool utilization_record) {
+void MVCCValueStore::Init(char* mem, size_t cell_count, int nthreads, bool utilization_record,
+                          bool numa_aware, bool huge_page) {
     // make sure that enough cells are available for all threads
     assert(cell_count > nthreads * (BLOCK_SIZE + 2));
 
@@ -38,31 +39,42 @@ void MVCCValueStore::Init(char* mem, size_t cell_count, int nthreads, bool utili
         attached_mem_ = mem;
         mem_allocated_ = false;
     } else {
-        attached_mem_ = reinterpret_cast<char*>(_mm_malloc(cell_count * MEM_CELL_SIZE, 4096));
+        mem_bytes_ = cell_count * MEM_CELL_SIZE;
+        attached_mem_ = reinterpret_cast<char*>(HugePageUtil::Map(mem_bytes_, huge_page));
+        CHECK(attached_mem_ != nullptr) << "MVCCValueStore: failed to allocate " << mem_bytes_ << " bytes";
         mem_allocated_ = true;
+        // Extents are shared by all threads regardless of their nodes, thus spread the bandwidth over all nodes.
+        // The policy applies to pages faulted in later
+        if (numa_aware && NumaUtil::GetNodeCount() > 1)
+            NumaUtil::InterleaveNodes(attached_mem_, mem_bytes_);
+        // Huge pages are zeroed when faulted in, fault them in parallel rather than on the first InsertValue() of each page.
+        // Normal pages are left to be faulted in lazily, so that the unused part of the store takes no memory
+        if (huge_page)
+            HugePageUtil::ParallelTouch(attached_mem_, mem_bytes_, nthreads);
     }
 
-    next_offset_ = reinterpret_cast<OffsetT*>(_mm_malloc(sizeof(OffsetT) * cell_count, 4096));
-
-    for (OffsetT i = 0; i < cell_count; i++) {
-        next_offset_[i] = i + 1;
-    }
+    // next_offset_ is only written for the first cell of extents, no need to initialize
+    next_offset_bytes_ = sizeof(OffsetT) * cell_count;
+    next_offset_ = reinterpret_cast<OffsetT*>(HugePageUtil::Map(next_offset_bytes_, huge_page));
+    CHECK(next_offset_ != nullptr) << "MVCCValueStore: failed to allocate next offsets";
 
     head_ = 0;
-    tail_ = cell_count - 1;
+    for (int size_class = 0; size_class < SIZE_CLASS_COUNT; size_class++) {
+        shared_free_head_[size_class] = 0;
+        shared_free_count_[size_class] = 0;
+    }
 
     thread_local_block_ = reinterpret_cast<ThreadLocalBlock*>(_mm_malloc(sizeof(ThreadLocalBlock) * nthreads, 4096));
 
     for (int tid = 0; tid < nthreads; tid++) {
         auto& local_block = thread_local_block_[tid];
 
-        local_block.free_cell_count = BLOCK_SIZE;
-        local_block.block_head = head_;
-        local_block.block_tail = head_ + BLOCK_SIZE - 1;
+        for (int size_class = 0; size_class < SIZE_CLASS_COUNT; size_class++) {
+            local_block.free_head[size_class] = 0;
+            local_block.free_count[size_class] = 0;
+        }
         local_block.get_counter = 0;
         local_block.free_counter = 0;
-
-        head_ = head_ + BLOCK_SIZE;
     }
 
     pthread_spin_init(&lock_, 0);
@@ -75,41 +87,43 @@ ValueHeader MVCCValueStore::InsertValue(const value_t& value, int tid) {
     ValueHeader ret;
     ret.byte_count = value.content.size() + 1;
 
+    if (ret.IsInline()) {
+        ret.inline_bytes[0] = static_cast<char>(value.type);
+        memcpy(ret.inline_bytes + 1, value.content.data(), value.content.size());
+        return ret;
+    }
+
     // Calculate how many cells will be used to store this value_t
     OffsetT cell_count = ret.GetCellCount();
 
-    // Allocate cells
-    ret.head_offset = Get(cell_count, tid);
-
-    OffsetT current_offset = ret.head_offset;
     const char* value_content_ptr = &value.content[0];
     OffsetT value_len = value.content.size(), value_off = 0;
-
-    for (OffsetT i = 0; i < cell_count; i++) {
-        // get the pointer of the cell via current_offset
-        char* cell_ptr = GetCellPtr(current_offset);
-        if (i == 0) {
-            // the first cell; we need to insert value_t::type
-            cell_ptr[0] = static_cast<char>(value.type);
-
-            // insert part of value_t::content to the remaining spaces in the first cell
-            if (value_len < MEM_CELL_SIZE - 1) {
-                // value_t::content cannot fill the remaining spaces
-                memcpy(cell_ptr + 1, value_content_ptr + value_off, value_len);
-            } else {
-                memcpy(cell_ptr + 1, value_content_ptr + value_off, MEM_CELL_SIZE - 1);
-                value_off += MEM_CELL_SIZE - 1;
-            }
-        } else if (i == cell_count - 1) {
-            // The last cell to insert, copy the remaining part of value_t::content
-            memcpy(cell_ptr, value_content_ptr + value_off, value_len - value_off);
+    OffsetT prev_offset = 0;
+
+    // Only a value_t larger than MAX_EXTENT_CELL_COUNT cells takes more than one extent
+    for (OffsetT remaining = cell_count; remaining > 0;) {
+        OffsetT extent_cell_count = std::min(remaining, MAX_EXTENT_CELL_COUNT);
+        OffsetT offset = Get(GetSizeClass(extent_cell_count), tid);
+        char* extent_ptr = GetCellPtr(offset);
+        OffsetT extent_bytes = extent_cell_count * MEM_CELL_SIZE;
+
+        if (remaining == cell_count) {
+            // the first extent; we need to insert value_t::type
+            ret.head_offset = offset;
+            extent_ptr[0] = static_cast<char>(value.type);
+            extent_ptr++;
+            extent_bytes--;
         } else {
-            // neither the first cell nor the last cell
-            memcpy(cell_ptr, value_content_ptr + value_off, MEM_CELL_SIZE);
-            value_off += MEM_CELL_SIZE;
+            // chain to the previous extent
+            next_offset_[prev_offset] = offset;
         }
-        // get the offset of the next cell
-        current_offset = next_offset_[current_offset];
+
+        OffsetT copy_len = std::min(extent_bytes, value_len - value_off);
+        memcpy(extent_ptr, value_content_ptr + value_off, copy_len);
+        value_off += copy_len;
+
+        prev_offset = offset;
+        remaining -= extent_cell_count;
     }
 
     return ret;
@@ -121,130 +135,142 @@ void MVCCValueStore::ReadValue(const ValueHeader& header, value_t& value) {
 
     OffsetT value_len = header.byte_count - 1, value_off = 0;
     value.content.resize(value_len);
+
+    if (header.IsInline()) {
+        value.type = header.inline_bytes[0];
+        memcpy(&value.content[0], header.inline_bytes + 1, value_len);
+        return;
+    }
+
     OffsetT cell_count = header.GetCellCount();
     OffsetT current_offset = header.head_offset;
 
     char* value_content_ptr = &value.content[0];
 
     // Please refer to InsertValue()
-    for (OffsetT i = 0; i < cell_count; i++) {
-        const char* cell_ptr = GetCellPtr(current_offset);
-        if (i == 0) {
-            value.type = cell_ptr[0];
-            if (value_len < MEM_CELL_SIZE - 1) {
-                memcpy(value_content_ptr + value_off, cell_ptr + 1, value_len);
-            } else {
-                memcpy(value_content_ptr + value_off, cell_ptr + 1, MEM_CELL_SIZE - 1);
-                value_off += MEM_CELL_SIZE - 1;
-            }
-        } else if (i == cell_count - 1) {
-            const char* cell_ptr = GetCellPtr(current_offset);
-            memcpy(value_content_ptr + value_off, cell_ptr, value_len - value_off);
-        } else {
-            memcpy(value_content_ptr + value_off, cell_ptr, MEM_CELL_SIZE);
-            value_off += MEM_CELL_SIZE;
+    for (OffsetT remaining = cell_count; remaining > 0;) {
+        OffsetT extent_cell_count = std::min(remaining, MAX_EXTENT_CELL_COUNT);
+        const char* extent_ptr = GetCellPtr(current_offset);
+        OffsetT extent_bytes = extent_cell_count * MEM_CELL_SIZE;
+
+        if (remaining == cell_count) {
+            value.type = extent_ptr[0];
+            extent_ptr++;
+            extent_bytes--;
         }
-        current_offset = next_offset_[current_offset];
+
+        OffsetT copy_len = std::min(extent_bytes, value_len - value_off);
+        memcpy(value_content_ptr + value_off, extent_ptr, copy_len);
+        value_off += copy_len;
+
+        remaining -= extent_cell_count;
+        if (remaining > 0)
+            current_offset = next_offset_[current_offset];
     }
 }
 
 void MVCCValueStore::FreeValue(const ValueHeader& header, int tid) {
-    OffsetT cell_count = header.GetCellCount();
+    if (header.IsInline())
+        return;
+
+    OffsetT current_offset = header.head_offset;
 
-    Free(header.head_offset, cell_count, tid);
+    for (OffsetT remaining = header.GetCellCount(); remaining > 0;) {
+        OffsetT extent_cell_count = std::min(remaining, MAX_EXTENT_CELL_COUNT);
+        remaining -= extent_cell_count;
+
+        // Free() overwrites next_offset_ of the extent
+        OffsetT next_offset = next_offset_[current_offset];
+        Free(current_offset, GetSizeClass(extent_cell_count), tid);
+        current_offset = next_offset;
+    }
 }
 
 // Called by InsertValue
-OffsetT MVCCValueStore::Get(const OffsetT& count, int tid) {
+OffsetT MVCCValueStore::Get(const int& size_class, int tid) {
     auto& local_block = thread_local_block_[tid];
 
-    if (utilization_record_)
-        local_block.get_counter += count;
+    if (local_block.free_count[size_class] == 0) {
+        // no free extent of this size class in the thread-local block
+        FetchFromShared(local_block, size_class);
+    }
 
-    // count + 2: make sure at least 2 free cells for each thread, reserved for head and tail
+    // pop one extent from the head of the thread-local free list
+    OffsetT ret = local_block.free_head[size_class];
+    local_block.free_head[size_class] = next_offset_[ret];
+    local_block.free_count[size_class]--;
 
-    if (count > BLOCK_SIZE && local_block.free_cell_count < count + 2) {
-        // get cells from global space directly
-        pthread_spin_lock(&lock_);
-        OffsetT ori_head = head_;
-        for (OffsetT i = 0; i < count; i++) {
-            head_ = next_offset_[head_];
-            assert(head_ != tail_);
-        }
-        pthread_spin_unlock(&lock_);
-        return ori_head;
-    }
+    if (utilization_record_)
+        local_block.get_counter += 1 << size_class;
 
-    if (local_block.free_cell_count < count + 2) {
-        // no enough cells
-        // fetch BLOCK_SIZE free cells from the shared block, append to the tail of the thread-local block
-        pthread_spin_lock(&lock_);
-        OffsetT tmp_head = head_;
-        local_block.free_cell_count += BLOCK_SIZE;
-        next_offset_[local_block.block_tail] = tmp_head;
-        for (OffsetT i = 0; i < BLOCK_SIZE; i++) {
-            if (i == BLOCK_SIZE - 1)
-                local_block.block_tail = tmp_head;
-            tmp_head = next_offset_[tmp_head];
-            assert(tmp_head != tail_);
+    return ret;
+}
+
+void MVCCValueStore::FetchFromShared(ThreadLocalBlock& local_block, const int& size_class) {
+    OffsetT batch_count = GetBatchCount(size_class);
+    OffsetT extent_cell_count = 1 << size_class;
+
+    pthread_spin_lock(&lock_);
+    if (shared_free_count_[size_class] >= batch_count) {
+        // detach batch_count extents from the head of the shared free list
+        OffsetT batch_head = shared_free_head_[size_class];
+        OffsetT batch_tail = batch_head;
+        for (OffsetT i = 0; i < batch_count - 1; i++)
+            batch_tail = next_offset_[batch_tail];
+        shared_free_head_[size_class] = next_offset_[batch_tail];
+        shared_free_count_[size_class] -= batch_count;
+
+        next_offset_[batch_tail] = local_block.free_head[size_class];
+        local_block.free_head[size_class] = batch_head;
+        local_block.free_count[size_class] += batch_count;
+    } else {
+        // carve slabs from the unused space, and split them into extents of this size class
+        OffsetT carved_count = 0;
+        while (carved_count < batch_count) {
+            CHECK(head_ + MAX_EXTENT_CELL_COUNT <= cell_count_) << "MVCCValueStore exhausted, enlarge the kv size in config";
+
+            // push in reverse order, so that extents are got in the address order
+            for (OffsetT offset = head_ + MAX_EXTENT_CELL_COUNT; offset > head_;) {
+                offset -= extent_cell_count;
+                next_offset_[offset] = local_block.free_head[size_class];
+                local_block.free_head[size_class] = offset;
+            }
+            carved_count += MAX_EXTENT_CELL_COUNT / extent_cell_count;
+            head_ += MAX_EXTENT_CELL_COUNT;
         }
-        head_ = tmp_head;
-        pthread_spin_unlock(&lock_);
+        local_block.free_count[size_class] += carved_count;
     }
-
-    OffsetT ori_head = local_block.block_head;
-    local_block.free_cell_count -= count;
-    for (OffsetT i = 0; i < count; i++)
-        local_block.block_head = next_offset_[local_block.block_head];
-
-    return ori_head;
+    pthread_spin_unlock(&lock_);
 }
 
 // Called by FreeValue
-void MVCCValueStore::Free(const OffsetT& offset, const OffsetT& count, int tid) {
+void MVCCValueStore::Free(const OffsetT& offset, const int& size_class, int tid) {
     auto& local_block = thread_local_block_[tid];
 
     if (utilization_record_)
-        local_block.free_counter += count;
-
-    if (count > BLOCK_SIZE && local_block.free_cell_count + count >= 2 * BLOCK_SIZE) {
-        // free cells to shared block directly when count is too large
-        OffsetT tmp_tail = offset;
-        for (OffsetT i = 0; i < count - 1; i++) {
-            tmp_tail = next_offset_[tmp_tail];
-        }
-
-        // append cells to the tail of the shared block
-        pthread_spin_lock(&lock_);
-        next_offset_[tail_] = offset;
-        tail_ = tmp_tail;
-        pthread_spin_unlock(&lock_);
-
-        return;
-    }
-
-    // attach free cells to the tail of the thread-local block
-    next_offset_[local_block.block_tail] = offset;
-    local_block.free_cell_count += count;
-    for (OffsetT i = 0; i < count; i++) {
-        local_block.block_tail = next_offset_[local_block.block_tail];
-    }
-
-    if (local_block.free_cell_count >= 2 * BLOCK_SIZE) {
-        // too many free cells in the thread-local block
-        // get BLOCK_SIZE cells from the head of the thread-local block
-        OffsetT to_free_count = local_block.free_cell_count - BLOCK_SIZE;
-        OffsetT tmp_head = local_block.block_head;
-        OffsetT tmp_tail = tmp_head;
-        for (int i = 0; i < to_free_count - 1; i++)
-            tmp_tail = next_offset_[tmp_tail];
-        local_block.block_head = next_offset_[tmp_tail];
-        local_block.free_cell_count -= to_free_count;
-
-        // attach those cells to the tail of the shared block
+        local_block.free_counter += 1 << size_class;
+
+    // push the extent to the head of the thread-local free list
+    next_offset_[offset] = local_block.free_head[size_class];
+    local_block.free_head[size_class] = offset;
+    local_block.free_count[size_class]++;
+
+    OffsetT batch_count = GetBatchCount(size_class);
+    if (local_block.free_count[size_class] >= 2 * batch_count) {
+        // too many free extents in the thread-local block
+        // detach batch_count extents from the head of the thread-local free list
+        OffsetT batch_head = local_block.free_head[size_class];
+        OffsetT batch_tail = batch_head;
+        for (OffsetT i = 0; i < batch_count - 1; i++)
+            batch_tail = next_offset_[batch_tail];
+        local_block.free_head[size_class] = next_offset_[batch_tail];
+        local_block.free_count[size_class] -= batch_count;
+
+        // attach those extents to the head of the shared free list
         pthread_spin_lock(&lock_);
-        next_offset_[tail_] = tmp_head;
-        tail_ = tmp_tail;
+        next_offset_[batch_tail] = shared_free_head_[size_class];
+        shared_free_head_[size_class] = batch_head;
+        shared_free_count_[size_class] += batch_count;
         pthread_spin_unlock(&lock_);
     }
 }
@@ -256,10 +282,11 @@ std::string MVCCValueStore::UsageString() {
         get_counter += thread_local_block_[tid].get_counter;
         free_counter += thread_local_block_[tid].free_counter;
     }
-    OffsetT cell_avail = cell_count_ - get_counter + free_counter - 2;
+    OffsetT cell_avail = cell_count_ - get_counter + free_counter;
 
     return "Get: " + std::to_string(get_counter) + ", Free: " + std::to_string(free_counter)
-           + ", Total: " + std::to_string(cell_count_) + ", Avail: " + std::to_string(cell_avail);
+           + ", Total: " + std::to_string(cell_count_) + ", Avail: " + std::to_string(cell_avail)
+           + ", Carved: " + std::to_string(head_);
 }
 
 std::pair<OffsetT, OffsetT> MVCCValueStore::GetUsage() {
@@ -280,7 +307,7 @@ std::pair<uint64_t, uint64_t> MVCCValueStore::UsageStatistic() {
         get_counter += thread_local_block_[tid].get_counter;
         free_counter += thread_local_block_[tid].free_counter;
     }
-    uint64_t usage_counter = get_counter - free_counter + 2;
+    uint64_t usage_counter = get_counter - free_counter;
 
     return std::pair<uint64_t, uint64_t>(usage_counter * (MEM_CELL_SIZE + sizeof(OffsetT)), cell_count_ * (MEM_CELL_SIZE + sizeof(OffsetT)));
 }
@@ -26,11 +26,15 @@
 #include <mm_malloc.h>
 #endif  // defined(__GNUC__)
 
+#include <algorithm>
 #include <atomic>
 #include <cstdio>
 #include <string>
 
 #include "base/type.hpp"
+#include "glog/logging.h"
+#include "utils/huge_page_util.hpp"
+#include "utils/numa_util.hpp"
 
 #define OffsetT uint32_t
 #define MEM_CELL_SIZE 8
@@ -41,11 +45,19 @@ static_assert(MEM_CELL_SIZE % 8 == 0, "mvcc_value_store.hpp, MEM_CELL_SIZE % 8 !
 /*
 MVCCValueStore is used for storing value_t in a pre-allocated memory.
 -----------------------------------------------------------------------------------
-The logic of MVCCValueStore is like ConcurrentMemPool. A value_t can be stored in one or multiple cells, depending on the size of value_t.
-Like ConcurrentMemPool, MVCCValueStore also has thread-local blocks and a shared block.
+A value_t is stored in an extent, i.e., 2^k contiguous cells, so that it can be read and written with one memcpy:
+    1. Size class k holds extents of 2^k cells, k < SIZE_CLASS_COUNT (up to MAX_EXTENT_CELL_COUNT cells, i.e., 4KB).
+    2. Each thread keeps a free list of extents per size class. The free lists are linked through next_offset_
+       of the first cell of each extent, and extents move between the thread and the shared free list of the class by batch.
+    3. If the shared free list of a class is empty, slabs of MAX_EXTENT_CELL_COUNT cells are carved from the unused space
+       and split into extents of the class. Extents are aligned to their size, thus never cross a page.
+    4. A value_t larger than MAX_EXTENT_CELL_COUNT cells is stored in a chain of extents.
+       The offset of the next extent is in next_offset_ of the first cell of the extent.
+    Extents are not merged after free; the space of a slab stays in its size class.
 -----------------------------------------------------------------------------------
 Usage:
     1. Use InsertValue() to insert a value_t into the MVCCValueStore. Insert() will return a ValueHeader.
+       Small values are inlined in the ValueHeader, and no cell is allocated for them.
     2. Use ReadValue() to get the inserted value_t by a ValueHeader.
     3. Use FreeValue() to free cells related to a ValueHeader.
 -----------------------------------------------------------------------------------
@@ -53,14 +65,22 @@ Cautious: the same as ConcurrentMemoryPool, a thread id can only be used by one
 */
 
 struct ValueHeader {
-    OffsetT head_offset;
+    // A value_t of at most INLINE_CAPACITY bytes (value_t::type included) is stored in the header,
+    // without touching MVCCValueStore. Thus, byte_count tells where the value is.
+    static constexpr OffsetT INLINE_CAPACITY = 12;
+
     OffsetT byte_count;
+    union {
+        OffsetT head_offset;
+        char inline_bytes[INLINE_CAPACITY];
+    };
 
     // True when the property has been dropped.
     // For any property, byte_count should be >= 1, since value_t::type will occupy 1 byte
-    bool IsEmpty() {return byte_count == 0;}
+    bool IsEmpty() const {return byte_count == 0;}
+    bool IsInline() const {return byte_count != 0 && byte_count <= INLINE_CAPACITY;}
     ValueHeader() {byte_count = 0;}
-    constexpr ValueHeader(OffsetT _head_offset, OffsetT _byte_count) : head_offset(_head_offset), byte_count(_byte_count) {}
+    constexpr ValueHeader(OffsetT _head_offset, OffsetT _byte_count) : byte_count(_byte_count), head_offset(_head_offset) {}
     inline OffsetT GetCellCount() const __attribute__((always_inline)) {
         OffsetT cell_count = byte_count / MEM_CELL_SIZE;
         if (cell_count * MEM_CELL_SIZE != byte_count)
@@ -69,7 +89,14 @@ struct ValueHeader {
     }
 };
 
+static_assert(sizeof(ValueHeader) == 16, "mvcc_value_store.hpp, sizeof(ValueHeader) != 16");
+
 class MVCCValueStore {
+ public:
+    static constexpr int BLOCK_SIZE = 1024;
+    static constexpr int SIZE_CLASS_COUNT = 10;
+    static constexpr OffsetT MAX_EXTENT_CELL_COUNT = 1 << (SIZE_CLASS_COUNT - 1);
+
  private:
     MVCCValueStore(const MVCCValueStore&);
     ~MVCCValueStore();
@@ -77,21 +104,26 @@ class MVCCValueStore {
     bool mem_allocated_ __attribute__((aligned(16))) = false;
     char* attached_mem_ __attribute__((aligned(16))) = nullptr;
     OffsetT* next_offset_ __attribute__((aligned(32))) = nullptr;
+    size_t mem_bytes_ = 0;
+    size_t next_offset_bytes_ = 0;
 
     OffsetT cell_count_;
     int nthreads_;
     bool utilization_record_;
 
+    // Cells in [head_, cell_count_) have not been carved into extents
     OffsetT head_ __attribute__((aligned(64)));
-    OffsetT tail_ __attribute__((aligned(64)));
+
+    // Shared free lists of extents, protected by lock_
+    OffsetT shared_free_head_[SIZE_CLASS_COUNT];
+    OffsetT shared_free_count_[SIZE_CLASS_COUNT];
 
     pthread_spinlock_t lock_ __attribute__((aligned(64)));
 
     // the user should guarantee that a specific tid will only be used by one specific thread.
     struct ThreadLocalBlock {
-        OffsetT block_head __attribute__((aligned(16)));
-        OffsetT block_tail __attribute__((aligned(16)));
-        OffsetT free_cell_count __attribute__((aligned(16)));
+        OffsetT free_head[SIZE_CLASS_COUNT];
+        OffsetT free_count[SIZE_CLASS_COUNT];
         OffsetT get_counter, free_counter;
     } __attribute__((aligned(64)));
 
@@ -104,10 +136,22 @@ class MVCCValueStore {
         return attached_mem_ + ((size_t) offset) * MEM_CELL_SIZE;
     }
 
-    // Allocate cells, called by InsertValue
-    OffsetT Get(const OffsetT& count, int tid);
-    // Free cells, called by FreeValue
-    void Free(const OffsetT& offset, const OffsetT& count, int tid);
+    // The smallest size class holding count cells, count <= MAX_EXTENT_CELL_COUNT
+    static inline int GetSizeClass(const OffsetT& count) __attribute__((always_inline)) {
+        return count <= 1 ? 0 : 32 - __builtin_clz(count - 1);
+    }
+
+    // Count of extents moved between a thread-local free list and the shared free list at a time
+    static inline OffsetT GetBatchCount(const int& size_class) __attribute__((always_inline)) {
+        return std::max(BLOCK_SIZE >> size_class, 1);
+    }
+
+    // Allocate an extent of the size class, called by InsertValue
+    OffsetT Get(const int& size_class, int tid);
+    // Free an extent of the size class, called by FreeValue
+    void Free(const OffsetT& offset, const int& size_class, int tid);
+    // Move a batch of extents from the shared free list (or new slabs) to the thread-local free list
+    void FetchFromShared(ThreadLocalBlock& local_block, const int& size_class);
 
     /*
     Allocate memories and initialize blocks.
@@ -116,8 +160,10 @@ class MVCCValueStore {
         size_t cell_count: The number of cells
         int nthreads: The count of thread that will use this ConcurrentMemPool
         bool utilization_record_: If true, the count of got and free cells will be recorded.
+        bool numa_aware: If true, pages allocated by the store are interleaved among NUMA nodes.
+        bool huge_page: If true, memory allocated by the store is backed by huge pages when possible.
     */
-    void Init(char* mem, size_t cell_count, int nthreads, bool utilization_record);
+    void Init(char* mem, size_t cell_count, int nthreads, bool utilization_record, bool numa_aware, bool huge_page);
 
  public:
     // Insert a value_t to the MVCCValueStore, returns a ValueHeader used to fetch and free this value_t
@@ -127,9 +173,9 @@ class MVCCValueStore {
 
     void ReadValue(const ValueHeader& header, value_t& value);
 
-    MVCCValueStore(char* mem, size_t cell_count, int nthreads, bool utilization_record);
+    MVCCValueStore(char* mem, size_t cell_count, int nthreads, bool utilization_record,
+                   bool numa_aware = false, bool huge_page = false);
 
-    static constexpr int BLOCK_SIZE = 1024;
 
     std::string UsageString();
     std::pair<OffsetT, OffsetT> GetUsage();  // <get_count, free_count>
@@ -0,0 +1,165 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/type.hpp"
+#include "glog/logging.h"
+
+/* Immutable index from property key to cell, for the first GetCount() cells of a PropertyRowList.
+ * Keys and cell pointers are stored in one allocation right after the header:
+ *   count <= ARRAY_THRESHOLD: keys are sorted and padded to a multiple of 8, and scanned 8 at a time by SSE2 compares.
+ *   otherwise:                open-addressing table with linear probing, at most half full.
+ * Cells appended to the row list after Build() are not indexed, the caller scans them from GetLastRow().
+ */
+template <class PropertyRow>
+class PropertyCellIndex {
+ private:
+    typedef typename std::remove_all_extents<decltype(PropertyRow::cells_)>::type CellType;
+
+ public:
+    static constexpr int ARRAY_THRESHOLD = 64;
+
+    // Index the first count cells of the rows
+    static PropertyCellIndex* Build(PropertyRow* head, const int& count) {
+        std::vector<std::pair<label_t, CellType*>> entries;
+        entries.reserve(count);
+
+        PropertyRow* current_row = head;
+        for (int i = 0; i < count; i++) {
+            int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
+            if (i > 0 && cell_id_in_row == 0)
+                current_row = current_row->next_;
+
+            auto& cell_ref = current_row->cells_[cell_id_in_row];
+            entries.emplace_back(static_cast<label_t>(cell_ref.pid.pid), &cell_ref);
+        }
+
+        bool is_table = count > ARRAY_THRESHOLD;
+        uint32_t capacity;
+        if (is_table) {
+            capacity = 1;
+            while (capacity < 2 * static_cast<uint32_t>(count))
+                capacity <<= 1;
+        } else {
+            capacity = (count + KEYS_PER_BLOCK - 1) / KEYS_PER_BLOCK * KEYS_PER_BLOCK;
+        }
+
+        size_t keys_offset = RoundUp(sizeof(PropertyCellIndex), sizeof(__m128i));
+        size_t cells_offset = RoundUp(keys_offset + capacity * sizeof(label_t), sizeof(CellType*));
+        void* buffer = nullptr;
+        CHECK_EQ(posix_memalign(&buffer, sizeof(__m128i), cells_offset + capacity * sizeof(CellType*)), 0);
+
+        PropertyCellIndex* index = new(buffer) PropertyCellIndex();
+        index->count_ = count;
+        index->capacity_ = capacity;
+        index->is_table_ = is_table;
+        index->last_row_ = current_row;
+        index->keys_ = reinterpret_cast<label_t*>(static_cast<char*>(buffer) + keys_offset);
+        index->cells_ = reinterpret_cast<CellType**>(static_cast<char*>(buffer) + cells_offset);
+
+        if (is_table) {
+            std::fill(index->cells_, index->cells_ + capacity, nullptr);
+            uint32_t mask = capacity - 1;
+            for (auto& entry : entries) {
+                uint32_t slot = Hash(entry.first) & mask;
+                while (index->cells_[slot] != nullptr)
+                    slot = (slot + 1) & mask;
+                index->keys_[slot] = entry.first;
+                index->cells_[slot] = entry.second;
+            }
+        } else {
+            std::sort(entries.begin(), entries.end());
+            for (int i = 0; i < count; i++) {
+                index->keys_[i] = entries[i].first;
+                index->cells_[i] = entries[i].second;
+            }
+            // Padding keys are larger than or equal to any key, and never returned
+            std::fill(index->keys_ + count, index->keys_ + capacity, static_cast<label_t>(~0));
+        }
+
+        return index;
+    }
+
+    static void Free(PropertyCellIndex* index) {
+        if (index != nullptr) {
+            index->~PropertyCellIndex();
+            free(index);
+        }
+    }
+
+    // nullptr if key is not in the indexed cells
+    CellType* Find(const label_t& key) const {
+        if (is_table_) {
+            uint32_t mask = capacity_ - 1;
+            for (uint32_t slot = Hash(key) & mask; cells_[slot] != nullptr; slot = (slot + 1) & mask) {
+                if (keys_[slot] == key)
+                    return cells_[slot];
+            }
+            return nullptr;
+        }
+
+        const __m128i target = _mm_set1_epi16(static_cast<int16_t>(key));
+        for (int i = 0; i < count_; i += KEYS_PER_BLOCK) {
+            __m128i block = _mm_load_si128(reinterpret_cast<const __m128i*>(keys_ + i));
+            int match = _mm_movemask_epi8(_mm_cmpeq_epi16(block, target));
+            if (match != 0) {
+                // 2 bits per matched key
+                int pos = i + (__builtin_ctz(match) >> 1);
+                return pos < count_ ? cells_[pos] : nullptr;
+            }
+            // Keys are sorted
+            if (keys_[i + KEYS_PER_BLOCK - 1] > key)
+                break;
+        }
+        return nullptr;
+    }
+
+    // Number of indexed cells, which are the first cells in the row list
+    int GetCount() const { return count_; }
+
+    // The row containing the last indexed cell
+    PropertyRow* GetLastRow() const { return last_row_; }
+
+ private:
+    static constexpr int KEYS_PER_BLOCK = sizeof(__m128i) / sizeof(label_t);
+
+    PropertyCellIndex() {}
+    ~PropertyCellIndex() {}
+
+    static inline uint32_t Hash(const label_t& key) {
+        return static_cast<uint32_t>(key) * 2654435761u >> 7;
+    }
+
+    static inline size_t RoundUp(size_t len, size_t align) {
+        return (len + align - 1) / align * align;
+    }
+
+    int count_;
+    uint32_t capacity_;
+    bool is_table_;
+    PropertyRow* last_row_;
+    label_t* keys_;
+    CellType** cells_;
+};
@@ -17,12 +17,15 @@
 #include <atomic>
 
 #include "layout/concurrent_mem_pool.hpp"
+#include "layout/epoch_manager.hpp"
 #include "layout/mvcc_list.hpp"
 #include "layout/mvcc_value_store.hpp"
+#include "layout/property_cell_index.hpp"
+#include "layout/row_prefetcher.hpp"
+#include "utils/seq_lock.hpp"
 #include "utils/tid_pool_manager.hpp"
 #include "utils/write_prior_rwlock.hpp"
 #include "tbb/atomic.h"
-#include "tbb/concurrent_hash_map.h"
 
 class GCProducer;
 class GCConsumer;
@@ -38,6 +41,12 @@ class PropertyRowList {
     // Initialized in data_storage.cpp
     static ConcurrentMemPool<PropertyRow>* mem_pool_;
     static MVCCValueStore* value_store_;
+    // Optional property keys whose strings are encoded by string_dict, nullptr if there is none
+    static unordered_set<label_t>* dict_pkeys_;
+
+    // Insert value into value_store_, as its code if p_key is in dict_pkeys_ and the string is in string_dict
+    static ValueHeader InsertValue(const label_t& p_key, const value_t& value);
+    // Read value from value_store_, and decode it if it is stored as a code
 
     std::atomic_int property_count_;
     tbb::atomic<PropertyRow*> head_, tail_;
@@ -47,20 +56,35 @@ class PropertyRowList {
     // property_count_ptr and tail_ptr will not be nullptr when called by ProcessedModifyProperty
     CellType* LocateCell(PidType pid, int* property_count_ptr = nullptr, PropertyRow** tail_ptr = nullptr);
 
-    typedef tbb::concurrent_hash_map<label_t, CellType*> CellMap;
-    CellMap* cell_map_;
-    typedef typename tbb::concurrent_hash_map<label_t, CellType*>::accessor CellAccessor;
-    typedef typename tbb::concurrent_hash_map<label_t, CellType*>::const_accessor CellConstAccessor;
+    // Index of cells for fast lookup when #cells > MAP_THRESHOLD, nullptr otherwise.
+    // It is immutable and rebuilt in AllocateCell() when enough cells are appended after it.
+    typedef PropertyCellIndex<PropertyRow> CellIndex;
+    CellIndex* cell_index_;
     static constexpr int MAP_THRESHOLD = PropertyRow::ROW_CELL_COUNT;
 
-    // This lock is implemented to guarantee the consistency of 4 variables: head_, tail_, property_count_ and cell_map_.
+    // True if cell_index should be rebuilt after the row list grows to property_count cells
+    static bool IndexOutdated(const int& property_count, CellIndex* cell_index);
+    // Find the cell of key by cell_index, and then in cells not indexed yet
+    static CellType* LookupCell(PropertyRow* head, const int& property_count, CellIndex* cell_index, const label_t& key);
+
+    // This lock is implemented to guarantee the consistency of 4 variables: head_, tail_, property_count_ and cell_index_.
     // These variables will be changed in AllocateCell(). Thus, in AllocateCell(), a write lock will be acquired.
-    // In other functions, a read lock will be acquired when reading a snapshot of those variables.
+    // In ProcessModifyProperty(), a read lock will be acquired when reading a snapshot of those variables.
+    // Readers take the snapshot by ReadSnapshot() instead.
     WritePriorRWLock rwlock_;
 
-    // This lock is only used to avoid conflict between gc operation (including delete all and defrag) and all other operations:
-    // write_lock -> gc; read_lock -> others
+    // This lock is only used to avoid conflict between gc operation (including delete all and defrag) and other operations
+    // modifying the row list: write_lock -> gc; read_lock -> others.
+    // Readers do not take it. They hold an EpochGuard, and gc replaces head_, tail_, property_count_ and cell_index_
+    // in a write scope of layout_seq_ without modifying the old rows.
     WritePriorRWLock gc_rwlock_;
+    SeqLock layout_seq_;
+
+    // Snapshot of head_, property_count_ and cell_index_ for readers
+    void ReadSnapshot(PropertyRow*& head, int& property_count, CellIndex*& cell_index);
+
+    // Free rows after all readers which may refer to them have left, see EpochManager
+    static void RetireRows(PropertyRow* head, const int& property_count);
 
  public:
     void Init();
@@ -91,6 +115,9 @@ class PropertyRowList {
     static void SetGlobalValueStore(MVCCValueStore* value_store_ptr) {
         value_store_ = value_store_ptr;
     }
+    static void SetGlobalDictKeys(unordered_set<label_t>* dict_pkeys) {
+        dict_pkeys_ = dict_pkeys;
+    }
 
     void SelfGarbageCollect();
     void SelfDefragment();
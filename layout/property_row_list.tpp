@@ -16,7 +16,7 @@ template <class PropertyRow>
 void PropertyRowList<PropertyRow>::Init() {
     head_ = tail_ = nullptr;
     property_count_ = 0;
-    cell_map_ = nullptr;
+    cell_index_ = nullptr;
 }
 
 // Allocate cell for one property, each pid should occupies only one cell
@@ -72,28 +72,13 @@ typename PropertyRowList<PropertyRow>::CellType* PropertyRowList<PropertyRow>::
 
         ret = &tail_->cells_[cell_id_in_row];
 
-        // Use map for fast traversal when #cells > threshold
-        if (property_count_snapshot >= MAP_THRESHOLD) {
-            if (cell_map_ == nullptr) {
-                cell_map_ = new CellMap;
-                PropertyRow* current_row = head_;
-                for (int i = 0; i < property_count_snapshot + 1; i++) {
-                    int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
-                    if (i > 0 && cell_id_in_row == 0) {
-                        current_row = current_row->next_;
-                    }
-
-                    auto& cell_ref = current_row->cells_[cell_id_in_row];
-
-                    CellAccessor accessor;
-                    cell_map_->insert(accessor, cell_ref.pid.pid);
-                    accessor->second = &cell_ref;
-                }
-            }
-
-            CellAccessor accessor;
-            cell_map_->insert(accessor, ret->pid.pid);
-            accessor->second = ret;
+        // Use index for fast traversal when #cells > threshold.
+        // Cells appended after the index is built are scanned by LookupCell, until there are enough to rebuild it.
+        if (IndexOutdated(property_count_snapshot + 1, cell_index_)) {
+            CellIndex* old_cell_index = cell_index_;
+            cell_index_ = CellIndex::Build(head_, property_count_snapshot + 1);
+            if (old_cell_index != nullptr)
+                EpochManager::GetInstance()->Retire([old_cell_index]() { CellIndex::Free(old_cell_index); });
         }
 
         // after the cell is initialized, increase the counter
@@ -103,49 +88,112 @@ typename PropertyRowList<PropertyRow>::CellType* PropertyRowList<PropertyRow>::
     return ret;
 }
 
+template <class PropertyRow>
+void PropertyRowList<PropertyRow>::ReadSnapshot(PropertyRow*& head, int& property_count, CellIndex*& cell_index) {
+    uint32_t seq;
+    do {
+        seq = layout_seq_.ReadBegin();
+        // In AllocateCell, property_count_ is increased after head_ and cell_index_ are set
+        property_count = property_count_;
+        head = head_;
+        cell_index = cell_index_;
+    } while (layout_seq_.ReadRetry(seq));
+}
+
+template <class PropertyRow>
+void PropertyRowList<PropertyRow>::RetireRows(PropertyRow* head, const int& property_count) {
+    vector<PropertyRow*> rows;
+    PropertyRow* current_row = head;
+    for (int i = 0; i < property_count; i += PropertyRow::ROW_CELL_COUNT) {
+        rows.emplace_back(current_row);
+        current_row = current_row->next_;
+    }
+
+    // Readers may be traversing the rows
+    EpochManager::GetInstance()->Retire([rows]() {
+        int tid = TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER);
+        for (int i = rows.size() - 1; i >= 0; i--)
+            mem_pool_->Free(rows[i], tid);
+    });
+}
+
+template <class PropertyRow>
+bool PropertyRowList<PropertyRow>::IndexOutdated(const int& property_count, CellIndex* cell_index) {
+    if (property_count <= MAP_THRESHOLD)
+        return false;
+
+    // Rebuild when the cells not indexed are more than a quarter of the indexed ones, thus the amortized cost is O(1)
+    int indexed_count = (cell_index == nullptr) ? 0 : cell_index->GetCount();
+    return property_count - indexed_count >= max(MAP_THRESHOLD, indexed_count / 4);
+}
+
+template <class PropertyRow>
+typename PropertyRowList<PropertyRow>::CellType* PropertyRowList<PropertyRow>::
+        LookupCell(PropertyRow* head, const int& property_count, CellIndex* cell_index, const label_t& key) {
+    PropertyRow* current_row = head;
+    int i = 0;
+    if (cell_index != nullptr) {
+        CellType* cell = cell_index->Find(key);
+        if (cell != nullptr)
+            return cell;
+
+        // Continue from the first cell not indexed
+        current_row = cell_index->GetLastRow();
+        i = cell_index->GetCount();
+    }
+
+    for (; i < property_count; i++) {
+        int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
+        if (i > 0 && cell_id_in_row == 0) {
+            current_row = current_row->next_;
+        }
+
+        auto& cell_ref = current_row->cells_[cell_id_in_row];
+
+        if (cell_ref.pid.pid == key) {
+            return &cell_ref;
+        }
+    }
+
+    return nullptr;
+}
+
 template <class PropertyRow>
 typename PropertyRowList<PropertyRow>::CellType* PropertyRowList<PropertyRow>::
         LocateCell(PidType pid, int* property_count_ptr, PropertyRow** tail_ptr) {
     PropertyRow* current_row;
     int property_count_snapshot;
-    CellMap* map_snapshot;
+    CellIndex* index_snapshot;
 
-    {
+    if (property_count_ptr != nullptr) {
         ReaderLockGuard reader_lock_guard(rwlock_);
 
-        map_snapshot = cell_map_;
+        index_snapshot = cell_index_;
         property_count_snapshot = property_count_;
         current_row = head_;
 
-        if (property_count_ptr != nullptr) {
-            // called by AllocateCell, need to return the snapshot of property_count_ and tail_ via pointers
-            *property_count_ptr = property_count_snapshot;
-            *tail_ptr = tail_;
-        }
+        // called by AllocateCell, need to return the snapshot of property_count_ and tail_ via pointers
+        *property_count_ptr = property_count_snapshot;
+        *tail_ptr = tail_;
+    } else {
+        ReadSnapshot(current_row, property_count_snapshot, index_snapshot);
     }
 
-    if (map_snapshot == nullptr) {
-        // Traverse the whole PropertyRowList
-        for (int i = 0; i < property_count_snapshot; i++) {
-            int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
-            if (i > 0 && cell_id_in_row == 0) {
-                current_row = current_row->next_;
-            }
+    // Cells of a row list share the same vid (or eid)
+    return LookupCell(current_row, property_count_snapshot, index_snapshot, pid.pid);
+}
 
-            auto& cell_ref = current_row->cells_[cell_id_in_row];
+template <class PropertyRow>
+ValueHeader PropertyRowList<PropertyRow>::InsertValue(const label_t& p_key, const value_t& value) {
+    int tid = TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER);
 
-            if (cell_ref.pid == pid) {
-                return &cell_ref;
-            }
-        }
-    } else {
-        CellConstAccessor accessor;
-        if (map_snapshot->find(accessor, pid.pid)) {
-            return accessor->second;
-        }
+    if (dict_pkeys_ != nullptr && value.type == StringValueType && dict_pkeys_->count(p_key) != 0) {
+        value_t code;
+        if (string_dict::GetInstance()->Encode(value, code))
+            return value_store_->InsertValue(code, tid);
     }
 
-    return nullptr;
+    return value_store_->InsertValue(value, tid);
 }
 
 template <class PropertyRow>
@@ -166,15 +214,21 @@ void PropertyRowList<PropertyRow>::InsertInitialCell(const PidType& pid, const v
     tail_->cells_[cell_id_in_row].pid = pid;
 
     MVCCListType* mvcc_list = new MVCCListType;
-    *(mvcc_list->AppendInitialVersion()) = value_store_->InsertValue(value, TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER));
+    *(mvcc_list->AppendInitialVersion()) = InsertValue(pid.pid, value);
     tail_->cells_[cell_id_in_row].mvcc_list = mvcc_list;
+
+    // No reader during loading, the old index is freed directly
+    if (IndexOutdated(cell_id + 1, cell_index_)) {
+        CellIndex::Free(cell_index_);
+        cell_index_ = CellIndex::Build(head_, cell_id + 1);
+    }
 }
 
 template <class PropertyRow>
 READ_STAT PropertyRowList<PropertyRow>::
         ReadProperty(const PidType& pid, const uint64_t& trx_id, const uint64_t& begin_time,
                      const bool& read_only, value_t& ret) {
-    ReaderLockGuard reader_lock_guard(gc_rwlock_);
+    EpochGuard epoch_guard;
     auto* cell = LocateCell(pid);
     if (cell == nullptr)
         return READ_STAT::NOTFOUND;
@@ -198,7 +252,7 @@ READ_STAT PropertyRowList<PropertyRow>::
         return READ_STAT::SUCCESS;
     } else {
         // this property was deleted
-        READ_STAT::NOTFOUND;
+        return READ_STAT::NOTFOUND;
     }
 }
 
@@ -206,27 +260,22 @@ template <class PropertyRow>
 READ_STAT PropertyRowList<PropertyRow>::ReadPropertyByPKeyList(const vector<label_t>& p_key, const uint64_t& trx_id,
                                                                const uint64_t& begin_time, const bool& read_only,
                                                                vector<pair<label_t, value_t>>& ret) {
-    ReaderLockGuard reader_lock_guard(gc_rwlock_);
+    EpochGuard epoch_guard;
     PropertyRow* current_row;
     int property_count_snapshot;
-    CellMap* map_snapshot;
-
-    {
-        ReaderLockGuard reader_lock_guard(rwlock_);
-        map_snapshot = cell_map_;
-        property_count_snapshot = property_count_;
-        current_row = head_;
-    }
+    CellIndex* index_snapshot;
+    ReadSnapshot(current_row, property_count_snapshot, index_snapshot);
     if (current_row == nullptr)
         return READ_STAT::NOTFOUND;
 
-    if (map_snapshot == nullptr) {
+    if (index_snapshot == nullptr) {
         // Traverse the whole PropertyRowList
         set<label_t> pkey_set;
         for (auto p_label : p_key) {
             pkey_set.insert(p_label);
         }
 
+        // No RowPrefetcher here, since only the cells of p_key are read and the loop stops once all of them are found
         for (int i = 0; i < property_count_snapshot; i++) {
             if (pkey_set.size() == 0) {
                 // All needed properties has been fetched.
@@ -270,11 +319,11 @@ READ_STAT PropertyRowList<PropertyRow>::ReadPropertyByPKeyList(const vector<labe
             }
         }
     } else {
-        // The index map exists
+        // The index exists
         for (auto p_label : p_key) {
-            CellConstAccessor accessor;
-            if (map_snapshot->find(accessor, p_label)) {
-                auto& cell_ref = *(accessor->second);
+            CellType* cell = LookupCell(current_row, property_count_snapshot, index_snapshot, p_label);
+            if (cell != nullptr) {
+                auto& cell_ref = *cell;
 
                 MVCCListType* mvcc_list = cell_ref.mvcc_list;
 
@@ -314,15 +363,13 @@ template <class PropertyRow>
 READ_STAT PropertyRowList<PropertyRow>::
         ReadAllProperty(const uint64_t& trx_id, const uint64_t& begin_time,
                         const bool& read_only, vector<pair<label_t, value_t>>& ret) {
-    ReaderLockGuard reader_lock_guard(gc_rwlock_);
+    EpochGuard epoch_guard;
     PropertyRow* current_row;
     int property_count_snapshot;
+    CellIndex* index_snapshot;
+    ReadSnapshot(current_row, property_count_snapshot, index_snapshot);
 
-    {
-        ReaderLockGuard reader_lock_guard(rwlock_);
-        current_row = head_;
-        property_count_snapshot = property_count_;
-    }
+    RowPrefetcher<PropertyRow, MVCCListType> prefetcher(current_row, property_count_snapshot);
 
     for (int i = 0; i < property_count_snapshot; i++) {
         int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
@@ -330,6 +377,7 @@ READ_STAT PropertyRowList<PropertyRow>::
             current_row = current_row->next_;
         }
 
+        prefetcher.Advance();
         auto& cell_ref = current_row->cells_[cell_id_in_row];
 
         MVCCListType* mvcc_list = cell_ref.mvcc_list;
@@ -365,16 +413,12 @@ template <class PropertyRow>
 READ_STAT PropertyRowList<PropertyRow>::
         ReadPidList(const uint64_t& trx_id, const uint64_t& begin_time,
                     const bool& read_only, vector<PidType>& ret) {
-    ReaderLockGuard reader_lock_guard(gc_rwlock_);
+    EpochGuard epoch_guard;
 
     PropertyRow* current_row;
     int property_count_snapshot;
-
-    {
-        ReaderLockGuard reader_lock_guard(rwlock_);
-        current_row = head_;
-        property_count_snapshot = property_count_;
-    }
+    CellIndex* index_snapshot;
+    ReadSnapshot(current_row, property_count_snapshot, index_snapshot);
 
     for (int i = 0; i < property_count_snapshot; i++) {
         int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
@@ -449,7 +493,7 @@ pair<bool, typename PropertyRowList<PropertyRow>::MVCCListType*> PropertyRowList
     if (version_val_ptr == nullptr)  // modify failed
         return make_pair(true, nullptr);
 
-    *version_val_ptr = value_store_->InsertValue(value, TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER));
+    *version_val_ptr = InsertValue(pid.pid, value);
 
     if (!modify_flag) {
         // For a newly added cell, assign the mvcc_list after it has been initialized.
@@ -491,46 +535,43 @@ template <class PropertyRow>
 void PropertyRowList<PropertyRow>::SelfGarbageCollect() {
     // Free all cells
     WriterLockGuard writer_lock_guard(gc_rwlock_);
-    PropertyRow* current_row = head_;
-    if (current_row == nullptr)
+    if (head_ == nullptr)
         return;
 
-    int row_count = property_count_ / PropertyRow::ROW_CELL_COUNT;
-    if (row_count * PropertyRow::ROW_CELL_COUNT != property_count_)
-        row_count++;
-    if (row_count == 0)
-        row_count = 1;
-
-    PropertyRow** row_ptrs = new PropertyRow*[row_count];
-    row_ptrs[0] = head_;
-    int row_ptr_count = 1;
+    PropertyRow* old_head = head_;
+    int old_property_count = property_count_;
+    CellIndex* old_cell_index = cell_index_;
+    {
+        SeqLock::WriteScope write_scope(layout_seq_);
+        head_ = nullptr;
+        tail_ = nullptr;
+        property_count_ = 0;
+        cell_index_ = nullptr;
+    }
 
-    for (int i = 0; i < property_count_; i++) {
+    // MVCCLists are only referred by the rows, free them together with the rows
+    vector<MVCCListType*> mvcc_lists;
+    PropertyRow* current_row = old_head;
+    for (int i = 0; i < old_property_count; i++) {
         int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
-        if (i > 0 && cell_id_in_row == 0) {
+        if (i > 0 && cell_id_in_row == 0)
             current_row = current_row->next_;
-            row_ptrs[row_ptr_count++] = current_row;
-        }
-
-        auto& cell_ref = current_row->cells_[cell_id_in_row];
-        MVCCListType* mvcc_list = cell_ref.mvcc_list;
-
-        mvcc_list->SelfGarbageCollect();
-        delete mvcc_list;
+        mvcc_lists.emplace_back(current_row->cells_[cell_id_in_row].mvcc_list);
     }
 
-    for (int i = row_count - 1; i >= 0; i--) {
-        mem_pool_->Free(row_ptrs[i], TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER));
-    }
-
-    head_ = nullptr;
-    tail_ = nullptr;
-
-    delete[] row_ptrs;
-    if (cell_map_ != nullptr)
-        delete cell_map_;
+    EpochManager::GetInstance()->Retire([mvcc_lists, old_cell_index]() {
+        for (MVCCListType* mvcc_list : mvcc_lists) {
+            mvcc_list->SelfGarbageCollect();
+            delete mvcc_list;
+        }
+        CellIndex::Free(old_cell_index);
+    });
+    RetireRows(old_head, old_property_count);
 }
 
+/* Copy-on-write: cells still referring to versions are copied to new rows, which replace the old rows at once.
+ * The old rows are not modified, since readers without gc_rwlock_ may be traversing them.
+ */
 template <class PropertyRow>
 void PropertyRowList<PropertyRow>::SelfDefragment() {
     // Scan and collect cell
@@ -539,23 +580,18 @@ void PropertyRowList<PropertyRow>::SelfDefragment() {
     if (current_row == nullptr)
         return;
 
-    int row_count = property_count_ / PropertyRow::ROW_CELL_COUNT;
-    if (row_count * PropertyRow::ROW_CELL_COUNT != property_count_)
-        row_count++;
-    if (row_count == 0)
-        row_count = 1;
+    int old_property_count = property_count_;
+    int tid = TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER);
 
-    PropertyRow** row_ptrs = new PropertyRow*[row_count];
-    row_ptrs[0] = head_;
-    int row_ptr_count = 1;
+    PropertyRow* new_head = nullptr;
+    PropertyRow* new_tail = nullptr;
+    int new_property_count = 0;
+    vector<MVCCListType*> empty_mvcc_lists;
 
-    queue<pair<int, int>> empty_cell_queue;
-    // Collect empty cell info
-    for (int i = 0; i < property_count_; i++) {
+    for (int i = 0; i < old_property_count; i++) {
         int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
         if (i > 0 && cell_id_in_row == 0) {
             current_row = current_row->next_;
-            row_ptrs[row_ptr_count++] = current_row;
         }
 
         auto& cell_ref = current_row->cells_[cell_id_in_row];
@@ -563,93 +599,59 @@ void PropertyRowList<PropertyRow>::SelfDefragment() {
 
         CHECK(mvcc_list != nullptr);
 
-        // mark the gcable cell's mvcc_list as nullptr
         if (mvcc_list->GetHead() == nullptr) {
-            // gc cell, record to empty cell
-            empty_cell_queue.emplace((int) (i / PropertyRow::ROW_CELL_COUNT), cell_id_in_row);
-            mvcc_list->SelfGarbageCollect();
-            delete mvcc_list;
-            cell_ref.mvcc_list = nullptr;
-
-            // erase from the index map
-            if (cell_map_ != nullptr)
-                cell_map_->erase(cell_ref.pid.pid);
+            // gc cell
+            empty_mvcc_lists.emplace_back(mvcc_list);
+            continue;
         }
-    }
 
-    if (empty_cell_queue.empty())
-        return;
-
-    int inverse_cell_index = property_count_ - 1;
-    int cur_property_count = property_count_ - empty_cell_queue.size();
-    int num_movable_cell = cur_property_count;
-    int inverse_row_index = row_count - 1;
-
-    // Calculate removable row
-    int cur_row_count = cur_property_count / PropertyRow::ROW_CELL_COUNT + 1;
-    if (cur_property_count % PropertyRow::ROW_CELL_COUNT == 0) {
-        cur_row_count--;
-    }
-
-    // move cell from tail to empty cell
-    while (true) {
-        int cell_id_in_row = inverse_cell_index % PropertyRow::ROW_CELL_COUNT;
-        if (cell_id_in_row == PropertyRow::ROW_CELL_COUNT - 1 &&
-            inverse_cell_index != property_count_ - 1) {
-            inverse_row_index--;
-            CHECK_GE(inverse_row_index, 0);
+        int new_cell_id_in_row = new_property_count % PropertyRow::ROW_CELL_COUNT;
+        if (new_cell_id_in_row == 0) {
+            auto* new_row = mem_pool_->Get(tid);
+            new_row->next_ = nullptr;
+            if (new_head == nullptr) {
+                new_head = new_tail = new_row;
+            } else {
+                new_tail->next_ = new_row;
+                new_tail = new_row;
+            }
         }
 
-        auto& cell_ref = row_ptrs[inverse_row_index]->cells_[cell_id_in_row];
-        MVCCListType* mvcc_list = cell_ref.mvcc_list;
+        new_tail->cells_[new_cell_id_in_row] = cell_ref;
+        new_property_count++;
+    }
 
-        // move a non-empty cell to an empty cell
-        if (mvcc_list != nullptr) {
-            CHECK(mvcc_list->GetHead() != nullptr);
-            num_movable_cell--;
-            pair<int, int> empty_cell = empty_cell_queue.front();
-            empty_cell_queue.pop();
-            row_ptrs[empty_cell.first]->cells_[empty_cell.second] = cell_ref;
+    if (empty_mvcc_lists.empty()) {
+        // Nothing to defrag, the new rows are not published yet
+        while (new_head != nullptr) {
+            PropertyRow* next_row = new_head->next_;
+            mem_pool_->Free(new_head, tid);
+            new_head = next_row;
         }
-
-        if (empty_cell_queue.size() == 0 || num_movable_cell == 0) { break; }
-
-        inverse_cell_index--;
-        if (inverse_cell_index < 0) { break; }
+        return;
     }
 
-    // Recycle removable row
-    for (int i = row_count - 1; i > cur_row_count - 1; i--) {
-        if (i-1 >= 0) { row_ptrs[i-1]->next_ = nullptr; }
-        mem_pool_->Free(row_ptrs[i], TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER));
-    }
+    // Index the remaining properties in a new index, since readers may be looking up the old one
+    CellIndex* new_cell_index = nullptr;
+    if (new_property_count > MAP_THRESHOLD)
+        new_cell_index = CellIndex::Build(new_head, new_property_count);
 
-    if (cur_row_count == 0) {
-        head_ = nullptr;
-        tail_ = nullptr;
-    } else {
-        tail_ = row_ptrs[cur_row_count - 1];
+    PropertyRow* old_head = head_;
+    CellIndex* old_cell_index = cell_index_;
+    {
+        SeqLock::WriteScope write_scope(layout_seq_);
+        head_ = new_head;
+        tail_ = new_tail;
+        property_count_ = new_property_count;
+        cell_index_ = new_cell_index;
     }
 
-    property_count_ = cur_property_count;
-
-    delete[] row_ptrs;
-
-    if (cell_map_ == nullptr)
-        return;
-
-    // reindex the cell_map_ for the remaining properties
-    current_row = head_;
-    for (int i = 0; i < property_count_; i++) {
-        int cell_id_in_row = i % PropertyRow::ROW_CELL_COUNT;
-        if (i > 0 && cell_id_in_row == 0)
-            current_row = current_row->next_;
-
-        auto& cell_ref = current_row->cells_[cell_id_in_row];
-
-        CellAccessor accessor;
-        CHECK(cell_map_->find(accessor, cell_ref.pid.pid));
-
-        accessor->second = &cell_ref;
-    }
-}
\ No newline at end of file
+    EpochManager::GetInstance()->Retire([empty_mvcc_lists, old_cell_index]() {
+        for (MVCCListType* mvcc_list : empty_mvcc_lists) {
+            mvcc_list->SelfGarbageCollect();
+            delete mvcc_list;
+        }
+        CellIndex::Free(old_cell_index);
+    });
+    RetireRows(old_head, old_property_count);
+}
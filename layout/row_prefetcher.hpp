@@ -0,0 +1,101 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+
+/* Software prefetching for readers that walk all cells in a row list
+ * (TopologyRowList and PropertyRowList).
+ * Reading a cell chases cell -> MVCCList -> version, and each hop is likely a cache miss.
+ * The prefetcher runs two stages ahead of the reader:
+ *  stage 1: prefetch the MVCCList of the cell 2 * DISTANCE ahead;
+ *  stage 2: prefetch the head and tail versions of the cell DISTANCE ahead,
+ *           whose MVCCList has been prefetched by stage 1.
+ * Distances only count the cells needed by the reader, so that skipping cells (e.g., of other labels)
+ * does not shorten the pipeline. Thus, the misses of up to 2 * DISTANCE needed cells are in flight at the same time.
+ *
+ * Usage: call Advance() once at the beginning of each iteration of the reader loop,
+ *        including the cells skipped by the reader.
+ */
+template <class Row, class MVCCListType>
+class RowPrefetcher {
+ public:
+    static constexpr int DISTANCE = 4;
+
+    RowPrefetcher(Row* head, int cell_count) :
+        reader_cursor_(head), list_cursor_(head), version_cursor_(head), cell_count_(cell_count) {}
+
+    // need(cell) returns false for the cells that will be skipped by the reader
+    template <class NeedFunc>
+    void Advance(const NeedFunc& need) {
+        // The cell to be read now has been counted by the stages if it is needed
+        if (reader_cursor_.id < list_cursor_.id && need(reader_cursor_.Cell()))
+            list_ahead_--;
+        if (reader_cursor_.id < version_cursor_.id && need(reader_cursor_.Cell()))
+            version_ahead_--;
+        reader_cursor_.Next();
+
+        while (list_ahead_ < 2 * DISTANCE && list_cursor_.id < cell_count_) {
+            auto& cell = list_cursor_.Cell();
+            if (need(cell)) {
+                MVCCListType* mvcc_list = cell.mvcc_list;
+                __builtin_prefetch(mvcc_list);
+                list_ahead_++;
+            }
+            list_cursor_.Next();
+        }
+
+        while (version_ahead_ < DISTANCE && version_cursor_.id < cell_count_) {
+            auto& cell = version_cursor_.Cell();
+            if (need(cell)) {
+                MVCCListType* mvcc_list = cell.mvcc_list;
+                // mvcc_list could be nullptr if it is being edited by other transaction
+                if (mvcc_list != nullptr)
+                    mvcc_list->PrefetchVersions();
+                version_ahead_++;
+            }
+            version_cursor_.Next();
+        }
+    }
+
+    void Advance() {
+        Advance([](const decltype(Row::cells_[0])&) { return true; });
+    }
+
+ private:
+    struct Cursor {
+        Row* row;
+        int id = 0;
+
+        explicit Cursor(Row* head) : row(head) {}
+
+        auto& Cell() {
+            return row->cells_[id % Row::ROW_CELL_COUNT];
+        }
+
+        // Only called when id < cell count, thus row->next_ has been initialized if needed
+        void Next() {
+            id++;
+            if (id % Row::ROW_CELL_COUNT == 0)
+                row = row->next_;
+        }
+    };
+
+    Cursor reader_cursor_, list_cursor_, version_cursor_;
+    int cell_count_;
+    // Needed cells passed by a stage but not yet by the reader
+    int list_ahead_ = 0;
+    int version_ahead_ = 0;
+};
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "layout/topology_row_list.hpp"
+#include "layout/epoch_manager.hpp"
 #include "layout/layout_type.hpp"
+#include "layout/row_prefetcher.hpp"
 
 void TopologyRowList::Init(const vid_t& my_vid) {
     my_vid_ = my_vid;
@@ -30,7 +32,7 @@ TopologyRowList::~TopologyRowList() {
  * This is guaranteed by DataStorage::ProcessAddE
  * So we do not need to perform cell check like TopologyRowList::AllocateCell
  */
-void TopologyRowList::AllocateCell(const bool& is_out, const vid_t& conn_vtx_id,
+void TopologyRowList::AllocateCell(const bool& is_out, const vid_t& conn_vtx_id, const label_t& label,
                                    MVCCList<EdgeMVCCItem>* mvcc_list) {
     pthread_spin_lock(&lock_);
     int cell_id = edge_count_;
@@ -47,6 +49,7 @@ void TopologyRowList::AllocateCell(const bool& is_out, const vid_t& conn_vtx_id,
     }
 
     tail_->cells_[cell_id_in_row].is_out = is_out;
+    tail_->cells_[cell_id_in_row].label = label;
     tail_->cells_[cell_id_in_row].conn_vtx_id = conn_vtx_id;
     tail_->cells_[cell_id_in_row].mvcc_list = mvcc_list;
 
@@ -63,7 +66,7 @@ MVCCList<EdgeMVCCItem>* TopologyRowList::InsertInitialCell(const bool& is_out, c
     MVCCList<EdgeMVCCItem>* mvcc_list = new MVCCList<EdgeMVCCItem>;
     mvcc_list->AppendInitialVersion()[0] = EdgeVersion(label, ep_row_list_ptr);
 
-    AllocateCell(is_out, conn_vtx_id, mvcc_list);
+    AllocateCell(is_out, conn_vtx_id, label, mvcc_list);
 
     return mvcc_list;
 }
@@ -71,12 +74,27 @@ MVCCList<EdgeMVCCItem>* TopologyRowList::InsertInitialCell(const bool& is_out, c
 READ_STAT TopologyRowList::ReadConnectedVertex(const Direction_T& direction, const label_t& edge_label,
                                                const uint64_t& trx_id, const uint64_t& begin_time,
                                                const bool& read_only, vector<vid_t>& ret) {
-    ReaderLockGuard reader_lock_guard(gc_rwlock_);
-    VertexEdgeRow* current_row = head_;
+    EpochGuard epoch_guard;
+
+    VertexEdgeRow* current_row;
+    int current_edge_count;
+    uint32_t seq;
+    do {
+        seq = layout_seq_.ReadBegin();
+        current_row = head_;
+        current_edge_count = edge_count_;
+    } while (layout_seq_.ReadRetry(seq));
+
     if (current_row == nullptr)
         return READ_STAT::SUCCESS;
 
-    int current_edge_count = edge_count_;
+    // Only prefetch for scans without label filter. With a label filter, most cells are skipped by
+    // MayMatchLabel without touching their mvcc_list, and the prefetcher only adds overhead
+    bool prefetch = (edge_label == 0);
+    auto need_cell = [&](const EdgeHeader& cell) {
+        return direction == BOTH || (cell.is_out == (direction == OUT));
+    };
+    RowPrefetcher<VertexEdgeRow, MVCCList<EdgeMVCCItem>> prefetcher(current_row, current_edge_count);
 
     for (int i = 0; i < current_edge_count; i++) {
         int cell_id_in_row = i % VE_ROW_CELL_COUNT;
@@ -84,8 +102,14 @@ READ_STAT TopologyRowList::ReadConnectedVertex(const Direction_T& direction, con
             current_row = current_row->next_;
         }
 
+        if (prefetch)
+            prefetcher.Advance(need_cell);
         auto& cell_ref = current_row->cells_[cell_id_in_row];
 
+        // Skip the mvcc_list of edges with other labels
+        if (!cell_ref.MayMatchLabel(edge_label))
+            continue;
+
         if (direction == BOTH || (cell_ref.is_out == (direction == OUT))) {
             EdgeVersion edge_version;
             pair<bool, bool> is_visible = cell_ref.mvcc_list->GetVisibleVersion(trx_id, begin_time, read_only, edge_version);
@@ -109,13 +133,27 @@ READ_STAT TopologyRowList::ReadConnectedVertex(const Direction_T& direction, con
 READ_STAT TopologyRowList::ReadConnectedEdge(const Direction_T& direction, const label_t& edge_label,
                                              const uint64_t& trx_id, const uint64_t& begin_time,
                                              const bool& read_only, vector<eid_t>& ret) {
-    ReaderLockGuard reader_lock_guard(gc_rwlock_);
-    VertexEdgeRow* current_row = head_;
+    EpochGuard epoch_guard;
+
+    VertexEdgeRow* current_row;
+    int current_edge_count;
+    uint32_t seq;
+    do {
+        seq = layout_seq_.ReadBegin();
+        current_row = head_;
+        current_edge_count = edge_count_;
+    } while (layout_seq_.ReadRetry(seq));
 
     if (current_row == nullptr)
         return READ_STAT::SUCCESS;
 
-    int current_edge_count = edge_count_;
+    // Only prefetch for scans without label filter. With a label filter, most cells are skipped by
+    // MayMatchLabel without touching their mvcc_list, and the prefetcher only adds overhead
+    bool prefetch = (edge_label == 0);
+    auto need_cell = [&](const EdgeHeader& cell) {
+        return direction == BOTH || (cell.is_out == (direction == OUT));
+    };
+    RowPrefetcher<VertexEdgeRow, MVCCList<EdgeMVCCItem>> prefetcher(current_row, current_edge_count);
 
     for (int i = 0; i < current_edge_count; i++) {
         int cell_id_in_row = i % VE_ROW_CELL_COUNT;
@@ -123,8 +161,14 @@ READ_STAT TopologyRowList::ReadConnectedEdge(const Direction_T& direction, const
             current_row = current_row->next_;
         }
 
+        if (prefetch)
+            prefetcher.Advance(need_cell);
         auto& cell_ref = current_row->cells_[cell_id_in_row];
 
+        // Skip the mvcc_list of edges with other labels
+        if (!cell_ref.MayMatchLabel(edge_label))
+            continue;
+
         if (direction == BOTH || (cell_ref.is_out == (direction == OUT))) {
             EdgeVersion edge_version;
             pair<bool, bool> is_visible = cell_ref.mvcc_list->GetVisibleVersion(trx_id, begin_time, read_only, edge_version);
@@ -157,11 +201,56 @@ MVCCList<EdgeMVCCItem>* TopologyRowList::ProcessAddEdge(const bool& is_out, cons
     MVCCList<EdgeMVCCItem>* mvcc_list = new MVCCList<EdgeMVCCItem>;
     mvcc_list->AppendVersion(trx_id, begin_time)[0] = EdgeVersion(edge_label, ep_row_list_ptr);
 
-    AllocateCell(is_out, conn_vtx_id, mvcc_list);
+    AllocateCell(is_out, conn_vtx_id, edge_label, mvcc_list);
 
     return mvcc_list;
 }
 
+/* Called by DataStorage::ProcessAddE when an existing edge gets a new version.
+ * If the label changes, the label in the cell is no longer reliable,
+ * and readers have to check the label in the visible version instead.
+ * This scans the whole row list, but only happens when re-adding an edge.
+ */
+void TopologyRowList::ProcessRelabelEdge(const bool& is_out, const vid_t& conn_vtx_id, const label_t& edge_label) {
+    ReaderLockGuard reader_lock_guard(gc_rwlock_);
+    VertexEdgeRow* current_row = head_;
+    if (current_row == nullptr)
+        return;
+
+    int current_edge_count = edge_count_;
+
+    for (int i = 0; i < current_edge_count; i++) {
+        int cell_id_in_row = i % VE_ROW_CELL_COUNT;
+        if (i > 0 && cell_id_in_row == 0) {
+            current_row = current_row->next_;
+        }
+
+        auto& cell_ref = current_row->cells_[cell_id_in_row];
+
+        if (cell_ref.is_out == is_out && cell_ref.conn_vtx_id.value() == conn_vtx_id.value()) {
+            if (cell_ref.label != edge_label)
+                cell_ref.label = EdgeHeader::LABEL_MIXED;
+            return;
+        }
+    }
+}
+
+void TopologyRowList::RetireRows(VertexEdgeRow* head, const int& edge_count) {
+    vector<VertexEdgeRow*> rows;
+    VertexEdgeRow* current_row = head;
+    for (int i = 0; i < edge_count; i += VE_ROW_CELL_COUNT) {
+        rows.emplace_back(current_row);
+        current_row = current_row->next_;
+    }
+
+    // Readers may be traversing the rows
+    EpochManager::GetInstance()->Retire([rows]() {
+        int tid = TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER);
+        for (int i = rows.size() - 1; i >= 0; i--)
+            mem_pool_->Free(rows[i], tid);
+    });
+}
+
 void TopologyRowList::SelfGarbageCollect(vector<pair<eid_t, bool>>* gcable_eids) {
     WriterLockGuard writer_lock_guard(gc_rwlock_);
     VertexEdgeRow* current_row = head_;
@@ -169,21 +258,10 @@ void TopologyRowList::SelfGarbageCollect(vector<pair<eid_t, bool>>* gcable_eids)
     if (current_row == nullptr)
         return;
 
-    int row_count = edge_count_ / VE_ROW_CELL_COUNT;
-    if (row_count * VE_ROW_CELL_COUNT != edge_count_)
-        row_count++;
-    if (row_count == 0)
-        row_count = 1;
-
-    VertexEdgeRow** row_ptrs = new VertexEdgeRow*[row_count];
-    row_ptrs[0] = head_;
-    int row_ptr_count = 1;
-
     for (int i = 0; i < edge_count_; i++) {
         int cell_id_in_row = i % VE_ROW_CELL_COUNT;
         if (i > 0 && cell_id_in_row == 0) {
             current_row = current_row->next_;
-            row_ptrs[row_ptr_count++] = current_row;
         }
 
         auto& cell_ref = current_row->cells_[cell_id_in_row];
@@ -206,20 +284,26 @@ void TopologyRowList::SelfGarbageCollect(vector<pair<eid_t, bool>>* gcable_eids)
             itr = itr->GetNext();
         }
 
+        // head_ of mvcc_list should be nullptr before the edge maps are erased
         cell_ref.mvcc_list->SelfGarbageCollect();
         // Do not need to delete mvcc_list, since mvcc_list is still referred by e_map
     }
 
-    for (int i = row_count - 1; i >= 0; i--) {
-        mem_pool_->Free(row_ptrs[i], TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER));
+    VertexEdgeRow* old_head = head_;
+    int old_edge_count = edge_count_;
+    {
+        SeqLock::WriteScope write_scope(layout_seq_);
+        head_ = nullptr;
+        tail_ = nullptr;
+        edge_count_ = 0;
     }
 
-    head_ = nullptr;
-    tail_ = nullptr;
-
-    delete[] row_ptrs;
+    RetireRows(old_head, old_edge_count);
 }
 
+/* Copy-on-write: cells still referring to versions are copied to new rows, which replace the old rows at once.
+ * The old rows are not modified, since readers without gc_rwlock_ may be traversing them.
+ */
 void TopologyRowList::SelfDefragment(vector<pair<eid_t, bool>>* gcable_eids) {
     WriterLockGuard writer_lock_guard(gc_rwlock_);
     VertexEdgeRow* current_row = head_;
@@ -227,22 +311,17 @@ void TopologyRowList::SelfDefragment(vector<pair<eid_t, bool>>* gcable_eids) {
     if (current_row == nullptr)
         return;
 
-    int row_count = edge_count_ / VE_ROW_CELL_COUNT;
-    if (row_count * VE_ROW_CELL_COUNT != edge_count_)
-        row_count++;
-    if (row_count == 0)
-        row_count = 1;
+    int old_edge_count = edge_count_;
+    int tid = TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER);
 
-    VertexEdgeRow** row_ptrs = new VertexEdgeRow*[row_count];
-    row_ptrs[0] = head_;
-    int row_ptr_count = 1;
+    VertexEdgeRow* new_head = nullptr;
+    VertexEdgeRow* new_tail = nullptr;
+    int new_edge_count = 0;
 
-    queue<pair<int, int>> empty_cell_queue;
-    for (int i = 0; i < edge_count_; i++) {
+    for (int i = 0; i < old_edge_count; i++) {
         int cell_id_in_row = i % VE_ROW_CELL_COUNT;
         if (i > 0 && cell_id_in_row == 0) {
             current_row = current_row->next_;
-            row_ptrs[row_ptr_count++] = current_row;
         }
 
         auto& cell_ref = current_row->cells_[cell_id_in_row];
@@ -256,68 +335,43 @@ void TopologyRowList::SelfDefragment(vector<pair<eid_t, bool>>* gcable_eids) {
                 gcable_eids->emplace_back(eid, false);
             }
 
-            // gc cell, record to empty cell
-            empty_cell_queue.emplace((int)(i / VE_ROW_CELL_COUNT), cell_id_in_row);
-
             // Do not need to delete mvcc_list, since mvcc_list is still referred by e_map
+            continue;
         }
-    }
-
-    if (empty_cell_queue.size() == 0)
-        return;
-
-    int inverse_cell_index = edge_count_ - 1;
-    int cur_edge_count = edge_count_ - empty_cell_queue.size();
-    int num_movable_cell = cur_edge_count;
-    int inverse_row_index = row_count - 1;
-
-    // Calculate removable row
-    int cur_row_count = cur_edge_count / VE_ROW_CELL_COUNT + 1;
-    if (cur_edge_count % VE_ROW_CELL_COUNT == 0) {
-        cur_row_count--;
-    }
-
-    // move cell from tail to empty cell
-    while (true) {
-        int cell_id_in_row = inverse_cell_index % VE_ROW_CELL_COUNT;
-        if (cell_id_in_row == VE_ROW_CELL_COUNT - 1 &&
-            inverse_cell_index != edge_count_ - 1) {
-            inverse_row_index--;
-            CHECK_GE(inverse_row_index, 0);
-        }
-
-        auto& cell_ref = row_ptrs[inverse_row_index]->cells_[cell_id_in_row];
-        MVCCList<EdgeMVCCItem>* mvcc_list = cell_ref.mvcc_list;
-
-        // move a non-empty cell to an empty cell
-        if (mvcc_list->GetHead() != nullptr) {
-            num_movable_cell--;
-            pair<int, int> empty_cell = empty_cell_queue.front();
-            empty_cell_queue.pop();
 
-            row_ptrs[empty_cell.first]->cells_[empty_cell.second] = cell_ref;
+        int new_cell_id_in_row = new_edge_count % VE_ROW_CELL_COUNT;
+        if (new_cell_id_in_row == 0) {
+            auto* new_row = mem_pool_->Get(tid);
+            new_row->next_ = nullptr;
+            if (new_head == nullptr) {
+                new_head = new_tail = new_row;
+            } else {
+                new_tail->next_ = new_row;
+                new_tail = new_row;
+            }
         }
 
-        if (empty_cell_queue.size() == 0 || num_movable_cell == 0) { break; }
-
-        inverse_cell_index--;
-        if (inverse_cell_index < 0) { break; }
+        new_tail->cells_[new_cell_id_in_row] = cell_ref;
+        new_edge_count++;
     }
 
-    // Recycle removable row
-    for (int i = row_count - 1; i > cur_row_count - 1; i--) {
-        if (i - 1 >= 0) { row_ptrs[i-1]->next_ = nullptr; }
-        mem_pool_->Free(row_ptrs[i], TidPoolManager::GetInstance()->GetTid(TID_TYPE::CONTAINER));
+    if (new_edge_count == old_edge_count) {
+        // Nothing to defrag, the new rows are not published yet
+        while (new_head != nullptr) {
+            VertexEdgeRow* next_row = new_head->next_;
+            mem_pool_->Free(new_head, tid);
+            new_head = next_row;
+        }
+        return;
     }
 
-    // new edge count
-    edge_count_ = cur_edge_count;
-    if (cur_row_count == 0) {
-        head_ = nullptr;
-        tail_ = nullptr;
-    } else {
-        tail_ = row_ptrs[cur_row_count - 1];
+    VertexEdgeRow* old_head = head_;
+    {
+        SeqLock::WriteScope write_scope(layout_seq_);
+        head_ = new_head;
+        tail_ = new_tail;
+        edge_count_ = new_edge_count;
     }
 
-    delete[] row_ptrs;
+    RetireRows(old_head, old_edge_count);
 }
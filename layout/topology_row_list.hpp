@@ -18,6 +18,7 @@
 
 #include "layout/mvcc_list.hpp"
 #include "tbb/atomic.h"
+#include "utils/seq_lock.hpp"
 #include "utils/tid_pool_manager.hpp"
 
 class GCProducer;
@@ -33,14 +34,21 @@ class TopologyRowList {
     tbb::atomic<VertexEdgeRow*> head_, tail_;
     vid_t my_vid_;
 
-    void AllocateCell(const bool& is_out, const vid_t& conn_vtx_id, MVCCList<EdgeMVCCItem>* mvcc_list);
+    void AllocateCell(const bool& is_out, const vid_t& conn_vtx_id, const label_t& label,
+                      MVCCList<EdgeMVCCItem>* mvcc_list);
 
     // this lock is only used in AllocateCell. Traversal in the row list is thread-safe
     pthread_spinlock_t lock_;
 
-    // This lock is only used to avoid conflict between gc operation (including delete all and defrag) and all other operations:
-    // write_lock -> gc; read_lock -> others
+    // This lock is only used to avoid conflict between gc operation (including delete all and defrag) and other operations
+    // modifying the row list: write_lock -> gc; read_lock -> others.
+    // Readers (ReadConnectedVertex/Edge) do not take it. They hold an EpochGuard, and take a snapshot of
+    // head_ and edge_count_ under layout_seq_, which is changed when gc replaces the rows.
     WritePriorRWLock gc_rwlock_;
+    SeqLock layout_seq_;
+
+    // Free rows after all readers which may refer to them have left, see EpochManager
+    static void RetireRows(VertexEdgeRow* head, const int& edge_count);
 
  public:
     void Init(const vid_t& my_vid);
@@ -67,6 +75,9 @@ class TopologyRowList {
                                            PropertyRowList<EdgePropertyRow>* ep_row_list_ptr,
                                            const uint64_t& trx_id, const uint64_t& begin_time);
 
+    // Mark the cell as LABEL_MIXED if an existing edge is re-added with another label
+    void ProcessRelabelEdge(const bool& is_out, const vid_t& conn_vtx_id, const label_t& edge_label);
+
     static void SetGlobalMemoryPool(ConcurrentMemPool<VertexEdgeRow>* mem_pool) {
         mem_pool_ = mem_pool;
     }
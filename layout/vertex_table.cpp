@@ -0,0 +1,76 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "layout/vertex_table.hpp"
+
+#include "glog/logging.h"
+#include "layout/epoch_manager.hpp"
+
+VertexTable::VertexTable() : worker_size_(1), worker_rank_(0), segment_capacity_(0), segments_(nullptr) {
+    segment_count_ = 0;
+}
+
+VertexTable::~VertexTable() {
+    for (uint32_t i = 0; i < segment_capacity_; i++)
+        delete segments_[i].load();
+    delete[] segments_;
+}
+
+void VertexTable::Init(int worker_size, int worker_rank) {
+    CHECK(segments_ == nullptr);
+    CHECK_GT(worker_size, 0);
+    worker_size_ = worker_size;
+    worker_rank_ = worker_rank;
+
+    uint32_t slot_capacity = ((1u << VID_BITS) + worker_size_ - 1) / worker_size_;
+    segment_capacity_ = (slot_capacity + SEGMENT_SIZE - 1) >> SEGMENT_BITS;
+    segments_ = new std::atomic<Segment*>[segment_capacity_];
+    for (uint32_t i = 0; i < segment_capacity_; i++)
+        segments_[i] = nullptr;
+}
+
+Vertex* VertexTable::Insert(const vid_t& vid) {
+    CHECK_EQ(vid.value() % worker_size_, worker_rank_) << "Vid " << vid.value() << " is not placed on this worker";
+    uint32_t slot = GetSlot(vid);
+    CHECK_LT(slot >> SEGMENT_BITS, segment_capacity_);
+    std::atomic<Segment*>& segment_ref = segments_[slot >> SEGMENT_BITS];
+    Segment* segment = segment_ref.load(std::memory_order_acquire);
+
+    if (segment == nullptr) {
+        // Concurrent inserters may allocate the same segment, only one of them will succeed
+        Segment* new_segment = new Segment;
+        if (segment_ref.compare_exchange_strong(segment, new_segment, std::memory_order_acq_rel)) {
+            segment = new_segment;
+            segment_count_++;
+        } else {
+            delete new_segment;
+        }
+    }
+
+    Vertex* vertex = &segment->slots[slot & (SEGMENT_SIZE - 1)];
+    CHECK(vertex->mvcc_list == nullptr) << "Vid " << vid.value() << " already exist in VertexTable";
+    return vertex;
+}
+
+void VertexTable::Erase(const vid_t& vid) {
+    Vertex* vertex = Find(vid);
+    CHECK(vertex != nullptr);
+
+    MVCCList<VertexMVCCItem>* mvcc_list = vertex->mvcc_list;
+    vertex->mvcc_list = nullptr;
+    vertex->ve_row_list = nullptr;
+    vertex->vp_row_list = nullptr;
+
+    EpochManager::GetInstance()->Retire([mvcc_list]() { delete mvcc_list; });
+}
@@ -0,0 +1,118 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+
+#include "base/type.hpp"
+#include "layout/layout_type.hpp"
+
+/* VertexTable is the vertex directory of DataStorage, replacing tbb::concurrent_unordered_map<uint32_t, Vertex>.
+ *
+ * It is a segmented array indexed by the local slot of vid, i.e., vid / worker_size, since SimpleIdMapper
+ * places vid on worker vid % worker_size, and AssignVID hands out vids of the form local_vid * worker_size + worker_rank.
+ * Thus each worker only allocates slots for its own vertices.
+ * Segments are allocated on demand and never moved or freed until destruction, thus a lookup is
+ * two dependent loads (segment pointer, then the slot) without any lock, and a Vertex* is valid as long as the table exists.
+ *
+ * A slot is occupied iff its mvcc_list != nullptr. The inserter fills the other fields of the Vertex
+ * before setting mvcc_list, so readers will never see a partially initialized vertex.
+ *
+ * Erase is only called by GCConsumer, on vertices that are invisible to all running transactions.
+ * The detached MVCCList<VertexMVCCItem> is not freed immediately, since a reader may have loaded
+ * the pointer before the erasure; it is retired to EpochManager, thus readers should hold an EpochGuard.
+ */
+class VertexTable {
+ public:
+    static constexpr int SEGMENT_BITS = 12;
+    static constexpr uint32_t SEGMENT_SIZE = 1u << SEGMENT_BITS;
+
+    VertexTable();
+    ~VertexTable();
+
+    // Should be called before any other function
+    void Init(int worker_size, int worker_rank);
+
+    // Return the slot of vid, allocating its segment if needed.
+    // CHECK fails if vid already exists, since vids are never reused.
+    Vertex* Insert(const vid_t& vid);
+
+    // Return nullptr if vid does not exist
+    Vertex* Find(const vid_t& vid) const {
+        uint32_t slot = GetSlot(vid);
+        Segment* segment = segments_[slot >> SEGMENT_BITS].load(std::memory_order_acquire);
+        if (segment == nullptr)
+            return nullptr;
+
+        Vertex* vertex = &segment->slots[slot & (SEGMENT_SIZE - 1)];
+        if (vertex->mvcc_list == nullptr)
+            return nullptr;
+        return vertex;
+    }
+
+    // Prefetch the slot of vid, used by batched reads in DataStorage
+    void Prefetch(const vid_t& vid) const {
+        uint32_t slot = GetSlot(vid);
+        Segment* segment = segments_[slot >> SEGMENT_BITS].load(std::memory_order_relaxed);
+        if (segment != nullptr)
+            __builtin_prefetch(&segment->slots[slot & (SEGMENT_SIZE - 1)]);
+    }
+
+    // Detach the vertex from the table. Row lists should have been freed by other GC tasks.
+    void Erase(const vid_t& vid);
+
+    // The segment that vid belongs to, used to partition vids among threads in the same way as ForEach
+    uint32_t GetSegmentId(const vid_t& vid) const { return GetSlot(vid) >> SEGMENT_BITS; }
+
+    // Call func(vid_t, Vertex&) for each occupied slot
+    template <class Func>
+    void ForEach(Func func) const {
+        ForEach(func, 0, 1);
+    }
+
+    // Only visit segments with seg_id % stride == offset, so that the table can be partitioned among threads
+    template <class Func>
+    void ForEach(Func func, uint32_t offset, uint32_t stride) const {
+        for (uint32_t seg_id = offset; seg_id < segment_capacity_; seg_id += stride) {
+            Segment* segment = segments_[seg_id].load(std::memory_order_acquire);
+            if (segment == nullptr)
+                continue;
+
+            for (uint32_t i = 0; i < SEGMENT_SIZE; i++) {
+                Vertex& vertex = segment->slots[i];
+                if (vertex.mvcc_list == nullptr)
+                    continue;
+                func(vid_t((((seg_id << SEGMENT_BITS) | i) * worker_size_) + worker_rank_), vertex);
+            }
+        }
+    }
+
+    size_t GetSegmentCount() const { return segment_count_; }
+
+ private:
+    struct Segment {
+        Vertex slots[SEGMENT_SIZE];
+    };
+
+    uint32_t GetSlot(const vid_t& vid) const { return vid.value() / worker_size_; }
+
+    uint32_t worker_size_;
+    uint32_t worker_rank_;
+
+    // Enough for all local slots of 2^VID_BITS vids
+    uint32_t segment_capacity_;
+    std::atomic<Segment*>* segments_;
+    std::atomic<size_t> segment_count_;
+};
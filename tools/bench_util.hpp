@@ -0,0 +1,112 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Helpers shared by the micro-benchmarks in tools/.
+ * A benchmark takes optional positional integer arguments, and prints one line per configuration.
+ */
+class BenchUtil {
+ public:
+    // argv[i] as an integer, or default_value if there are not enough arguments
+    static uint64_t GetArg(int argc, char* argv[], int i, uint64_t default_value) {
+        return (i < argc) ? strtoull(argv[i], nullptr, 10) : default_value;
+    }
+
+    static uint64_t GetNsec() {
+        struct timespec tp;
+        clock_gettime(CLOCK_MONOTONIC, &tp);
+        return tp.tv_sec * 1000000000ul + tp.tv_nsec;
+    }
+
+    // User and system CPU time of the whole process in usec
+    static uint64_t GetProcessCpuUsec() {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_utime.tv_sec * 1000000ul + usage.ru_utime.tv_usec +
+               usage.ru_stime.tv_sec * 1000000ul + usage.ru_stime.tv_usec;
+    }
+
+    // p in [0, 1]. samples will be sorted
+    static uint64_t Percentile(std::vector<uint64_t>& samples, double p) {
+        if (samples.empty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+        return samples[index];
+    }
+
+    // Bind the calling thread to the cpus of node, listed in /sys/devices/system/node/node<node>/cpulist.
+    // Return false if the list is unavailable.
+    static bool BindToNode(int node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string cpu_list;
+        if (!(file >> cpu_list))
+            return false;
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        // Format: 0-15,32-47
+        std::stringstream ss(cpu_list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            size_t dash = range.find('-');
+            int first = atoi(range.c_str());
+            int last = (dash == std::string::npos) ? first : atoi(range.c_str() + dash + 1);
+            for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+                CPU_SET(cpu, &cpu_set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+
+    // Keep value alive, so that the compiler cannot drop the loop computing it
+    template <class T>
+    static void DoNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // xorshift64*, cheap enough for inner loops
+    class Random {
+     public:
+        explicit Random(uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ul + 1) {}
+
+        uint64_t Next() {
+            state_ ^= state_ >> 12;
+            state_ ^= state_ << 25;
+            state_ ^= state_ >> 27;
+            return state_ * 0x2545F4914F6CDD1Dul;
+        }
+
+        // Uniform in [0, 1)
+        double NextDouble() {
+            return (Next() >> 11) * (1.0 / (1ul << 53));
+        }
+
+     private:
+        uint64_t state_;
+    };
+};
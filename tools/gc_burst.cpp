@@ -0,0 +1,163 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Timing driver of GC reclaim latency, run as a client of a running cluster.
+ *
+ * 1. Read the MVCC usage, i.e., the sum of "[VP mvcc]" and "[EP mvcc]" usage in DisplayStatus(mem) over all nodes.
+ * 2. Commit burst_count update queries, with "$I" in update_query replaced by 0, 1, ..., burst_count - 1.
+ * 3. Poll the MVCC usage every poll_ms, until the growth caused by the burst falls below 5%.
+ * The time from the end of the burst to the last poll is the reclaim latency.
+ * Compare SYSTEM:NUM_GC_PRODUCER settings by restarting the servers with each of them.
+ *
+ * The client protocol is the one of driver/client.cpp. It binds the same ports, so do not run it with a client.
+ *
+ * Usage: gc_burst <config_file> <update_query> [burst_count = 1000000] [poll_ms = 100] [timeout_s = 300]
+ * Example: gc_burst machine.cfg 'g.V().has("id","$I").property("age","$I")'
+ */
+
+#include <limits.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/client_connection.hpp"
+#include "base/node.hpp"
+#include "base/node_util.hpp"
+#include "base/serialization.hpp"
+#include "base/type.hpp"
+#include "glog/logging.h"
+#include "tools/bench_util.hpp"
+#include "utils/global.hpp"
+#include "utils/tool.hpp"
+
+class GCBurstClient {
+ public:
+    explicit GCBurstClient(const string& cfg_fname) : id_(-1), handler_(-1) {
+        vector<Node> nodes = ParseFile(cfg_fname);
+        CHECK(CheckUniquePort(nodes));
+        cc_.Init(nodes);
+
+        char hostname[HOST_NAME_MAX];
+        gethostname(hostname, HOST_NAME_MAX);
+        host_str_ = hostname;
+    }
+
+    // Same as Client::RequestWorker() and Client::CommitQuery()
+    vector<value_t> RunQuery(const string& query) {
+        ibinstream m;
+        obinstream um;
+        m << id_;
+        cc_.Send(MASTER_RANK, m);
+        cc_.Recv(MASTER_RANK, um);
+        um >> id_;
+        um >> handler_;
+
+        ibinstream query_m;
+        obinstream query_um;
+        query_m << host_str_;
+        query_m << query;
+        cc_.Send(handler_, query_m);
+        cc_.Recv(handler_, query_um);
+
+        string hname;
+        vector<value_t> values;
+        uint64_t time;
+        query_um >> hname;
+        query_um >> values;
+        query_um >> time;
+        return values;
+    }
+
+    // Sum of [VP mvcc] and [EP mvcc] usage over all nodes
+    uint64_t GetMVCCUsage() {
+        uint64_t usage = 0;
+        for (auto& value : RunQuery("DisplayStatus(mem)")) {
+            string status = Tool::value_t2string(value);
+            for (const char* key : {"[VP mvcc]: usage: ", "[EP mvcc]: usage: "}) {
+                size_t pos = status.find(key);
+                CHECK(pos != string::npos) << "Unexpected DisplayStatus(mem) output: " << status;
+                usage += stoull(status.substr(pos + strlen(key)));
+            }
+        }
+        return usage;
+    }
+
+ private:
+    ClientConnection cc_;
+    int id_;
+    int handler_;
+    string host_str_;
+};
+
+static string ReplaceAll(string str, const string& from, const string& to) {
+    for (size_t pos = str.find(from); pos != string::npos; pos = str.find(from, pos + to.size()))
+        str.replace(pos, from.size(), to);
+    return str;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "Usage: gc_burst <config_file> <update_query> [burst_count] [poll_ms] [timeout_s]" << endl;
+        return 0;
+    }
+
+    google::InitGoogleLogging(argv[0]);
+    string cfg_fname = argv[1];
+    string update_query = argv[2];
+    uint64_t burst_count = BenchUtil::GetArg(argc, argv, 3, 1000000);
+    uint64_t poll_ms = BenchUtil::GetArg(argc, argv, 4, 100);
+    uint64_t timeout_s = BenchUtil::GetArg(argc, argv, 5, 300);
+
+    GCBurstClient client(cfg_fname);
+    uint64_t base_usage = client.GetMVCCUsage();
+    cout << "MVCC usage before burst: " << base_usage << endl;
+
+    uint64_t burst_start = BenchUtil::GetNsec();
+    for (uint64_t i = 0; i < burst_count; i++)
+        client.RunQuery(ReplaceAll(update_query, "$I", to_string(i)));
+    uint64_t burst_end = BenchUtil::GetNsec();
+
+    uint64_t peak_usage = client.GetMVCCUsage();
+    uint64_t growth = (peak_usage > base_usage) ? peak_usage - base_usage : 0;
+    cout << "Burst of " << burst_count << " queries: " << (burst_end - burst_start) / 1000000 << " ms, MVCC usage: "
+         << peak_usage << " (+" << growth << ")" << endl;
+    if (growth == 0) {
+        cout << "The burst did not grow the MVCC usage, check update_query" << endl;
+        return 0;
+    }
+
+    // Poll until at most 5% of the growth is left
+    uint64_t threshold = base_usage + growth / 20;
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+        uint64_t usage = client.GetMVCCUsage();
+        uint64_t elapsed_ms = (BenchUtil::GetNsec() - burst_end) / 1000000;
+        cout << "+" << elapsed_ms << " ms: MVCC usage " << usage << endl;
+
+        if (usage <= threshold) {
+            cout << "Reclaim latency: " << elapsed_ms << " ms" << endl;
+            break;
+        }
+        if (elapsed_ms > timeout_s * 1000) {
+            cout << "Not reclaimed in " << timeout_s << " s" << endl;
+            break;
+        }
+    }
+    return 0;
+}
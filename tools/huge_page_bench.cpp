@@ -0,0 +1,151 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Micro-benchmark of HugePageUtil on one large region.
+ *
+ * The region is set up in three ways:
+ *  new + memset:      the allocation used before HugePageUtil;
+ *  Map, 4KB pages:    HugePageUtil::Map(huge_page = false) + ParallelTouch;
+ *  Map, huge pages:   HugePageUtil::Map(huge_page = true) + ParallelTouch.
+ * For each, it prints the setup time, and the time and dTLB load misses per random 8-byte read.
+ * dTLB misses are read by perf_event_open, and printed as n/a if the counter is unavailable
+ * (e.g., kernel.perf_event_paranoid or a VM without PMU).
+ * The transparent huge pages of the process are printed as well, since THP could be disabled or fail to be allocated.
+ *
+ * Usage: huge_page_bench [size_mb = 1024] [read_count = 20000000] [touch_threads = 4]
+ */
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "glog/logging.h"
+#include "tools/bench_util.hpp"
+#include "utils/huge_page_util.hpp"
+
+// A dTLB load miss counter of the calling thread, disabled if perf_event_open fails
+class DtlbMissCounter {
+ public:
+    DtlbMissCounter() {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~DtlbMissCounter() {
+        if (fd_ >= 0)
+            close(fd_);
+    }
+
+    bool Available() const { return fd_ >= 0; }
+
+    void Start() {
+        if (fd_ < 0)
+            return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    uint64_t Stop() {
+        uint64_t count = 0;
+        if (fd_ < 0)
+            return count;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != sizeof(count))
+            count = 0;
+        return count;
+    }
+
+ private:
+    int fd_;
+};
+
+// AnonHugePages of the process in MB, or -1 if /proc/self/smaps_rollup is unavailable
+static int64_t GetAnonHugePageMB() {
+    std::ifstream file("/proc/self/smaps_rollup");
+    std::string key;
+    int64_t kb;
+    while (file >> key) {
+        if (key == "AnonHugePages:" && file >> kb)
+            return kb >> 10;
+    }
+    return -1;
+}
+
+static void RandomRead(const std::string& name, const uint64_t* data, size_t word_count, uint64_t read_count,
+                       double setup_ms, DtlbMissCounter& counter) {
+    BenchUtil::Random random(2020);
+    uint64_t checksum = 0;
+
+    counter.Start();
+    uint64_t start = BenchUtil::GetNsec();
+    for (uint64_t i = 0; i < read_count; i++)
+        checksum += data[random.Next() % word_count];
+    uint64_t end = BenchUtil::GetNsec();
+    uint64_t misses = counter.Stop();
+
+    BenchUtil::DoNotOptimize(checksum);
+    std::cout << name << ": setup " << setup_ms << " ms, " << (end - start) * 1.0 / read_count
+              << " ns/read, THP: " << GetAnonHugePageMB() << " MB, dTLB misses/read: ";
+    if (counter.Available())
+        std::cout << misses * 1.0 / read_count << std::endl;
+    else
+        std::cout << "n/a" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t size = BenchUtil::GetArg(argc, argv, 1, 1024) << 20;
+    uint64_t read_count = BenchUtil::GetArg(argc, argv, 2, 20000000);
+    int touch_threads = BenchUtil::GetArg(argc, argv, 3, 4);
+    size_t word_count = size / sizeof(uint64_t);
+
+    DtlbMissCounter counter;
+    std::cout << "size: " << (size >> 20) << " MB, reads: " << read_count << ", touch threads: " << touch_threads
+              << ", dTLB counter: " << (counter.Available() ? "yes" : "unavailable") << std::endl;
+
+    {
+        uint64_t start = BenchUtil::GetNsec();
+        char* data = new char[size];
+        memset(data, 0, size);
+        double setup_ms = (BenchUtil::GetNsec() - start) / 1e6;
+        RandomRead("new + memset", reinterpret_cast<uint64_t*>(data), word_count, read_count, setup_ms, counter);
+        delete[] data;
+    }
+
+    for (bool huge_page : {false, true}) {
+        uint64_t start = BenchUtil::GetNsec();
+        size_t len = size;
+        char* data = static_cast<char*>(HugePageUtil::Map(len, huge_page));
+        CHECK(data != nullptr) << "mmap of " << len << " bytes failed";
+        HugePageUtil::ParallelTouch(data, len, touch_threads);
+        double setup_ms = (BenchUtil::GetNsec() - start) / 1e6;
+        RandomRead(huge_page ? "Map, huge pages" : "Map, 4KB pages", reinterpret_cast<uint64_t*>(data), word_count,
+                   read_count, setup_ms, counter);
+        HugePageUtil::Unmap(data, len);
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Micro-benchmark of version search in long MVCCLists.
+ *
+ * list_count lists of MVCCList<VertexMVCCItem> get depth committed versions each.
+ * The versions of all lists are appended round by round, so that the versions of one list are spread in memory
+ * as they are after a long run of updates. Random lists are then read at the latest, middle and oldest snapshots by
+ *  GetVisibleVersion: searches from the head or the newest committed version, whichever is closer in time;
+ *  head walk:         GetHead() and GetNext() until the visible version, i.e., the pointer chasing
+ *                     of the search from the oldest version (the time checks of each step are not counted).
+ *
+ * Usage: mvcc_chain_bench [list_count = 65536] [depth = 16] [query_count = 1000000]
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "layout/concurrent_mem_pool.hpp"
+#include "layout/mvcc_definition.hpp"
+#include "layout/mvcc_list.hpp"
+#include "tools/bench_util.hpp"
+#include "utils/config.hpp"
+#include "utils/tid_pool_manager.hpp"
+
+typedef MVCCList<VertexMVCCItem> VertexMVCCList;
+
+static const uint64_t READER_TRX_ID = TRX_ID_MASK | 1;
+
+// Version i (i >= 1) of every list is committed at CommitTime(i), version 0 is the initial one
+static uint64_t CommitTime(int i) {
+    return 2 * i + 1;
+}
+
+// Return ns per read
+static double RunGetVisibleVersion(const vector<VertexMVCCList*>& lists, const vector<uint32_t>& queries,
+                                   const uint64_t& begin_time) {
+    uint64_t checksum = 0;
+    uint64_t start = BenchUtil::GetNsec();
+    for (uint32_t list_id : queries) {
+        bool ret = false;
+        lists[list_id]->GetVisibleVersion(READER_TRX_ID, begin_time, false, ret);
+        checksum += ret;
+    }
+    uint64_t end = BenchUtil::GetNsec();
+
+    BenchUtil::DoNotOptimize(checksum);
+    return (end - start) * 1.0 / queries.size();
+}
+
+// Return ns per read
+static double RunHeadWalk(const vector<VertexMVCCList*>& lists, const vector<uint32_t>& queries, const int& steps) {
+    uint64_t checksum = 0;
+    uint64_t start = BenchUtil::GetNsec();
+    for (uint32_t list_id : queries) {
+        VertexMVCCItem* version = lists[list_id]->GetHead();
+        for (int i = 0; i < steps; i++)
+            version = static_cast<VertexMVCCItem*>(version->GetNext());
+        checksum += version->GetValue();
+    }
+    uint64_t end = BenchUtil::GetNsec();
+
+    BenchUtil::DoNotOptimize(checksum);
+    return (end - start) * 1.0 / queries.size();
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t list_count = BenchUtil::GetArg(argc, argv, 1, 1 << 16);
+    int depth = BenchUtil::GetArg(argc, argv, 2, 16);
+    uint64_t query_count = BenchUtil::GetArg(argc, argv, 3, 1000000);
+    CHECK(depth >= 1);
+
+    Config* config = Config::GetInstance();
+    config->isolation_level = ISOLATION_LEVEL::SNAPSHOT;
+    config->global_enable_opt_preread = false;
+    TidPoolManager::GetInstance()->Register(TID_TYPE::CONTAINER);
+
+    auto* mvcc_pool = ConcurrentMemPool<VertexMVCCItem>::GetInstance(nullptr, list_count * depth + (1 << 20), 1, false);
+    VertexMVCCList::SetGlobalMemoryPool(mvcc_pool);
+
+    vector<VertexMVCCList*> lists(list_count);
+    for (auto& mvcc_list : lists) {
+        mvcc_list = new VertexMVCCList;
+        mvcc_list->AppendInitialVersion()[0] = true;
+    }
+    for (int i = 1; i < depth; i++) {
+        uint64_t trx_id = TRX_ID_MASK | (i + 1);
+        for (auto& mvcc_list : lists) {
+            mvcc_list->AppendVersion(trx_id, CommitTime(i) - 1)[0] = true;
+            mvcc_list->CommitVersion(trx_id, CommitTime(i));
+        }
+    }
+
+    BenchUtil::Random random(2020);
+    vector<uint32_t> queries(query_count);
+    for (auto& list_id : queries)
+        list_id = random.Next() % list_count;
+
+    cout << "lists: " << list_count << ", depth: " << depth << ", queries: " << query_count << endl;
+
+    // <name, index of the visible version>
+    vector<pair<string, int>> snapshots = {{"latest", depth - 1}, {"middle", depth / 2}, {"oldest", 0}};
+    RunHeadWalk(lists, queries, depth - 1);  // warm up
+    for (auto& snapshot : snapshots) {
+        int version_id = snapshot.second;
+        // Inside [begin_time, end_time) of version version_id
+        uint64_t begin_time = (version_id == 0) ? 1 : CommitTime(version_id);
+        double search_ns = RunGetVisibleVersion(lists, queries, begin_time);
+        double walk_ns = RunHeadWalk(lists, queries, version_id);
+        cout << snapshot.first << " (version " << version_id << "): GetVisibleVersion " << search_ns
+             << " ns, head walk " << walk_ns << " ns" << endl;
+    }
+    return 0;
+}
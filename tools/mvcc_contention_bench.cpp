@@ -0,0 +1,152 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Micro-benchmark of MVCCList::GetVisibleVersion on one hot list under a concurrent writer.
+ *
+ * reader_count threads read the latest committed version of one MVCCList<VertexMVCCItem>,
+ * while one writer appends and commits a new version every writer_gap_ns.
+ * Each configuration is run twice:
+ *  read_only = true:  ReadOnlyGetVisibleVersion (seqlock, readers do not take lock_);
+ *  read_only = false: SnapshotLevelGetVisibleVersion (every reader takes lock_).
+ * One in every SAMPLE_INTERVAL reads is timed for the latency percentiles.
+ *
+ * Usage: mvcc_contention_bench [reader_count = 4] [writer_gap_ns = 1000] [duration_ms = 2000]
+ *        writer_gap_ns = 0 means that the writer never waits between versions.
+ */
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "layout/concurrent_mem_pool.hpp"
+#include "layout/mvcc_definition.hpp"
+#include "layout/mvcc_list.hpp"
+#include "tools/bench_util.hpp"
+#include "utils/config.hpp"
+#include "utils/tid_pool_manager.hpp"
+
+typedef MVCCList<VertexMVCCItem> VertexMVCCList;
+
+static const int SAMPLE_INTERVAL = 16;
+static const uint64_t READER_TRX_ID = TRX_ID_MASK | 1;
+
+struct RunResult {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    vector<uint64_t> latency_samples;
+};
+
+static RunResult Run(VertexMVCCList* mvcc_list, bool read_only, int reader_count,
+                     uint64_t writer_gap_ns, uint64_t duration_ms, uint64_t max_writes) {
+    std::atomic<bool> stop(false);
+    // Commit time of the latest version, read by the readers as their begin_time
+    std::atomic<uint64_t> latest_time(1);
+    // Timestamps keep growing across runs, since the versions of the previous run stay in the list
+    static uint64_t next_time = 2;
+
+    RunResult result;
+    vector<RunResult> reader_results(reader_count);
+
+    std::thread writer([&]() {
+        // Each run has a new writer thread, all of them use the pool as tid 1
+        TidPoolManager::GetInstance()->Register(TID_TYPE::CONTAINER, 1);
+        uint64_t next_write = BenchUtil::GetNsec();
+        while (!stop.load(std::memory_order_relaxed) && result.writes < max_writes) {
+            if (writer_gap_ns > 0) {
+                while (BenchUtil::GetNsec() < next_write) {}
+                next_write += writer_gap_ns;
+            }
+
+            uint64_t trx_id = TRX_ID_MASK | (next_time + 1);
+            bool* val = mvcc_list->AppendVersion(trx_id, next_time);
+            CHECK(val != nullptr);
+            *val = true;
+            mvcc_list->CommitVersion(trx_id, next_time + 1);
+            latest_time.store(next_time + 1, std::memory_order_relaxed);
+            next_time += 2;
+            result.writes++;
+        }
+    });
+
+    vector<std::thread> readers;
+    for (int i = 0; i < reader_count; i++) {
+        readers.emplace_back([&, i]() {
+            RunResult& reader_result = reader_results[i];
+            bool ret;
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint64_t begin_time = latest_time.load(std::memory_order_relaxed);
+                if (reader_result.reads % SAMPLE_INTERVAL == 0) {
+                    uint64_t start = BenchUtil::GetNsec();
+                    mvcc_list->GetVisibleVersion(READER_TRX_ID, begin_time, read_only, ret);
+                    reader_result.latency_samples.push_back(BenchUtil::GetNsec() - start);
+                } else {
+                    mvcc_list->GetVisibleVersion(READER_TRX_ID, begin_time, read_only, ret);
+                }
+                BenchUtil::DoNotOptimize(ret);
+                reader_result.reads++;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    stop = true;
+    writer.join();
+    for (auto& reader : readers)
+        reader.join();
+
+    for (auto& reader_result : reader_results) {
+        result.reads += reader_result.reads;
+        result.latency_samples.insert(result.latency_samples.end(),
+                                      reader_result.latency_samples.begin(), reader_result.latency_samples.end());
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int reader_count = BenchUtil::GetArg(argc, argv, 1, 4);
+    uint64_t writer_gap_ns = BenchUtil::GetArg(argc, argv, 2, 1000);
+    uint64_t duration_ms = BenchUtil::GetArg(argc, argv, 3, 2000);
+
+    Config* config = Config::GetInstance();
+    config->isolation_level = ISOLATION_LEVEL::SNAPSHOT;
+    config->global_enable_opt_preread = false;
+    TidPoolManager::GetInstance()->Register(TID_TYPE::CONTAINER);
+
+    // The versions are never collected, so the writer stops when the pool is used up
+    const uint64_t POOL_SIZE = 1 << 23;
+    auto* mvcc_pool = ConcurrentMemPool<VertexMVCCItem>::GetInstance(nullptr, POOL_SIZE, 2, false);
+    VertexMVCCList::SetGlobalMemoryPool(mvcc_pool);
+
+    VertexMVCCList* mvcc_list = new VertexMVCCList;
+    mvcc_list->AppendInitialVersion()[0] = true;
+
+    cout << "readers: " << reader_count << ", writer gap: " << writer_gap_ns << " ns, duration: "
+         << duration_ms << " ms, hardware threads: " << std::thread::hardware_concurrency() << endl;
+
+    // Both runs share the pool, leave half of it to each
+    uint64_t max_writes = POOL_SIZE / 2 - 1024;
+    for (bool read_only : {true, false}) {
+        RunResult result = Run(mvcc_list, read_only, reader_count, writer_gap_ns, duration_ms, max_writes);
+        double seconds = duration_ms / 1000.0;
+        uint64_t p50 = BenchUtil::Percentile(result.latency_samples, 0.5);
+        uint64_t p99 = BenchUtil::Percentile(result.latency_samples, 0.99);
+        uint64_t p999 = BenchUtil::Percentile(result.latency_samples, 0.999);
+        cout << (read_only ? "seqlock  (read_only = true):  " : "spinlock (read_only = false): ")
+             << result.reads / seconds / 1e6 << " M reads/s, "
+             << result.writes / seconds / 1e6 << " M writes/s, latency p50 / p99 / p999: "
+             << p50 << " / " << p99 << " / " << p999 << " ns" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Micro-benchmark of node-local allocation in a NUMA-aware ConcurrentMemPool.
+ *
+ * threads_per_node threads are bound to each node. Each thread gets cells_per_thread cells from the pool,
+ * links them into one random cycle, and then chases the cycle, so that every step is a dependent cache miss.
+ *  node-local:  SetNode(tid, node of the thread) once, as expert threads do;
+ *  interleaved: SetNode(tid, i % node_count) before the i-th Get(), i.e., cells spread over all nodes,
+ *               as they are without NUMA-aware placement.
+ * On a machine with a single node, SetNode() has no effect and both modes are the same.
+ *
+ * Usage: numa_pool_bench [threads_per_node = 1] [cells_per_thread = 1048576] [steps = 4194304]
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "layout/concurrent_mem_pool.hpp"
+#include "tools/bench_util.hpp"
+#include "utils/numa_util.hpp"
+
+// One cache line. Each mode has its own type, since ConcurrentMemPool has one instance per type
+template <int MODE>
+struct BenchCell {
+    BenchCell* next;
+    char padding[56];
+};
+
+enum BenchMode { NODE_LOCAL = 0, INTERLEAVED = 1 };
+
+// Return ns per step, averaged over the threads
+template <int MODE>
+static double Run(int node_count, int threads_per_node, uint64_t cells_per_thread, uint64_t steps) {
+    typedef BenchCell<MODE> Cell;
+    int thread_count = node_count * threads_per_node;
+    auto* pool = ConcurrentMemPool<Cell>::GetInstance(nullptr, cells_per_thread * thread_count + (1 << 20),
+                                                      thread_count, false, true);
+
+    std::vector<double> step_ns(thread_count);
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < thread_count; tid++) {
+        threads.emplace_back([&, tid]() {
+            int node = tid % node_count;
+            BenchUtil::BindToNode(node);
+            if (MODE == NODE_LOCAL)
+                pool->SetNode(tid, node);
+
+            std::vector<Cell*> cells(cells_per_thread);
+            for (uint64_t i = 0; i < cells_per_thread; i++) {
+                if (MODE == INTERLEAVED)
+                    pool->SetNode(tid, i % node_count);
+                cells[i] = pool->Get(tid);
+            }
+
+            std::shuffle(cells.begin(), cells.end(), std::mt19937_64(tid));
+            for (uint64_t i = 0; i < cells_per_thread; i++)
+                cells[i]->next = cells[(i + 1) % cells_per_thread];
+
+            Cell* cell = cells[0];
+            uint64_t start = BenchUtil::GetNsec();
+            for (uint64_t i = 0; i < steps; i++)
+                cell = cell->next;
+            uint64_t end = BenchUtil::GetNsec();
+
+            BenchUtil::DoNotOptimize(cell);
+            step_ns[tid] = (end - start) * 1.0 / steps;
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    return std::accumulate(step_ns.begin(), step_ns.end(), 0.0) / thread_count;
+}
+
+int main(int argc, char* argv[]) {
+    int threads_per_node = BenchUtil::GetArg(argc, argv, 1, 1);
+    uint64_t cells_per_thread = BenchUtil::GetArg(argc, argv, 2, 1 << 20);
+    uint64_t steps = BenchUtil::GetArg(argc, argv, 3, 1 << 22);
+
+    int node_count = NumaUtil::GetNodeCount();
+    std::cout << "nodes: " << node_count << ", threads per node: " << threads_per_node
+         << ", cells per thread: " << cells_per_thread << ", steps: " << steps << std::endl;
+    if (node_count == 1)
+        std::cout << "single node: SetNode() has no effect, both modes allocate from the same arena" << std::endl;
+
+    double local_ns = Run<NODE_LOCAL>(node_count, threads_per_node, cells_per_thread, steps);
+    double interleaved_ns = Run<INTERLEAVED>(node_count, threads_per_node, cells_per_thread, steps);
+    std::cout << "node-local: " << local_ns << " ns/read" << std::endl;
+    std::cout << "interleaved: " << interleaved_ns << " ns/read" << std::endl;
+    std::cout << "speedup: " << interleaved_ns / local_ns << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Micro-benchmark of the wakeup latency and CPU cost of parking idle threads with ThreadParker.
+ *
+ * One producer sends timestamped items to consumer_count consumers in turn, at rate items per second.
+ * Each consumer has a one-item slot, and waits for items with the idle loop of ExpertAdapter::WaitIdle:
+ * spin IDLE_SPIN_ROUNDS rounds, then yield, and park after park_after_us of yielding (0: never park).
+ * The producer calls Unpark() after each item, as AbstractMailbox does for local msgs.
+ * Each setting prints the p50 / p99 / p999 latency from send to receive, and the CPU cores used by the process.
+ *
+ * Usage: park_latency_bench [consumer_count = 4] [rate = 5000] [duration_ms = 4000] [park_after_us = 1000]
+ *        The never-park setting is always run for comparison.
+ */
+
+#include <emmintrin.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "tools/bench_util.hpp"
+#include "utils/thread_parker.hpp"
+
+// Same as ExpertAdapter
+static const uint64_t IDLE_SPIN_ROUNDS = 64;
+static const uint64_t PARK_TIMEOUT_US = 10000;
+
+struct alignas(64) Slot {
+    // Send time of the item, 0 if empty
+    std::atomic<uint64_t> send_time{0};
+};
+
+struct RunResult {
+    std::vector<uint64_t> latency_samples;
+    uint64_t dropped = 0;  // items not sent since the slot was still full
+    double cpu_cores = 0;
+};
+
+static RunResult Run(int consumer_count, uint64_t rate, uint64_t duration_ms, uint64_t park_after_us) {
+    ThreadParker parker;
+    parker.Init(consumer_count, consumer_count);
+    std::vector<Slot> slots(consumer_count);
+    std::vector<std::vector<uint64_t>> samples(consumer_count);
+    std::atomic<bool> stop(false);
+
+    uint64_t cpu_start = BenchUtil::GetProcessCpuUsec();
+    uint64_t wall_start = BenchUtil::GetNsec();
+
+    std::vector<std::thread> consumers;
+    for (int tid = 0; tid < consumer_count; tid++) {
+        consumers.emplace_back([&, tid]() {
+            Slot& slot = slots[tid];
+            uint64_t idle_rounds = 0, idle_start = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint64_t send_time = slot.send_time.load(std::memory_order_acquire);
+                if (send_time != 0) {
+                    samples[tid].push_back(BenchUtil::GetNsec() - send_time);
+                    slot.send_time.store(0, std::memory_order_release);
+                    idle_rounds = 0;
+                    continue;
+                }
+
+                if (idle_rounds++ < IDLE_SPIN_ROUNDS) {
+                    _mm_pause();
+                    continue;
+                }
+
+                uint64_t now = BenchUtil::GetNsec() / 1000;
+                if (idle_rounds == IDLE_SPIN_ROUNDS + 1)
+                    idle_start = now;
+
+                if (park_after_us == 0 || now < idle_start + park_after_us
+                        || !parker.Park(tid, PARK_TIMEOUT_US, [&slot] { return slot.send_time.load() != 0; }))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    RunResult result;
+    uint64_t interval_ns = 1000000000ul / rate;
+    uint64_t next_send = BenchUtil::GetNsec();
+    uint64_t end = next_send + duration_ms * 1000000;
+    for (uint64_t i = 0; next_send < end; i++) {
+        next_send += interval_ns;
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(next_send)));
+
+        int tid = i % consumer_count;
+        if (slots[tid].send_time.load(std::memory_order_acquire) != 0) {
+            result.dropped++;
+            continue;
+        }
+        slots[tid].send_time.store(BenchUtil::GetNsec(), std::memory_order_release);
+        parker.Unpark(tid);
+    }
+
+    stop = true;
+    for (int tid = 0; tid < consumer_count; tid++)
+        parker.Unpark(tid);
+    for (auto& consumer : consumers)
+        consumer.join();
+
+    result.cpu_cores = (BenchUtil::GetProcessCpuUsec() - cpu_start) * 1000.0 / (BenchUtil::GetNsec() - wall_start);
+    for (auto& consumer_samples : samples)
+        result.latency_samples.insert(result.latency_samples.end(), consumer_samples.begin(), consumer_samples.end());
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int consumer_count = BenchUtil::GetArg(argc, argv, 1, 4);
+    uint64_t rate = BenchUtil::GetArg(argc, argv, 2, 5000);
+    uint64_t duration_ms = BenchUtil::GetArg(argc, argv, 3, 4000);
+    uint64_t park_after_us = BenchUtil::GetArg(argc, argv, 4, 1000);
+    CHECK(rate > 0);
+
+    std::cout << "consumers: " << consumer_count << ", rate: " << rate << " items/s, duration: " << duration_ms
+              << " ms, hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    for (uint64_t setting : {uint64_t(0), park_after_us}) {
+        RunResult result = Run(consumer_count, rate, duration_ms, setting);
+        uint64_t p50 = BenchUtil::Percentile(result.latency_samples, 0.5);
+        uint64_t p99 = BenchUtil::Percentile(result.latency_samples, 0.99);
+        uint64_t p999 = BenchUtil::Percentile(result.latency_samples, 0.999);
+        if (setting == 0)
+            std::cout << "never park: ";
+        else
+            std::cout << "park after " << setting << " us: ";
+        std::cout << "latency p50 / p99 / p999: " << p50 / 1000.0 << " / " << p99 / 1000.0 << " / " << p999 / 1000.0
+                  << " us, CPU: " << result.cpu_cores << " cores, received: " << result.latency_samples.size()
+                  << ", dropped: " << result.dropped << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Micro-benchmark of RowPrefetcher on a synthetic power-law graph.
+ *
+ * Each vertex owns a row list laid out as VertexEdgeRow (EdgeHeader cells referring to MVCCList<EdgeMVCCItem>).
+ * MVCCLists and their versions are allocated in random edge order, as they are after loading a shuffled graph,
+ * so that each hop of cell -> MVCCList -> version is likely a cache miss.
+ * The reader loop is the one of TopologyRowList::ReadConnectedVertex, run with and without RowPrefetcher.
+ * Edges get a random label in [1, label_count]. With label_count = 1, the reader asks for all labels, i.e., the
+ * unfiltered scan that TopologyRowList prefetches for. With label_count > 1, it asks for label 1, i.e., a label-filtered
+ * scan, for which TopologyRowList skips the prefetcher. The prefetcher is forced on here to check that choice.
+ *
+ * Usage: row_prefetch_bench [vertex_count = 262144] [avg_degree = 16] [query_count = 200000]
+ *                           [label_count = 1] [alpha_x10 = 21]
+ *        The out-degrees follow a Pareto distribution with exponent alpha_x10 / 10.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "layout/layout_type.hpp"
+#include "layout/mvcc_list.hpp"
+#include "layout/row_prefetcher.hpp"
+#include "tools/bench_util.hpp"
+#include "utils/config.hpp"
+#include "utils/tid_pool_manager.hpp"
+
+// Same layout as VertexEdgeRow, whose members are private to the layout
+struct BenchEdgeRow {
+    BenchEdgeRow* next_;
+    EdgeHeader cells_[VE_ROW_CELL_COUNT];
+
+    static constexpr int ROW_CELL_COUNT = VE_ROW_CELL_COUNT;
+} __attribute__((aligned(64)));
+
+struct BenchVertex {
+    BenchEdgeRow* head = nullptr;
+    int edge_count = 0;
+};
+
+typedef MVCCList<EdgeMVCCItem> EdgeMVCCList;
+
+static const uint64_t BENCH_TRX_ID = TRX_ID_MASK | 1;
+static const uint64_t BENCH_BEGIN_TIME = 1;
+
+// Copy of the loop in TopologyRowList::ReadConnectedVertex
+template <bool PREFETCH>
+static void ReadConnectedVertex(const BenchVertex& vtx, const label_t& edge_label, vector<vid_t>& ret) {
+    BenchEdgeRow* current_row = vtx.head;
+    auto need_cell = [&](const EdgeHeader& cell) {
+        return cell.MayMatchLabel(edge_label) && cell.is_out;
+    };
+    RowPrefetcher<BenchEdgeRow, EdgeMVCCList> prefetcher(current_row, vtx.edge_count);
+
+    for (int i = 0; i < vtx.edge_count; i++) {
+        int cell_id_in_row = i % VE_ROW_CELL_COUNT;
+        if (i > 0 && cell_id_in_row == 0) {
+            current_row = current_row->next_;
+        }
+
+        if (PREFETCH)
+            prefetcher.Advance(need_cell);
+        auto& cell_ref = current_row->cells_[cell_id_in_row];
+
+        if (!cell_ref.MayMatchLabel(edge_label) || !cell_ref.is_out)
+            continue;
+
+        EdgeVersion edge_version;
+        pair<bool, bool> is_visible = cell_ref.mvcc_list->GetVisibleVersion(BENCH_TRX_ID, BENCH_BEGIN_TIME, true, edge_version);
+        if (!is_visible.second || !edge_version.Exist())
+            continue;
+
+        if (edge_label == 0 || edge_label == edge_version.label)
+            ret.emplace_back(cell_ref.conn_vtx_id);
+    }
+}
+
+// Return ns per scanned edge
+template <bool PREFETCH>
+static double RunQueries(const vector<BenchVertex>& vertices, const vector<uint32_t>& queries, const label_t& edge_label) {
+    vector<vid_t> ret;
+    uint64_t edge_count = 0, checksum = 0;
+
+    uint64_t start = BenchUtil::GetNsec();
+    for (uint32_t vid : queries) {
+        ret.clear();
+        ReadConnectedVertex<PREFETCH>(vertices[vid], edge_label, ret);
+        edge_count += vertices[vid].edge_count;
+        checksum += ret.size();
+    }
+    uint64_t end = BenchUtil::GetNsec();
+
+    BenchUtil::DoNotOptimize(checksum);
+    return (end - start) * 1.0 / std::max<uint64_t>(edge_count, 1);
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t vertex_count = BenchUtil::GetArg(argc, argv, 1, 1 << 18);
+    uint64_t avg_degree = BenchUtil::GetArg(argc, argv, 2, 16);
+    uint64_t query_count = BenchUtil::GetArg(argc, argv, 3, 200000);
+    int label_count = BenchUtil::GetArg(argc, argv, 4, 1);
+    double alpha = BenchUtil::GetArg(argc, argv, 5, 21) / 10.0;
+    CHECK(alpha > 2) << "alpha should be > 2 for a finite average degree";
+
+    Config* config = Config::GetInstance();
+    config->isolation_level = ISOLATION_LEVEL::SNAPSHOT;
+    config->global_enable_opt_preread = false;
+    TidPoolManager::GetInstance()->Register(TID_TYPE::CONTAINER);
+
+    // Pareto out-degrees with the given average
+    BenchUtil::Random random(2020);
+    double min_degree = avg_degree * (alpha - 2) / (alpha - 1);
+    vector<BenchVertex> vertices(vertex_count);
+    uint64_t edge_count = 0, row_count = 0;
+    for (auto& vtx : vertices) {
+        double degree = min_degree * pow(1 - random.NextDouble(), -1 / (alpha - 1));
+        vtx.edge_count = std::max(1, static_cast<int>(std::min(degree, vertex_count * 1.0)));
+        edge_count += vtx.edge_count;
+        row_count += (vtx.edge_count + VE_ROW_CELL_COUNT - 1) / VE_ROW_CELL_COUNT;
+    }
+
+    auto* mvcc_pool = ConcurrentMemPool<EdgeMVCCItem>::GetInstance(nullptr, edge_count * 2 + (1 << 20), 1, false);
+    EdgeMVCCList::SetGlobalMemoryPool(mvcc_pool);
+
+    // Rows are placed randomly in one array, as rows fetched from ConcurrentMemPool by concurrent loaders
+    vector<BenchEdgeRow> rows(row_count);
+    vector<uint64_t> row_order(row_count);
+    std::iota(row_order.begin(), row_order.end(), 0);
+    std::shuffle(row_order.begin(), row_order.end(), std::mt19937_64(1));
+
+    vector<pair<BenchEdgeRow*, int>> cells;  // <row, cell id in row>
+    cells.reserve(edge_count);
+    uint64_t next_row = 0;
+    for (uint32_t vid = 0; vid < vertex_count; vid++) {
+        BenchVertex& vtx = vertices[vid];
+        BenchEdgeRow* tail = nullptr;
+        for (int i = 0; i < vtx.edge_count; i++) {
+            if (i % VE_ROW_CELL_COUNT == 0) {
+                BenchEdgeRow* row = &rows[row_order[next_row++]];
+                row->next_ = nullptr;
+                if (tail == nullptr)
+                    vtx.head = row;
+                else
+                    tail->next_ = row;
+                tail = row;
+            }
+            cells.emplace_back(tail, i % VE_ROW_CELL_COUNT);
+        }
+    }
+
+    // MVCCLists and versions are allocated in random edge order
+    std::shuffle(cells.begin(), cells.end(), std::mt19937_64(2));
+    for (auto& cell : cells) {
+        label_t label = 1 + random.Next() % label_count;
+        EdgeHeader& header = cell.first->cells_[cell.second];
+        header.is_out = true;
+        header.label = label;
+        header.conn_vtx_id = vid_t(random.Next() % vertex_count);
+        EdgeMVCCList* mvcc_list = new EdgeMVCCList;
+        mvcc_list->AppendInitialVersion()[0] = EdgeVersion(label, nullptr);
+        header.mvcc_list = mvcc_list;
+    }
+    cells.clear();
+    cells.shrink_to_fit();
+
+    vector<uint32_t> queries(query_count);
+    for (auto& vid : queries)
+        vid = random.Next() % vertex_count;
+
+    cout << "vertices: " << vertex_count << ", edges: " << edge_count << ", rows: " << row_count
+         << ", labels: " << label_count << ", queries: " << query_count << endl;
+
+    label_t query_label = (label_count == 1) ? 0 : 1;
+
+    // Warm up, then alternate the two loops to cancel out drifts
+    RunQueries<false>(vertices, queries, query_label);
+    double plain_ns = 0, prefetch_ns = 0;
+    const int ROUNDS = 3;
+    for (int round = 0; round < ROUNDS; round++) {
+        plain_ns += RunQueries<false>(vertices, queries, query_label) / ROUNDS;
+        prefetch_ns += RunQueries<true>(vertices, queries, query_label) / ROUNDS;
+    }
+
+    cout << "no prefetch: " << plain_ns << " ns/edge" << endl;
+    cout << "RowPrefetcher (DISTANCE = " << RowPrefetcher<BenchEdgeRow, EdgeMVCCList>::DISTANCE << "): "
+         << prefetch_ns << " ns/edge" << endl;
+    cout << "speedup: " << plain_ns / prefetch_ns << "x" << endl;
+    return 0;
+}
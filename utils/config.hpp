@@ -67,6 +67,7 @@ class Config{
     int global_num_workers;
     int global_num_threads;
     int num_gc_consumer;
+    int num_gc_producer;  // num of threads to scan the vertex table in GCProducer
     int num_parser_threads;
 
     // Thread id for using one-sided RDMA outside the thread pool of ExpertAdapter
@@ -94,6 +95,8 @@ class Config{
     int global_e_mvcc_pool_size;
     int global_vp_mvcc_pool_size;
     int global_ep_mvcc_pool_size;
+    // the pools above grow on demand, up to mem_pool_max_segment_count times of their sizes
+    int global_mem_pool_max_segment_count;
 
     // enable recording the utilization of memory pool
     bool global_enable_mem_pool_utilization_record;
@@ -109,6 +112,15 @@ class Config{
     // per recv buffer should be able to contain up to N msg
     int global_per_recv_buffer_sz_mb;
 
+    // remote messages to the same thread are coalesced into frames of up to msg_batch_sz_kb,
+    // or sent after waiting for msg_batch_timeout_us; 0 disables the batching
+    int global_msg_batch_sz_kb;
+    int global_msg_batch_timeout_us;
+
+    // an idle expert thread spins and yields for expert_park_after_us, and then parks until woken;
+    // 0 (default) keeps idle threads polling
+    int global_expert_park_after_us;
+
     // transaction table
     int trx_table_sz_mb;
 
@@ -123,6 +135,8 @@ class Config{
     bool global_enable_garbage_collect;
     bool global_enable_opt_preread;
     bool global_enable_opt_validation;
+    bool global_enable_numa_pool;
+    bool global_enable_huge_page;
 
 
     int max_data_size;
@@ -150,6 +164,9 @@ class Config{
     int Prop_Index_GC_RATIO;
     int Prop_Index_GC_Task_THRESHOLD;
     int RCT_GC_Task_THRESHOLD;
+    // GCProducer scans the whole vertex table once every GC_Full_Scan_Period rounds,
+    // and only scans the vertices touched by transactions in other rounds
+    int GC_Full_Scan_Period;
 
     // ================================================================
     // mutable_config
@@ -367,6 +384,10 @@ class Config{
             exit(-1);
         }
 
+        // optional, 1 by default
+        val = iniparser_getint(ini, "SYSTEM:NUM_GC_PRODUCER", val_not_found);
+        num_gc_producer = (val != val_not_found && val > 0) ? val : 1;
+
         val = iniparser_getint(ini, "SYSTEM:NUM_PARSER_THREADS", val_not_found);
         if (val != val_not_found) {
             num_parser_threads = val;
@@ -463,6 +484,10 @@ class Config{
             exit(-1);
         }
 
+        // optional, 8 by default
+        val = iniparser_getint(ini, "SYSTEM:MEM_POOL_MAX_SEGMENT_COUNT", val_not_found);
+        global_mem_pool_max_segment_count = (val != val_not_found && val >= 1) ? val : 8;
+
         val = iniparser_getboolean(ini, "SYSTEM:PREDICT_CONTAINER_USAGE", val_not_found);
         if (val != val_not_found) {
             predict_container_usage = val;
@@ -567,6 +592,30 @@ class Config{
             exit(-1);
         }
 
+        // optional, disabled by default
+        val = iniparser_getboolean(ini, "SYSTEM:ENABLE_NUMA_POOL", val_not_found);
+        global_enable_numa_pool = (val != val_not_found) ? val : false;
+
+        // optional, disabled by default
+        val = iniparser_getboolean(ini, "SYSTEM:ENABLE_HUGE_PAGE", val_not_found);
+        global_enable_huge_page = (val != val_not_found) ? val : false;
+
+        // optional, 32 by default
+        val = iniparser_getint(ini, "SYSTEM:MSG_BATCH_SZ_KB", val_not_found);
+        global_msg_batch_sz_kb = (val != val_not_found && val >= 0) ? val : 32;
+        // a frame should fit into a send buffer with a message of MAX_MSG_SIZE
+        if (global_msg_batch_sz_kb * 2 > global_per_send_buffer_sz_mb * 1024) {
+            global_msg_batch_sz_kb = global_per_send_buffer_sz_mb * 1024 / 2;
+        }
+
+        // optional, 50 by default
+        val = iniparser_getint(ini, "SYSTEM:MSG_BATCH_TIMEOUT_US", val_not_found);
+        global_msg_batch_timeout_us = (val != val_not_found && val >= 0) ? val : 50;
+
+        // optional, 0 by default
+        val = iniparser_getint(ini, "SYSTEM:EXPERT_PARK_AFTER_US", val_not_found);
+        global_expert_park_after_us = (val != val_not_found && val >= 0) ? val : 0;
+
         val = iniparser_getint(ini, "SYSTEM:MAX_MSG_SIZE", val_not_found);
         if (val != val_not_found) {
             max_data_size = val;
@@ -736,6 +785,10 @@ class Config{
             exit(-1);
         }
 
+        // optional, 60 rounds by default
+        val = iniparser_getint(ini, "GC:FULL_SCAN_PERIOD", val_not_found);
+        GC_Full_Scan_Period = (val != val_not_found && val > 0) ? val : 60;
+
         iniparser_freedict(ini);
 
         trx_table_sz = MiB2B(trx_table_sz_mb);  // this should be shared by master and workers,workers need to this to compute trx_num_total_buckets...
@@ -819,6 +872,9 @@ class Config{
         ss << "global_edge_property_kv_sz_gb : " << global_edge_property_kv_sz_gb << endl;
         ss << "global_per_send_buffer_sz_mb : " << global_per_send_buffer_sz_mb << endl;
         ss << "global_per_recv_buffer_sz_mb : " << global_per_recv_buffer_sz_mb << endl;
+        ss << "global_msg_batch_sz_kb : " << global_msg_batch_sz_kb << endl;
+        ss << "global_msg_batch_timeout_us : " << global_msg_batch_timeout_us << endl;
+        ss << "global_expert_park_after_us : " << global_expert_park_after_us << endl;
 
         ss << "global_use_rdma : " << global_use_rdma << endl;
         ss << "global_enable_caching : " << global_enable_caching << endl;
@@ -0,0 +1,135 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+/* Allocation of large, long-lived regions (Buffer, ConcurrentMemPool, MVCCValueStore).
+ *
+ * Map():
+ *   If huge_page is true, try hugetlbfs pages first (1GiB pages for regions >= 1GiB, then 2MiB pages),
+ *   and fall back to normal pages advised as transparent huge pages (madvise(MADV_HUGEPAGE)).
+ *   With reserve_only (MAP_NORESERVE), hugetlbfs is skipped, since faulting a page
+ *   after the hugetlbfs pool runs out raises SIGBUS instead of failing the mmap.
+ *   Mapped memory is zero-filled.
+ *
+ * Release():
+ *   Drop the pages of an unused sub-range of a mapped region, e.g., an empty segment of ConcurrentMemPool.
+ *
+ * ParallelFor() / ParallelTouch():
+ *   First-touch a region with multiple threads, so that page faults (and zeroing) are not serialized at startup.
+ */
+class HugePageUtil {
+ public:
+    static constexpr size_t BASE_PAGE_SIZE = 4096;  // 4KB
+    static constexpr size_t HUGE_PAGE_SIZE = 2ul << 20;  // 2MB
+    static constexpr size_t GIGA_PAGE_SIZE = 1ul << 30;  // 1GB
+
+    // Returns nullptr on failure. len is rounded up to the page size used
+    static void* Map(size_t& len, bool huge_page, bool reserve_only = false) {
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+        if (huge_page && !reserve_only) {
+            if (len >= GIGA_PAGE_SIZE) {
+                size_t giga_len = RoundUp(len, GIGA_PAGE_SIZE);
+                void* ptr = mmap(nullptr, giga_len, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | MAP_HUGE_1GB, -1, 0);
+                if (ptr != MAP_FAILED) {
+                    len = giga_len;
+                    return ptr;
+                }
+            }
+
+            size_t huge_len = RoundUp(len, HUGE_PAGE_SIZE);
+            void* ptr = mmap(nullptr, huge_len, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+            if (ptr != MAP_FAILED) {
+                len = huge_len;
+                return ptr;
+            }
+        }
+
+        len = RoundUp(len, huge_page ? HUGE_PAGE_SIZE : BASE_PAGE_SIZE);
+        void* ptr = mmap(nullptr, len, PROT_READ | PROT_WRITE, flags | (reserve_only ? MAP_NORESERVE : 0), -1, 0);
+        if (ptr == MAP_FAILED)
+            return nullptr;
+
+        // Best effort, THP could be disabled by the system
+        if (huge_page)
+            madvise(ptr, len, MADV_HUGEPAGE);
+        return ptr;
+    }
+
+    static void Unmap(void* ptr, size_t len) {
+        if (ptr != nullptr)
+            munmap(ptr, len);
+    }
+
+    // Return the whole pages in [ptr, ptr + len) to the system. They stay mapped, and are zero-filled when touched again
+    static void Release(void* ptr, size_t len) {
+        size_t begin = RoundUp(reinterpret_cast<size_t>(ptr), BASE_PAGE_SIZE);
+        size_t end = (reinterpret_cast<size_t>(ptr) + len) / BASE_PAGE_SIZE * BASE_PAGE_SIZE;
+        if (begin < end)
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    }
+
+    // Call func(sub_begin, sub_end) on nthreads disjoint sub-ranges of [begin, end).
+    // Runs in the calling thread if there are less than min_count elements
+    template <class Func>
+    static void ParallelFor(size_t begin, size_t end, int nthreads, const Func& func, size_t min_count = 1ul << 22) {
+        size_t count = end - begin;
+        if (nthreads <= 1 || count < min_count) {
+            func(begin, end);
+            return;
+        }
+
+        size_t chunk = (count + nthreads - 1) / nthreads;
+        std::vector<std::thread> threads;
+        for (size_t sub_begin = begin; sub_begin < end; sub_begin += chunk) {
+            size_t sub_end = std::min(end, sub_begin + chunk);
+            threads.emplace_back([&func, sub_begin, sub_end]() { func(sub_begin, sub_end); });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    // Fault in all pages of [ptr, ptr + len) in parallel. The content is not changed
+    static void ParallelTouch(char* ptr, size_t len, int nthreads) {
+        ParallelFor(0, len / BASE_PAGE_SIZE, nthreads, [ptr](size_t page_begin, size_t page_end) {
+            for (size_t i = page_begin; i < page_end; i++) {
+                // mapped memory is zero-filled
+                ptr[i * BASE_PAGE_SIZE] = 0;
+            }
+        }, 1ul << 14);
+    }
+
+ private:
+    static inline size_t RoundUp(size_t len, size_t align) {
+        return (len + align - 1) / align * align;
+    }
+};
@@ -0,0 +1,78 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+/* Minimal NUMA helpers based on sysfs and syscalls, so that libnuma is not required.
+ * If the NUMA topology is unavailable, there is only one node and all functions are no-op.
+ */
+class NumaUtil {
+ public:
+    // Count of nodes in /sys/devices/system/node
+    static int GetNodeCount() {
+        static int node_count = ReadNodeCount();
+        return node_count;
+    }
+
+    // Node of the cpu where the calling thread is running
+    static int GetCurrentNode() {
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+            return 0;
+        return static_cast<int>(node) < GetNodeCount() ? node : 0;
+    }
+
+    // Prefer allocating pages in [addr, addr + len) on node. addr should be page-aligned.
+    static bool PreferNode(void* addr, size_t len, int node) {
+        const int MPOL_PREFERRED_MODE = 1;  // MPOL_PREFERRED in <numaif.h>
+        unsigned long node_mask = 1ul << node;
+        return syscall(SYS_mbind, addr, len, MPOL_PREFERRED_MODE, &node_mask, sizeof(node_mask) * 8 + 1, 0) == 0;
+    }
+
+    // Interleave pages in [addr, addr + len) among all nodes. addr should be page-aligned.
+    static bool InterleaveNodes(void* addr, size_t len) {
+        const int MPOL_INTERLEAVE_MODE = 3;  // MPOL_INTERLEAVE in <numaif.h>
+        int node_count = GetNodeCount();
+        unsigned long node_mask = (node_count == 64) ? ~0ul : (1ul << node_count) - 1;
+        return syscall(SYS_mbind, addr, len, MPOL_INTERLEAVE_MODE, &node_mask, sizeof(node_mask) * 8 + 1, 0) == 0;
+    }
+
+ private:
+    static int ReadNodeCount() {
+        DIR* dir = opendir("/sys/devices/system/node");
+        if (dir == nullptr)
+            return 1;
+
+        int count = 0;
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4]))
+                count++;
+        }
+        closedir(dir);
+
+        // At most 64 nodes are supported by PreferNode
+        if (count < 1)
+            return 1;
+        return count > 64 ? 64 : count;
+    }
+};
@@ -0,0 +1,68 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <emmintrin.h>
+
+#include <atomic>
+#include <cstdint>
+
+/* Sequence counter (seqlock) for readers that only load the protected variables.
+ * Writers must be serialized by another lock, and modify the variables inside a WriteScope.
+ * Readers:
+ *      uint32_t seq;
+ *      do {
+ *          seq = seq_lock.ReadBegin();
+ *          ... take a snapshot ...
+ *      } while (seq_lock.ReadRetry(seq));
+ */
+class SeqLock {
+ public:
+    SeqLock() : seq_(0) {}
+
+    // Wait until no writer is in WriteScope
+    uint32_t ReadBegin() const {
+        while (true) {
+            uint32_t seq = seq_.load(std::memory_order_acquire);
+            if (!(seq & 1))
+                return seq;
+            _mm_pause();
+        }
+    }
+
+    // True if the snapshot taken after ReadBegin() is inconsistent
+    bool ReadRetry(const uint32_t& seq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) != seq;
+    }
+
+    class WriteScope {
+     public:
+        explicit WriteScope(SeqLock& lock) : lock_(lock) {
+            lock_.seq_.store(lock_.seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        ~WriteScope() {
+            lock_.seq_.store(lock_.seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+     private:
+        SeqLock& lock_;
+    };
+
+ private:
+    std::atomic<uint32_t> seq_;
+};
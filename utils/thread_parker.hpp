@@ -0,0 +1,107 @@
+// Copyright 2020 BigGraph Team @ Husky Data Lab, CUHK
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "glog/logging.h"
+
+/* Parks idle threads on a futex until Unpark() or a timeout.
+ * A producer makes the work visible before calling Unpark(id), and the parking thread checks
+ * for work after announcing itself as parked. Both sides put a full fence in between,
+ * so either the producer sees the parked state, or the parking thread sees the work.
+ *
+ * At most max_parked threads are parked at the same time. The work that cannot call Unpark(),
+ * e.g. messages written by remote RDMA, should be watched by a thread that never parks.
+ */
+class ThreadParker {
+ public:
+    ThreadParker() : slots_(nullptr), max_parked_(0), parked_count_(0) {}
+    ~ThreadParker() { delete[] slots_; }
+
+    ThreadParker(const ThreadParker &) = delete;
+    ThreadParker &operator=(const ThreadParker &) = delete;
+
+    void Init(int num_slots, int max_parked) {
+        CHECK(slots_ == nullptr);
+        slots_ = new Slot[num_slots];
+        max_parked_ = max_parked;
+    }
+
+    // Park thread id until unparked or timeout_us passes.
+    // Return false without waiting if has_work() is true or too many threads are parked.
+    template <class HasWorkFunc>
+    bool Park(int id, uint64_t timeout_us, const HasWorkFunc& has_work) {
+        if (parked_count_.fetch_add(1, std::memory_order_relaxed) >= max_parked_) {
+            parked_count_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Slot& slot = slots_[id];
+        slot.state.store(PARKED, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        bool parked = !has_work();
+        if (parked) {
+            struct timespec timeout;
+            timeout.tv_sec = timeout_us / 1000000;
+            timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+            // Returns at once if already unparked, spurious wakeups are harmless
+            syscall(SYS_futex, reinterpret_cast<int*>(&slot.state), FUTEX_WAIT_PRIVATE, PARKED, &timeout, nullptr, 0);
+        }
+
+        slot.state.store(RUNNING, std::memory_order_relaxed);
+        parked_count_.fetch_sub(1, std::memory_order_relaxed);
+        return parked;
+    }
+
+    void Unpark(int id) {
+        Slot& slot = slots_[id];
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (slot.state.load(std::memory_order_relaxed) != PARKED)
+            return;
+
+        int expected = PARKED;
+        if (slot.state.compare_exchange_strong(expected, RUNNING, std::memory_order_release))
+            syscall(SYS_futex, reinterpret_cast<int*>(&slot.state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+    bool IsParked(int id) const {
+        return slots_[id].state.load(std::memory_order_relaxed) == PARKED;
+    }
+
+    int GetParkedCount() const {
+        return parked_count_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    enum State : int { RUNNING = 0, PARKED = 1 };
+
+    struct alignas(64) Slot {
+        std::atomic<int> state{RUNNING};
+    };
+
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex word must be an int");
+
+    Slot* slots_;
+    int max_parked_;
+    std::atomic<int> parked_count_;
+};
@@ -234,33 +234,19 @@ class Tool{
     }
 
     static void double2value_t(double d, value_t & v) {
-        size_t sz = sizeof(double);
-        char f[sz];
-        memcpy(f, (const char*)&d, sz);
-
-        for (int k = 0 ; k < sz; k++)
-            v.content.push_back(f[k]);
+        v.content.append(&d, sizeof(double));
         v.type = 2;
     }
 
     static void int2value_t(int i, value_t & v) {
-        size_t sz = sizeof(int);
-        char f[sz];
-        memcpy(f, (const char*)&i, sz);
-
-        for (int k = 0 ; k < sz; k++)
-            v.content.push_back(f[k]);
+        v.content.append(&i, sizeof(int));
         v.type = 1;
     }
 
     static bool uint64_t2value_t(uint64_t u64, value_t & v) {
-        size_t sz = sizeof(uint64_t);
-        char f[sz];
-        memcpy(f, (const char*)&u64, sz);
-
-        for (int k = 0 ; k < sz; k++)
-            v.content.push_back(f[k]);
+        v.content.append(&u64, sizeof(uint64_t));
         v.type = 5;
+        return true;
     }
 
     static bool vec2value_t(const vector<string>& vec, value_t & v, int type) {